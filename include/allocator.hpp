@@ -0,0 +1,55 @@
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+constexpr size_t k_mem_align = 64;
+constexpr size_t k_huge_page_size = 2UL << 20;
+
+class Allocator {
+public:
+    virtual ~Allocator() = default;
+
+    // Returned memory is aligned to at least k_mem_align bytes
+    virtual uint8_t *allocate(size_t) = 0;
+    // Size is the same value that was passed to allocate()
+    virtual void deallocate(uint8_t *, size_t) = 0;
+};
+
+// Keeps freed buffers in per size class free lists and hands them out
+// again, so per-frame allocation of the same geometry hits the heap once.
+// Buffers of at least `huge_threshold` bytes are huge page aligned and
+// advised for transparent huge pages.
+class PoolAllocator : public Allocator {
+public:
+    explicit PoolAllocator(size_t huge_threshold = k_huge_page_size, size_t max_cached = 256UL << 20);
+    ~PoolAllocator() override;
+
+    PoolAllocator(const PoolAllocator&) = delete;
+    PoolAllocator& operator=(const PoolAllocator&) = delete;
+
+    uint8_t *allocate(size_t) override;
+    void deallocate(uint8_t *, size_t) override;
+    void trim();
+    size_t cached() const;
+
+private:
+    size_t sizeClass(size_t) const;
+    uint8_t *allocateNew(size_t) const;
+
+    size_t huge_threshold_;
+    size_t max_cached_;
+    size_t cached_{0};
+    mutable std::mutex mutex_;
+    std::unordered_map<size_t, std::vector<uint8_t*>> free_;
+};
+
+// Used by Image for every buffer it owns, defaults to a PoolAllocator
+Allocator *getDefaultAllocator();
+void setDefaultAllocator(Allocator *);
+
+NAMESPACE_END
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+// Kernel implementation tiers, a higher tier is preferred when supported
+enum class CpuTier : uint8_t
+{
+    SCALAR,     // 0
+    NEON,
+    SSE41,
+    AVX2,
+    AVX512BW,
+
+    END
+};
+
+const std::string &getCpuTierName(CpuTier);
+CpuTier getCpuTier(const std::string &name);
+
+bool isCpuTierSupported(CpuTier);
+// Best tier of this CPU, probed once
+CpuTier getSupportedCpuTier();
+// Tier the dispatchers bind to, defaults to the best supported one or to
+// the ZYCS_CPU_TIER environment variable (e.g. "scalar", "avx2")
+CpuTier getCpuTier();
+// Caps the tier used by the dispatchers, unsupported tiers fall back to
+// the best supported tier below them
+void setCpuTier(CpuTier);
+
+NAMESPACE_END
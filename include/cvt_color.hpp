@@ -1,13 +1,16 @@
 #pragma once
 
+#include <array>
 #include "types.hpp"
 #include "image.hpp"
+#include "cpu_feature.hpp"
 
 NAMESPACE_BEGIN
 
+// Each converts src into dst with the kernel of the active tier, after
+// the checks of checkCvtColor and that the formats are those of the name
 #define ADD_IMG_CONVERT(F)                  \
-    void F(const Image&, const Image&);     \
-    void F##_c(const Image&, const Image&)
+    void F(const Image&, const Image&)
 
 // from gray
 ADD_IMG_CONVERT(gray_to_gray);
@@ -129,4 +132,142 @@ ADD_IMG_CONVERT(nv21_to_i420);
 ADD_IMG_CONVERT(nv21_to_nv12);
 ADD_IMG_CONVERT(nv21_to_nv21);
 
+using CvtFunction = void(*)(const Image&, const Image&);
+
+// Fixed point accuracy of the yuv <-> rgb kernels. FAST uses 8 bit
+// coefficients and is within a few steps of the exact result, HIGH uses
+// 14 bit coefficients with 16 bit multiply high arithmetic and is within
+// one step. Other conversions are exact either way.
+enum class CvtPrecision : uint8_t
+{
+    FAST,
+    HIGH,
+    END
+};
+
+// Upsampling of subsampled chroma for yuv -> rgb. NEAREST repeats each
+// sample over its pixels, BILINEAR interpolates between the samples
+// around each pixel following Image::chromaSiting of the source, within
+// the same single pass. BILINEAR uses the HIGH arithmetic. NV24 and I444
+// carry a sample per pixel, both filters are the same for them. The high
+// bit depth sources only have NEAREST, BILINEAR from them to rgb throws.
+enum class ChromaFilter : uint8_t
+{
+    NEAREST,
+    BILINEAR,
+    END
+};
+
+// Alpha handling of rgba and bgra. PREMULTIPLY scales the colours of a
+// straight alpha source by alpha, round(c * a / 255), UNPREMULTIPLY
+// divides a premultiplied source by it, min(round(c * 255 / a), 255) with
+// ties to even and 0 where a is 0. Both are a no op for sources without
+// alpha, other formats see the scaled colours. PRESERVE keeps the alpha
+// already in an rgba or bgra dst instead of writing the source alpha or
+// 255. All of them run within the conversion pass.
+enum class AlphaOp : uint8_t
+{
+    NONE,
+    PREMULTIPLY,
+    UNPREMULTIPLY,
+    PRESERVE,
+    END
+};
+
+// Per call options of cvtColor
+struct CvtOption {
+    CvtPrecision m_precision{CvtPrecision::FAST};
+    ChromaFilter m_chroma_filter{ChromaFilter::NEAREST};
+    AlphaOp m_alpha{AlphaOp::NONE};
+};
+
+// Fastest implementation of src -> dst for the active cpu tier. Kernels
+// do not validate their arguments, check the pair with checkCvtColor once
+// before calling a resolved kernel in a loop. An AlphaOp only has kernels
+// between rgba and bgra, other pairs it applies to give nullptr and are
+// left to cvtColor. Pairs the ChromaFilter has no kernel for give nullptr
+CvtFunction getCvtFunc(ImageFormat, ImageFormat, const CvtOption & = CvtOption{});
+// Implementation of exactly the given tier, nullptr if there is none
+CvtFunction getCvtFunc(ImageFormat, ImageFormat, CpuTier, const CvtOption & = CvtOption{});
+
+// Throws std::invalid_argument if src can not be converted into dst
+void checkCvtColor(const Image &src, const Image &dst);
+// Converts src into the format of dst, dst is (re)created with the size of
+// src when they differ. Large frames are split into row bands that run on
+// getDefaultExecutor() (see thread_pool.hpp). YUV <-> RGB conversions use
+// the colorimetry of the YUV image (Image::setColorSpace). src and dst may
+// share their memory for same format conversions, which are then a no op
+// unless an AlphaOp applies, and for the layout swaps rgb <-> bgr, rgba
+// <-> bgra, yuyv <-> uyvy, nv12 <-> nv21 and i420 <-> yv12; dst is
+// relabelled to the new format. Other in place conversions throw.
+void cvtColor(const Image &src, Image &dst);
+void cvtColor(const Image &src, Image &dst, ImageFormat, const CvtOption & = CvtOption{});
+// Same, with the matrix and range applied to both src and dst
+void cvtColor(const Image &src, Image &dst, ImageFormat, ColorMatrix, ColorRange, const CvtOption & = CvtOption{});
+// Converts src[i] into dst[i] as fmt for every i in [0, n), the frames may
+// differ in size. Every pair is checked and its dst created before any is
+// converted, then the frames are cut into row bands that run together on
+// getDefaultExecutor(), so a batch of small frames spreads over the
+// threads like one large frame. dst[i] must not share memory with another
+// frame of the batch
+void cvtColorBatch(const Image *src, Image *dst, size_t n, ImageFormat, const CvtOption & = CvtOption{});
+
+// Deviation of a yuv <-> rgb result dst from a double precision conversion
+// of src, in 8 bit steps over every y, u, v or r, g, b sample. Chroma is
+// compared as the mean of the pixels sharing it, yuv -> rgb upsamples it
+// with the chroma filter of the option. Throws for other pairs
+struct CvtError {
+    double m_max{0};
+    double m_mean{0};
+};
+CvtError measureCvtError(const Image &src, const Image &dst, const CvtOption & = CvtOption{});
+
+// Memory order of a 3 channel tensor with a batch of one: NCHW
+// stores one plane per channel, NHWC interleaves the channels per pixel
+enum class TensorLayout : uint8_t
+{
+    NCHW,
+    NHWC,
+    END
+};
+
+// Element type of a tensor. FLOAT16 and BFLOAT16 round to nearest even,
+// INT8 and UINT8 are quantized with TensorOption::m_quant_scale and
+// m_zero_point
+enum class TensorType : uint8_t
+{
+    FLOAT32,
+    FLOAT16,
+    BFLOAT16,
+    INT8,
+    UINT8,
+    END
+};
+
+// Each 8 bit sample x of output channel c is normalized to
+// v = (x - m_mean[c]) * m_scale[c]. Quantized types store
+// clamp(round(v / m_quant_scale) + m_zero_point), rounding half to even.
+// Channels are r, g, b, or b, g, r with m_bgr. m_cvt applies to sources
+// that are not rgb, BILINEAR chroma is not supported
+struct TensorOption {
+    TensorLayout m_layout{TensorLayout::NCHW};
+    TensorType m_type{TensorType::FLOAT32};
+    bool m_bgr{false};
+    std::array<float, 3> m_mean{0, 0, 0};
+    std::array<float, 3> m_scale{1, 1, 1};
+    float m_quant_scale{1};
+    int32_t m_zero_point{0};
+    CvtOption m_cvt{};
+};
+
+// Bytes of a tensor of 3 * rows * cols elements
+size_t getTensorBytes(int32_t rows, int32_t cols, TensorType);
+
+// Converts src into the tightly packed tensor dst of 3 * rows * cols
+// elements of the option type in a single pass. Rgb sources are
+// normalized directly, others are converted a few rows at a time into a
+// cache sized rgb strip that is normalized right away. Runs on row bands
+// like cvtColor
+void cvtToTensor(const Image &src, void *dst, const TensorOption & = TensorOption{});
+
 NAMESPACE_END
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <memory>
+#include "types.hpp"
+#include "image.hpp"
+
+NAMESPACE_BEGIN
+
+using FrameRef = std::shared_ptr<Image>;
+
+// Fixed set of preallocated frames of one geometry and format. acquire()
+// hands out a reference counted frame without allocating, which goes back
+// to the pool's lock-free free list once the last reference, weak ones
+// included, is dropped. Its format and colour tags are reset on the way
+// back. The frames stay valid even if the pool itself is destroyed first.
+class FramePool {
+public:
+    FramePool(int32_t, int32_t, ImageFormat, size_t, const ImagePitch& = {});
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // Returns nullptr when every frame is in use
+    FrameRef acquire();
+    size_t capacity() const;
+    size_t available() const;
+
+private:
+    struct State;
+    std::shared_ptr<State> state_;
+};
+
+NAMESPACE_END
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "types.hpp"
+#include "allocator.hpp"
+#include <array>
 #include <string>
 
 NAMESPACE_BEGIN
@@ -17,19 +19,76 @@ enum class ImageFormat : uint8_t
     I420,
     NV12,
     NV21,
+    // 16 bit little endian samples. P010 and P016 are laid out like NV12,
+    // I010 like I420 and Y210 like YUYV. P010 and Y210 keep their 10 bits
+    // in the msbs, I010 in the lsbs. RGB48 is RGB with 16 bit channels
+    P010,       // 10
+    P016,
+    I010,
+    Y210,
+    RGB48,
+    // 8 bit YUV: NV16 and NV24 are 4:2:2 and 4:4:4 laid out like NV12,
+    // I422 and I444 like I420, YV12 is I420 with the V plane first
+    NV16,       // 15
+    NV24,
+    I422,
+    I444,
+    YV12,
 
     END
 };
 
+// YUV <-> RGB matrix of a YUV image
+enum class ColorMatrix : uint8_t
+{
+    BT601,      // 0
+    BT709,
+    BT2020,
+
+    END
+};
+
+// Full range uses 0-255 for Y and U/V, limited (video) range 16-235 for Y
+// and 16-240 for U/V
+enum class ColorRange : uint8_t
+{
+    FULL,       // 0
+    LIMITED,
+
+    END
+};
+
+// Position of subsampled chroma relative to luma. LEFT (MPEG-2, H.264) is
+// co-sited with the even columns, CENTER (MPEG-1, JPEG) lies between two
+// columns. 4:2:0 chroma lies between its two rows either way
+enum class ChromaSiting : uint8_t
+{
+    LEFT,       // 0
+    CENTER,
+
+    END
+};
+
+constexpr size_t k_max_planes = 3;
+// Row pitch in bytes of each plane, 0 means tightly packed. Planes of the
+// 16 bit formats need even pitches and addresses
+using ImagePitch = std::array<size_t, k_max_planes>;
+// Start of each plane, planes need not share one allocation
+using ImagePlanes = std::array<uint8_t*, k_max_planes>;
+
 size_t getImgStride(int32_t, ImageFormat);
 size_t getImgSize(int32_t, int32_t, ImageFormat);
+size_t getImgPlanes(ImageFormat);
+size_t getPlaneStride(int32_t, ImageFormat, size_t);
+int32_t getPlaneRows(int32_t, ImageFormat, size_t);
 const std::string &getImgFmtName(ImageFormat);
 ImageFormat getImgFmt(const std::string &name);
 
 class Image {
 public:
     Image() = default;
-    Image(int32_t, int32_t, ImageFormat, uint8_t* = nullptr);
+    Image(int32_t, int32_t, ImageFormat, uint8_t* = nullptr, const ImagePitch& = {});
+    Image(int32_t, int32_t, ImageFormat, const ImagePlanes&, const ImagePitch& = {});
 
     Image(const Image&) = delete;
     Image(Image&&) noexcept;
@@ -38,21 +97,41 @@ public:
 
     ~Image();
 
-    void create(int32_t, int32_t, ImageFormat, uint8_t* = nullptr);
+    void create(int32_t, int32_t, ImageFormat, uint8_t* = nullptr, const ImagePitch& = {});
+    void create(int32_t, int32_t, ImageFormat, const ImagePlanes&, const ImagePitch& = {});
     Image clone() const;
+    Image roi(int32_t, int32_t, int32_t, int32_t) const;
     int32_t rows() const;
     int32_t cols() const;
-    uint8_t *data() const;
+    uint8_t *data(size_t = 0) const;
+    uint8_t *ptr(int32_t, size_t = 0) const;
     size_t pixels() const;
     size_t size() const;
-    size_t stride() const;
+    size_t stride(size_t = 0) const;
+    size_t planes() const;
+    bool isContinuous() const;
     ImageFormat fmt() const;
+    // Relabels the data as a format with the same planes, e.g. rgb <-> bgr
+    // or nv12 <-> nv21, throws std::invalid_argument for other formats
+    void setFmt(ImageFormat);
+    // Colorimetry used when this image is converted from or to RGB,
+    // BT.601 full range by default; reset by create()
+    ColorMatrix colorMatrix() const;
+    ColorRange colorRange() const;
+    void setColorSpace(ColorMatrix, ColorRange);
+    // Used when chroma is interpolated, LEFT by default; reset by create()
+    ChromaSiting chromaSiting() const;
+    void setChromaSiting(ChromaSiting);
 
 private:
+    void release();
+
     int32_t width_{0};
     int32_t height_{0};
-    uint64_t flag_{0};     // own_ptr | img_fmt | size
-    uint8_t* data_{nullptr};
+    uint64_t flag_{0};     // own_ptr | img_fmt | color_range | color_matrix | chroma_siting | size
+    ImagePlanes planes_{};
+    Allocator *allocator_{nullptr};     // owner of planes_[0] when own_ptr is set
+    ImagePitch pitch_{};
 };
 
 NAMESPACE_END
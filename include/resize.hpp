@@ -9,6 +9,11 @@ enum class ResizeType : uint8_t {
     NEAREST = 0,
     BILINEAR = 1,
     CUBIC = 2,
+    AREA = 3,    // box average, for downscaling without aliasing
+    LANCZOS = 4,    // Lanczos-3
+    MITCHELL = 5,   // Mitchell-Netravali, B = C = 1 / 3
+    CATMULL_ROM = 6,
+    END
 };
 
 struct ResizeParam {
@@ -17,5 +22,16 @@ struct ResizeParam {
     ResizeType m_resize_type{ResizeType::BILINEAR};
 };
 
+// Resizes src into dst, which keeps its size and must have the format of
+// src. NEAREST handles every format, planes are sampled on their own grid
+// and packed 4:2:2 takes the chroma of the nearest source pair. BILINEAR
+// handles GRAY at any ratio, and RGB and BGR on aarch64. CUBIC, LANCZOS,
+// MITCHELL, CATMULL_ROM and AREA handle GRAY and the 3 and 4 channel rgb
+// formats, alpha is filtered like the colors. CUBIC keeps 4 taps, the
+// other filters widen with the downscale factor so they do not alias. The
+// box of each AREA dst pixel always spans its whole source area, so
+// m_half_pixel and m_align_corner do not apply to it. Throws
+// std::invalid_argument for empty images, mismatched formats and resize
+// types not implemented for the format
 void resize(const Image&, const Image &, ResizeParam);
 NAMESPACE_END
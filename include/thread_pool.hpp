@@ -0,0 +1,60 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+class Executor {
+public:
+    virtual ~Executor() = default;
+
+    // Calls task(i) for every i in [0, n) and returns once all of them are
+    // done, tasks may run concurrently and must not throw
+    virtual void run(size_t n, const std::function<void(size_t)> &task) = 0;
+    // Number of tasks worth running at once
+    virtual size_t concurrency() const = 0;
+};
+
+// Fixed set of worker threads, the calling thread of run() takes tasks as
+// well, so concurrent and nested calls always make progress
+class ThreadPool : public Executor {
+public:
+    // 0 means one thread per hardware thread
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool() override;
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    void run(size_t n, const std::function<void(size_t)> &task) override;
+    size_t concurrency() const override;
+
+private:
+    void work();
+
+    bool stop_{false};
+    std::mutex mutex_;
+    std::condition_variable cond_;
+    std::deque<std::function<void()>> queue_;
+    std::vector<std::thread> workers_;
+};
+
+// Used by cvtColor to split large frames into row bands, defaults to a
+// ThreadPool sized by setNumThreads
+Executor *getDefaultExecutor();
+// nullptr restores the internal pool
+void setDefaultExecutor(Executor *);
+// Threads of the internal pool, 1 runs every conversion on the calling
+// thread, 0 (default) uses one per hardware thread. Takes effect on the
+// next conversion, those running keep their pool. Pools of earlier
+// counts stay around idle for reuse
+void setNumThreads(size_t);
+size_t getNumThreads();
+
+NAMESPACE_END
@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "allocator.hpp"
+
+#include "types.hpp"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+NAMESPACE_BEGIN
+
+constexpr size_t k_page_size = 4096;
+// Size classes of huge buffers. Their base is huge page aligned, a finer
+// size keeps a 3 MB frame from taking 4 MB of the cache
+constexpr size_t k_huge_granule = 64UL << 10;
+
+static size_t alignUp(size_t size, size_t align) {
+    return (size + align - 1) & ~(align - 1);
+}
+
+PoolAllocator::PoolAllocator(size_t huge_threshold, size_t max_cached)
+    : huge_threshold_{huge_threshold}
+    , max_cached_{max_cached}
+{}
+
+PoolAllocator::~PoolAllocator() {
+    trim();
+}
+
+size_t PoolAllocator::sizeClass(size_t size) const {
+    if (size >= huge_threshold_) {
+        return alignUp(size, k_huge_granule);
+    }
+    if (size >= k_page_size) {
+        return alignUp(size, k_page_size);
+    }
+    return alignUp(std::max(size, k_mem_align), k_mem_align);
+}
+
+uint8_t *PoolAllocator::allocateNew(size_t size) const {
+    auto huge = size >= huge_threshold_;
+    uint8_t *buf = nullptr;
+    if (huge) {
+        // Huge classes are not a multiple of the huge page, which
+        // aligned_alloc requires of the size
+        void *ptr = nullptr;
+        if (0 == posix_memalign(&ptr, k_huge_page_size, size)) {
+            buf = static_cast<uint8_t*>(ptr);
+        }
+    } else {
+        auto align = size >= k_page_size ? k_page_size : k_mem_align;
+        buf = static_cast<uint8_t*>(std::aligned_alloc(align, size));
+    }
+    if (nullptr == buf) {
+        throw std::bad_alloc();
+    }
+#ifdef MADV_HUGEPAGE
+    if (huge) {
+        madvise(buf, size, MADV_HUGEPAGE);
+    }
+#endif
+    return buf;
+}
+
+uint8_t *PoolAllocator::allocate(size_t size) {
+    auto cls = sizeClass(size);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = free_.find(cls);
+        if (it != free_.end() && !it->second.empty()) {
+            auto *buf = it->second.back();
+            it->second.pop_back();
+            cached_ -= cls;
+            return buf;
+        }
+    }
+    return allocateNew(cls);
+}
+
+void PoolAllocator::deallocate(uint8_t *buf, size_t size) {
+    if (nullptr == buf) {
+        return;
+    }
+    auto cls = sizeClass(size);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (cached_ + cls <= max_cached_) {
+            free_[cls].push_back(buf);
+            cached_ += cls;
+            return;
+        }
+    }
+    std::free(buf);
+}
+
+void PoolAllocator::trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto &[cls, bufs] : free_) {
+        for (auto *buf : bufs) {
+            std::free(buf);
+        }
+    }
+    free_.clear();
+    cached_ = 0;
+}
+
+size_t PoolAllocator::cached() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cached_;
+}
+
+static std::atomic<Allocator*> g_allocator{nullptr};
+
+Allocator *getDefaultAllocator() {
+    static PoolAllocator pool;
+    auto *allocator = g_allocator.load(std::memory_order_acquire);
+    return nullptr == allocator ? &pool : allocator;
+}
+
+void setDefaultAllocator(Allocator *allocator) {
+    g_allocator.store(allocator, std::memory_order_release);
+}
+
+NAMESPACE_END
@@ -0,0 +1,104 @@
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include "cpu_feature.hpp"
+
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+static const std::array<std::string, getValueOf(CpuTier::END) + 1> g_tier_name{
+    "scalar", "neon", "sse4.1", "avx2", "avx512bw",
+    "end"
+};
+
+const std::string &getCpuTierName(CpuTier tier) {
+    if (tier >= CpuTier::SCALAR && tier <= CpuTier::END) {
+        return g_tier_name[getValueOf(tier)];
+    }
+    return g_tier_name[getValueOf(CpuTier::END)];
+}
+
+CpuTier getCpuTier(const std::string &name) {
+    for (auto i = 0; i < getValueOf(CpuTier::END); ++i) {
+        if (name == g_tier_name[i]) {
+            return static_cast<CpuTier>(i);
+        }
+    }
+
+    return CpuTier::END;
+}
+
+static bool probeCpuTier(CpuTier tier) {
+    switch (tier) {
+        case CpuTier::SCALAR:
+            return true;
+#if defined(__aarch64__)
+        case CpuTier::NEON:
+            return true;
+#elif defined(__x86_64__) || defined(__i386__)
+        case CpuTier::SSE41:
+            return 0 != __builtin_cpu_supports("sse4.1");
+        case CpuTier::AVX2:
+            // Every avx2 cpu has f16c, the tensor kernels rely on it
+            return 0 != __builtin_cpu_supports("avx2") && 0 != __builtin_cpu_supports("f16c");
+        case CpuTier::AVX512BW:
+            return 0 != __builtin_cpu_supports("avx512bw");
+#endif
+        default:
+            return false;
+    }
+}
+
+static const std::array<bool, getValueOf(CpuTier::END)> &getTierSupport() {
+    static const auto support = [] {
+        std::array<bool, getValueOf(CpuTier::END)> tmp{};
+        for (size_t i = 0; i < tmp.size(); ++i) {
+            tmp[i] = probeCpuTier(static_cast<CpuTier>(i));
+        }
+        return tmp;
+    }();
+    return support;
+}
+
+bool isCpuTierSupported(CpuTier tier) {
+    return tier < CpuTier::END && getTierSupport()[getValueOf(tier)];
+}
+
+static CpuTier clampCpuTier(CpuTier tier) {
+    auto i = getValueOf(std::min(tier, static_cast<CpuTier>(getValueOf(CpuTier::END) - 1)));
+    while (i > 0 && !getTierSupport()[i]) {
+        --i;
+    }
+    return static_cast<CpuTier>(i);
+}
+
+CpuTier getSupportedCpuTier() {
+    static const auto tier = clampCpuTier(CpuTier::END);
+    return tier;
+}
+
+static std::atomic<CpuTier> &activeTier() {
+    static std::atomic<CpuTier> tier{[] {
+        const char *env = std::getenv("ZYCS_CPU_TIER");
+        if (nullptr != env) {
+            auto forced = getCpuTier(env);
+            if (CpuTier::END != forced) {
+                return clampCpuTier(forced);
+            }
+        }
+        return getSupportedCpuTier();
+    }()};
+    return tier;
+}
+
+CpuTier getCpuTier() {
+    return activeTier().load(std::memory_order_relaxed);
+}
+
+void setCpuTier(CpuTier tier) {
+    activeTier().store(clampCpuTier(tier), std::memory_order_relaxed);
+}
+
+NAMESPACE_END
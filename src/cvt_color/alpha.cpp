@@ -0,0 +1,36 @@
+#include "alpha.hpp"
+#include "image.hpp"
+
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+template <ImageFormat S, ImageFormat D, AlphaOp A>
+static void alphaC(const Image &src, const Image &dst) {
+    for (int32_t i = 0; i < src.rows(); ++i) {
+        alphaRow<S, D, A>(src.ptr(i), dst.ptr(i), 0, src.cols());
+    }
+}
+
+#define CVT_ALPHA_C(S, D, SF, DF)                                                   \
+    void S##_to_##D##_premultiply_c(const Image &src, const Image &dst)             \
+    {                                                                               \
+        alphaC<ImageFormat::SF, ImageFormat::DF, AlphaOp::PREMULTIPLY>(src, dst);   \
+    }                                                                               \
+    void S##_to_##D##_unpremultiply_c(const Image &src, const Image &dst)           \
+    {                                                                               \
+        alphaC<ImageFormat::SF, ImageFormat::DF, AlphaOp::UNPREMULTIPLY>(src, dst); \
+    }                                                                               \
+    void S##_to_##D##_preserve_c(const Image &src, const Image &dst)                \
+    {                                                                               \
+        alphaC<ImageFormat::SF, ImageFormat::DF, AlphaOp::PRESERVE>(src, dst);      \
+    }
+
+CVT_ALPHA_C(rgba, rgba, RGBA, RGBA)
+CVT_ALPHA_C(rgba, bgra, RGBA, BGRA)
+CVT_ALPHA_C(bgra, rgba, BGRA, RGBA)
+CVT_ALPHA_C(bgra, bgra, BGRA, BGRA)
+
+#undef CVT_ALPHA_C
+
+NAMESPACE_END
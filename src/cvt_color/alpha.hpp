@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include "cvt_color.hpp"
+#include "image.hpp"
+#include "pixel.hpp"
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+// Kernels between rgba and bgra applying an AlphaOp on the way. The _c
+// kernels are bit exact to the SIMD ones
+
+// round(c * a / 255), exact for 8 bit c and a
+constexpr int32_t premultiply(int32_t c, int32_t a) {
+    auto t = c * a + 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+// Float division is correctly rounded, so SIMD gets the same quotient
+inline int32_t unpremultiply(int32_t c, int32_t a) {
+    if (0 == a) {
+        return 0;
+    }
+    return std::min(static_cast<int32_t>(std::nearbyint(static_cast<float>(c * 255) / static_cast<float>(a))), 255);
+}
+
+// Converts pixels [j, w) of a row. PRESERVE takes the alpha of dst
+template <ImageFormat S, ImageFormat D, AlphaOp A>
+inline void alphaRow(const uint8_t *src, uint8_t *dst, int32_t j, int32_t w) {
+    for (; j < w; ++j) {
+        int32_t r, g, b;
+        loadRgbPixel<S>(src + (j * 4), r, g, b);
+        auto a = src[j * 4 + 3];
+        if constexpr (AlphaOp::PREMULTIPLY == A) {
+            r = premultiply(r, a);
+            g = premultiply(g, a);
+            b = premultiply(b, a);
+        } else if constexpr (AlphaOp::UNPREMULTIPLY == A) {
+            r = unpremultiply(r, a);
+            g = unpremultiply(g, a);
+            b = unpremultiply(b, a);
+        } else {
+            a = dst[j * 4 + 3];
+        }
+        dst[j * 4 + 0] = static_cast<uint8_t>(isBgr<D>() ? b : r);
+        dst[j * 4 + 1] = static_cast<uint8_t>(g);
+        dst[j * 4 + 2] = static_cast<uint8_t>(isBgr<D>() ? r : b);
+        dst[j * 4 + 3] = a;
+    }
+}
+
+#define ADD_IMG_CONVERT_ALPHA(F)                \
+    void F##_c(const Image&, const Image&);     \
+    void F##_neon(const Image&, const Image&);  \
+    void F##_avx2(const Image&, const Image&)
+
+#define ADD_IMG_CONVERT_ALPHA_OPS(F)            \
+    ADD_IMG_CONVERT_ALPHA(F##_premultiply);     \
+    ADD_IMG_CONVERT_ALPHA(F##_unpremultiply);   \
+    ADD_IMG_CONVERT_ALPHA(F##_preserve)
+
+ADD_IMG_CONVERT_ALPHA_OPS(rgba_to_rgba);
+ADD_IMG_CONVERT_ALPHA_OPS(rgba_to_bgra);
+ADD_IMG_CONVERT_ALPHA_OPS(bgra_to_rgba);
+ADD_IMG_CONVERT_ALPHA_OPS(bgra_to_bgra);
+
+#undef ADD_IMG_CONVERT_ALPHA_OPS
+#undef ADD_IMG_CONVERT_ALPHA
+
+NAMESPACE_END
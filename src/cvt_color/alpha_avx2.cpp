@@ -0,0 +1,103 @@
+#include "alpha.hpp"
+#include "image.hpp"
+#include "types.hpp"
+#include "x86.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+NAMESPACE_BEGIN
+
+constexpr int32_t k_pixel_per_loop = 8;
+
+// premultiply of the 4 words of each pixel by the pixel's alpha word
+AVX2_FUNC static inline __m256i premultiplyWords(__m256i val, __m256i alpha) {
+    auto t = _mm256_add_epi16(_mm256_mullo_epi16(val, alpha), _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+// unpremultiply of 8 bytes, two pixels, and of their alpha bytes
+AVX2_FUNC static inline __m256i unpremultiply8(__m128i val, __m128i alpha) {
+    auto c = _mm256_cvtepi32_ps(_mm256_mullo_epi32(_mm256_cvtepu8_epi32(val), _mm256_set1_epi32(255)));
+    auto a = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(alpha));
+    // 0 / 0 and c / 0 convert to INT_MIN, which saturates to 0 below
+    return _mm256_min_epi32(_mm256_cvtps_epi32(_mm256_div_ps(c, a)), _mm256_set1_epi32(255));
+}
+
+template <ImageFormat S, ImageFormat D, AlphaOp A>
+AVX2_FUNC static void alphaAvx2(const Image &src, const Image &dst) {
+    auto w = src.cols();
+    const __m256i swap = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                          2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+    const __m256i alpha_mask = _mm256_set1_epi32(static_cast<int32_t>(0xff000000));
+    for (int32_t i = 0; i < src.rows(); ++i) {
+        auto src_buf = src.ptr(i);
+        auto dst_buf = dst.ptr(i);
+        int32_t j = 0;
+        for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+            auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src_buf + (j * 4)));
+            if constexpr (S != D) {
+                x = _mm256_shuffle_epi8(x, swap);
+            }
+            __m256i y;
+            if constexpr (AlphaOp::PREMULTIPLY == A) {
+                const __m256i dup_lo = _mm256_setr_epi8(3, -1, 3, -1, 3, -1, 3, -1, 7, -1, 7, -1, 7, -1, 7, -1,
+                                                        3, -1, 3, -1, 3, -1, 3, -1, 7, -1, 7, -1, 7, -1, 7, -1);
+                const __m256i dup_hi = _mm256_setr_epi8(11, -1, 11, -1, 11, -1, 11, -1, 15, -1, 15, -1, 15, -1, 15, -1,
+                                                        11, -1, 11, -1, 11, -1, 11, -1, 15, -1, 15, -1, 15, -1, 15, -1);
+                auto zero = _mm256_setzero_si256();
+                auto lo = premultiplyWords(_mm256_unpacklo_epi8(x, zero), _mm256_shuffle_epi8(x, dup_lo));
+                auto hi = premultiplyWords(_mm256_unpackhi_epi8(x, zero), _mm256_shuffle_epi8(x, dup_hi));
+                y = _mm256_blendv_epi8(_mm256_packus_epi16(lo, hi), x, alpha_mask);
+            } else if constexpr (AlphaOp::UNPREMULTIPLY == A) {
+                const __m256i dup = _mm256_setr_epi8(3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15,
+                                                     3, 3, 3, 3, 7, 7, 7, 7, 11, 11, 11, 11, 15, 15, 15, 15);
+                auto a = _mm256_shuffle_epi8(x, dup);
+                auto x0 = _mm256_castsi256_si128(x);
+                auto x1 = _mm256_extracti128_si256(x, 1);
+                auto a0 = _mm256_castsi256_si128(a);
+                auto a1 = _mm256_extracti128_si256(a, 1);
+                // Pixels 0 1 | 2 3 | 4 5 | 6 7, packed per lane to
+                // 0 2 4 6 | 1 3 5 7 and put back in order
+                auto p01 = unpremultiply8(x0, a0);
+                auto p23 = unpremultiply8(_mm_srli_si128(x0, 8), _mm_srli_si128(a0, 8));
+                auto p45 = unpremultiply8(x1, a1);
+                auto p67 = unpremultiply8(_mm_srli_si128(x1, 8), _mm_srli_si128(a1, 8));
+                y = _mm256_packus_epi16(_mm256_packs_epi32(p01, p23), _mm256_packs_epi32(p45, p67));
+                y = _mm256_permutevar8x32_epi32(y, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+                y = _mm256_blendv_epi8(y, x, alpha_mask);
+            } else {
+                auto d = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(dst_buf + (j * 4)));
+                y = _mm256_blendv_epi8(x, d, alpha_mask);
+            }
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst_buf + (j * 4)), y);
+        }
+        alphaRow<S, D, A>(src_buf, dst_buf, j, w);
+    }
+}
+
+#define CVT_ALPHA_AVX2(S, D, SF, DF)                                                    \
+    void S##_to_##D##_premultiply_avx2(const Image &src, const Image &dst)              \
+    {                                                                                   \
+        alphaAvx2<ImageFormat::SF, ImageFormat::DF, AlphaOp::PREMULTIPLY>(src, dst);    \
+    }                                                                                   \
+    void S##_to_##D##_unpremultiply_avx2(const Image &src, const Image &dst)            \
+    {                                                                                   \
+        alphaAvx2<ImageFormat::SF, ImageFormat::DF, AlphaOp::UNPREMULTIPLY>(src, dst);  \
+    }                                                                                   \
+    void S##_to_##D##_preserve_avx2(const Image &src, const Image &dst)                 \
+    {                                                                                   \
+        alphaAvx2<ImageFormat::SF, ImageFormat::DF, AlphaOp::PRESERVE>(src, dst);       \
+    }
+
+CVT_ALPHA_AVX2(rgba, rgba, RGBA, RGBA)
+CVT_ALPHA_AVX2(rgba, bgra, RGBA, BGRA)
+CVT_ALPHA_AVX2(bgra, rgba, BGRA, RGBA)
+CVT_ALPHA_AVX2(bgra, bgra, BGRA, BGRA)
+
+#undef CVT_ALPHA_AVX2
+
+NAMESPACE_END
+
+#endif
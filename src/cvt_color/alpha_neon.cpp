@@ -0,0 +1,94 @@
+#include <utility>
+#include "alpha.hpp"
+#include "image.hpp"
+#include "types.hpp"
+
+#ifdef __aarch64__
+
+#include <arm_neon.h>
+
+NAMESPACE_BEGIN
+
+constexpr int32_t k_pixel_per_loop = 16;
+
+// premultiply of 8 bytes, (t + ((t + 128) >> 8) + 128) >> 8 with t = c * a
+static inline uint8x8_t premultiply8(uint8x8_t c, uint8x8_t a) {
+    auto t = vmull_u8(c, a);
+    return vraddhn_u16(t, vrshrq_n_u16(t, 8));
+}
+
+static inline uint8x16_t premultiply16(uint8x16_t c, uint8x16_t a) {
+    return vcombine_u8(premultiply8(vget_low_u8(c), vget_low_u8(a)), premultiply8(vget_high_u8(c), vget_high_u8(a)));
+}
+
+// c * 255 / a of 4 words rounded to nearest even, a of 0 is masked later
+static inline uint32x4_t unpremultiply4(uint16x4_t c, uint16x4_t a) {
+    auto num = vcvtq_f32_u32(vmull_n_u16(c, 255));
+    return vcvtnq_u32_f32(vdivq_f32(num, vcvtq_f32_u32(vmovl_u16(a))));
+}
+
+static inline uint8x16_t unpremultiply16(uint8x16_t c, uint8x16_t a) {
+    uint16x8_t val[2];
+    for (int32_t k = 0; k < 2; ++k) {
+        auto c16 = vmovl_u8(0 == k ? vget_low_u8(c) : vget_high_u8(c));
+        auto a16 = vmovl_u8(0 == k ? vget_low_u8(a) : vget_high_u8(a));
+        val[k] = vcombine_u16(vqmovn_u32(unpremultiply4(vget_low_u16(c16), vget_low_u16(a16))),
+                              vqmovn_u32(unpremultiply4(vget_high_u16(c16), vget_high_u16(a16))));
+    }
+    // The saturating narrow is the min with 255, pixels without alpha are 0
+    return vandq_u8(vcombine_u8(vqmovn_u16(val[0]), vqmovn_u16(val[1])), vtstq_u8(a, a));
+}
+
+template <ImageFormat S, ImageFormat D, AlphaOp A>
+static void alphaNeon(const Image &src, const Image &dst) {
+    auto w = src.cols();
+    for (int32_t i = 0; i < src.rows(); ++i) {
+        auto src_buf = src.ptr(i);
+        auto dst_buf = dst.ptr(i);
+        int32_t j = 0;
+        for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+            auto x = vld4q_u8(src_buf + (j * 4));
+            if constexpr (S != D) {
+                std::swap(x.val[0], x.val[2]);
+            }
+            if constexpr (AlphaOp::PREMULTIPLY == A) {
+                for (int32_t c = 0; c < 3; ++c) {
+                    x.val[c] = premultiply16(x.val[c], x.val[3]);
+                }
+            } else if constexpr (AlphaOp::UNPREMULTIPLY == A) {
+                for (int32_t c = 0; c < 3; ++c) {
+                    x.val[c] = unpremultiply16(x.val[c], x.val[3]);
+                }
+            } else {
+                x.val[3] = vld4q_u8(dst_buf + (j * 4)).val[3];
+            }
+            vst4q_u8(dst_buf + (j * 4), x);
+        }
+        alphaRow<S, D, A>(src_buf, dst_buf, j, w);
+    }
+}
+
+#define CVT_ALPHA_NEON(S, D, SF, DF)                                                    \
+    void S##_to_##D##_premultiply_neon(const Image &src, const Image &dst)              \
+    {                                                                                   \
+        alphaNeon<ImageFormat::SF, ImageFormat::DF, AlphaOp::PREMULTIPLY>(src, dst);    \
+    }                                                                                   \
+    void S##_to_##D##_unpremultiply_neon(const Image &src, const Image &dst)            \
+    {                                                                                   \
+        alphaNeon<ImageFormat::SF, ImageFormat::DF, AlphaOp::UNPREMULTIPLY>(src, dst);  \
+    }                                                                                   \
+    void S##_to_##D##_preserve_neon(const Image &src, const Image &dst)                 \
+    {                                                                                   \
+        alphaNeon<ImageFormat::SF, ImageFormat::DF, AlphaOp::PRESERVE>(src, dst);       \
+    }
+
+CVT_ALPHA_NEON(rgba, rgba, RGBA, RGBA)
+CVT_ALPHA_NEON(rgba, bgra, RGBA, BGRA)
+CVT_ALPHA_NEON(bgra, rgba, BGRA, RGBA)
+CVT_ALPHA_NEON(bgra, bgra, BGRA, BGRA)
+
+#undef CVT_ALPHA_NEON
+
+NAMESPACE_END
+
+#endif
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <algorithm>
+#include "image.hpp"
+#include "thread_pool.hpp"
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+// Kernels walk a band of rows as if they were tightly packed, so a frame
+// whose planes carry no row padding is done in a single call, otherwise
+// it is fed `step` rows at a time (2 for 4:2:0 so chroma rows pair up).
+template <typename F>
+inline void forEachBand(const Image &src, const Image &dst, int32_t step, F &&func)
+{
+    auto h = src.rows();
+    if (src.isContinuous() && dst.isContinuous()) {
+        func(0, h);
+        return;
+    }
+
+    for (int32_t i = 0; i < h; i += step) {
+        func(i, std::min(step, h - i));
+    }
+}
+
+// Frames are split into bands of at least this many pixels, one per thread
+constexpr size_t k_band_pixels = 1UL << 16;
+
+// Passes that go through an intermediate image keep it around this size
+// so it stays in cache between the two kernels
+constexpr size_t k_strip_bytes = 1UL << 15;
+
+// Calls func(band, row, rows) for the row bands of src, on
+// getDefaultExecutor() when there is more than one. init(bands) runs
+// first on the calling thread, bands must not throw so their scratch is
+// allocated there
+template <typename I, typename F>
+inline void forEachRowBand(const Image &src, I &&init, F &&func) {
+    auto h = src.rows();
+    auto bands = std::min(src.pixels() / k_band_pixels, static_cast<size_t>(h / 2));
+    if (bands <= 1) {
+        init(size_t{1});
+        func(size_t{0}, 0, h);
+        return;
+    }
+
+    auto *executor = getDefaultExecutor();
+    bands = std::min(bands, executor->concurrency());
+    if (bands <= 1) {
+        init(size_t{1});
+        func(size_t{0}, 0, h);
+        return;
+    }
+
+    // Bands start on even rows so 4:2:0 chroma rows are never shared
+    auto rows = static_cast<int32_t>((h + bands - 1) / bands + 1) & ~1;
+    bands = (h + rows - 1) / rows;
+    init(bands);
+    executor->run(bands, [&](size_t i) {
+        auto row = static_cast<int32_t>(i) * rows;
+        func(i, row, std::min(rows, h - row));
+    });
+}
+
+// Calls func(row, rows) for the row bands of src
+template <typename F>
+inline void forEachRowBand(const Image &src, F &&func) {
+    forEachRowBand(src, [](size_t) {}, [&](size_t, int32_t row, int32_t rows) { func(row, rows); });
+}
+
+NAMESPACE_END
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <array>
+#include "image.hpp"
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+constexpr size_t k_color_space_num = getValueOf(ColorMatrix::END) * getValueOf(ColorRange::END);
+
+// Luma weights kr, kb of each ColorMatrix, kg = 1 - kr - kb
+struct LumaWeight {
+    double m_kr;
+    double m_kb;
+};
+
+constexpr std::array<LumaWeight, getValueOf(ColorMatrix::END)> k_luma_weight{{
+    {0.299, 0.114},         // BT.601
+    {0.2126, 0.0722},       // BT.709
+    {0.2627, 0.0593},       // BT.2020
+}};
+
+// Parameter tables are indexed by ColorMatrix * 2 + ColorRange
+constexpr ColorMatrix getColorMatrix(size_t idx) {
+    return static_cast<ColorMatrix>(idx / getValueOf(ColorRange::END));
+}
+
+constexpr ColorRange getColorRange(size_t idx) {
+    return static_cast<ColorRange>(idx % getValueOf(ColorRange::END));
+}
+
+inline size_t getColorSpaceIdx(const Image &img) {
+    return getValueOf(img.colorMatrix()) * getValueOf(ColorRange::END) + getValueOf(img.colorRange());
+}
+
+// Builds one parameter set per color space with make(kr, kb, range)
+template <typename P, typename F>
+constexpr std::array<P, k_color_space_num> makeColorSpaceTable(F make) {
+    std::array<P, k_color_space_num> table{};
+    for (size_t i = 0; i < table.size(); ++i) {
+        const auto &weight = k_luma_weight[getValueOf(getColorMatrix(i))];
+        table[i] = make(weight.m_kr, weight.m_kb, getColorRange(i));
+    }
+    return table;
+}
+
+NAMESPACE_END
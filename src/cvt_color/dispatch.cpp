@@ -0,0 +1,757 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+#include "alpha.hpp"
+#include "band.hpp"
+#include "cvt_color.hpp"
+#include "cpu_feature.hpp"
+#include "image.hpp"
+#include "kernel.hpp"
+#include "planar.hpp"
+#include "precise.hpp"
+#include "x86.hpp"
+#include "yuv16.hpp"
+
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+constexpr size_t k_fmt_num = getValueOf(ImageFormat::END);
+constexpr size_t k_tier_num = getValueOf(CpuTier::END);
+constexpr size_t k_precision_num = getValueOf(CvtPrecision::END);
+
+using CvtImpl = std::array<CvtFunction, k_tier_num>;
+using CvtImplTable = std::array<std::array<CvtImpl, k_fmt_num>, k_fmt_num>;
+
+#ifdef __aarch64__
+#define CVT_NEON(F) F
+#else
+#define CVT_NEON(F) nullptr
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define CVT_X86(F) F
+#else
+#define CVT_X86(F) nullptr
+#endif
+
+// Indexed by CpuTier: scalar, neon, sse4.1, avx2, avx512bw
+#define CVT_IMPL(F) CvtImpl{F##_c, CVT_NEON(F##_neon), nullptr, nullptr, nullptr}
+
+#define CVT_IMPL_FROM(S)                                                    \
+    std::array<CvtImpl, k_fmt_num>{                                         \
+        CVT_IMPL(S##_to_gray), CVT_IMPL(S##_to_rgba), CVT_IMPL(S##_to_rgb), \
+        CVT_IMPL(S##_to_bgra), CVT_IMPL(S##_to_bgr), CVT_IMPL(S##_to_yuyv), \
+        CVT_IMPL(S##_to_uyvy), CVT_IMPL(S##_to_i420),                       \
+        CVT_IMPL(S##_to_nv12), CVT_IMPL(S##_to_nv21)                        \
+    }
+
+#define CVT_IMPL_SET(T, S, D, SF, DF) \
+    table[getValueOf(ImageFormat::SF)][getValueOf(ImageFormat::DF)][getValueOf(CpuTier::T)] = S##_to_##D
+
+#define CVT_IMPL_SET_AVX2(S, D, SF, DF) CVT_IMPL_SET(AVX2, S, D##_avx2, SF, DF)
+#define CVT_IMPL_SET_AVX512(S, D, SF, DF) CVT_IMPL_SET(AVX512BW, S, D##_avx512, SF, DF)
+
+static constexpr CvtImplTable g_cvt_impl = [] {
+    CvtImplTable table{
+        CVT_IMPL_FROM(gray), CVT_IMPL_FROM(rgba), CVT_IMPL_FROM(rgb),
+        CVT_IMPL_FROM(bgra), CVT_IMPL_FROM(bgr), CVT_IMPL_FROM(yuyv),
+        CVT_IMPL_FROM(uyvy), CVT_IMPL_FROM(i420), CVT_IMPL_FROM(nv12),
+        CVT_IMPL_FROM(nv21)
+    };
+
+    // High bit depth sources only convert to rgb, nv12 and rgb48
+    #define CVT_IMPL_SET_YUV16(S, D, SF, DF)                                    \
+        table[getValueOf(ImageFormat::SF)][getValueOf(ImageFormat::DF)] =     \
+            CvtImpl{S##_to_##D##_c, nullptr, nullptr, CVT_X86(S##_to_##D##_avx2), nullptr}
+
+    #define CVT_IMPL_SET_YUV16_FROM(S, SF)                  \
+        CVT_IMPL_SET_YUV16(S, rgba, SF, RGBA);              \
+        CVT_IMPL_SET_YUV16(S, rgb, SF, RGB);                \
+        CVT_IMPL_SET_YUV16(S, bgra, SF, BGRA);              \
+        CVT_IMPL_SET_YUV16(S, bgr, SF, BGR);                \
+        CVT_IMPL_SET_YUV16(S, nv12, SF, NV12);              \
+        CVT_IMPL_SET_YUV16(S, rgb48, SF, RGB48)
+
+    CVT_IMPL_SET_YUV16_FROM(p010, P010);
+    CVT_IMPL_SET_YUV16_FROM(p016, P016);
+    CVT_IMPL_SET_YUV16_FROM(i010, I010);
+    CVT_IMPL_SET_YUV16_FROM(y210, Y210);
+    #undef CVT_IMPL_SET_YUV16_FROM
+    #undef CVT_IMPL_SET_YUV16
+
+    // The other 8 bit layouts convert from and to rgb, nv12 and i420
+    #define CVT_IMPL_SET_PLANAR(S, D, SF, DF)                                   \
+        table[getValueOf(ImageFormat::SF)][getValueOf(ImageFormat::DF)] =     \
+            CvtImpl{S##_to_##D##_c, nullptr, nullptr, CVT_X86(S##_to_##D##_avx2), nullptr}
+
+    #define CVT_IMPL_SET_PLANAR_WITH(X, XF)                 \
+        CVT_IMPL_SET_PLANAR(X, rgba, XF, RGBA);             \
+        CVT_IMPL_SET_PLANAR(X, rgb, XF, RGB);               \
+        CVT_IMPL_SET_PLANAR(X, bgra, XF, BGRA);             \
+        CVT_IMPL_SET_PLANAR(X, bgr, XF, BGR);               \
+        CVT_IMPL_SET_PLANAR(X, nv12, XF, NV12);             \
+        CVT_IMPL_SET_PLANAR(X, i420, XF, I420);             \
+        CVT_IMPL_SET_PLANAR(rgba, X, RGBA, XF);             \
+        CVT_IMPL_SET_PLANAR(rgb, X, RGB, XF);               \
+        CVT_IMPL_SET_PLANAR(bgra, X, BGRA, XF);             \
+        CVT_IMPL_SET_PLANAR(bgr, X, BGR, XF);               \
+        CVT_IMPL_SET_PLANAR(nv12, X, NV12, XF);             \
+        CVT_IMPL_SET_PLANAR(i420, X, I420, XF)
+
+    CVT_IMPL_SET_PLANAR_WITH(nv16, NV16);
+    CVT_IMPL_SET_PLANAR_WITH(nv24, NV24);
+    CVT_IMPL_SET_PLANAR_WITH(i422, I422);
+    CVT_IMPL_SET_PLANAR_WITH(i444, I444);
+    CVT_IMPL_SET_PLANAR_WITH(yv12, YV12);
+    #undef CVT_IMPL_SET_PLANAR_WITH
+    #undef CVT_IMPL_SET_PLANAR
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define CVT_IMPL_SET_AVX2_TO_RGB(S, SF)         \
+        CVT_IMPL_SET_AVX2(S, rgba, SF, RGBA);       \
+        CVT_IMPL_SET_AVX2(S, rgb, SF, RGB);         \
+        CVT_IMPL_SET_AVX2(S, bgra, SF, BGRA);       \
+        CVT_IMPL_SET_AVX2(S, bgr, SF, BGR)
+
+    CVT_IMPL_SET_AVX2_TO_RGB(yuyv, YUYV);
+    CVT_IMPL_SET_AVX2_TO_RGB(uyvy, UYVY);
+    CVT_IMPL_SET_AVX2_TO_RGB(i420, I420);
+    CVT_IMPL_SET_AVX2_TO_RGB(nv12, NV12);
+    CVT_IMPL_SET_AVX2_TO_RGB(nv21, NV21);
+    #undef CVT_IMPL_SET_AVX2_TO_RGB
+
+    #define CVT_IMPL_SET_X86_TO_YUV(S, SF)          \
+        CVT_IMPL_SET_AVX2(S, yuyv, SF, YUYV);       \
+        CVT_IMPL_SET_AVX2(S, uyvy, SF, UYVY);       \
+        CVT_IMPL_SET_AVX2(S, i420, SF, I420);       \
+        CVT_IMPL_SET_AVX2(S, nv12, SF, NV12);       \
+        CVT_IMPL_SET_AVX2(S, nv21, SF, NV21);       \
+        CVT_IMPL_SET_AVX512(S, yuyv, SF, YUYV);     \
+        CVT_IMPL_SET_AVX512(S, uyvy, SF, UYVY);     \
+        CVT_IMPL_SET_AVX512(S, i420, SF, I420);     \
+        CVT_IMPL_SET_AVX512(S, nv12, SF, NV12);     \
+        CVT_IMPL_SET_AVX512(S, nv21, SF, NV21)
+
+    CVT_IMPL_SET_X86_TO_YUV(rgba, RGBA);
+    CVT_IMPL_SET_X86_TO_YUV(rgb, RGB);
+    CVT_IMPL_SET_X86_TO_YUV(bgra, BGRA);
+    CVT_IMPL_SET_X86_TO_YUV(bgr, BGR);
+    #undef CVT_IMPL_SET_X86_TO_YUV
+
+    CVT_IMPL_SET_AVX2(rgb, bgr, RGB, BGR);
+    CVT_IMPL_SET_AVX2(bgr, rgb, BGR, RGB);
+    CVT_IMPL_SET_AVX2(rgba, bgra, RGBA, BGRA);
+    CVT_IMPL_SET_AVX2(bgra, rgba, BGRA, RGBA);
+    CVT_IMPL_SET_AVX2(yuyv, uyvy, YUYV, UYVY);
+    CVT_IMPL_SET_AVX2(uyvy, yuyv, UYVY, YUYV);
+    CVT_IMPL_SET_AVX2(nv12, nv21, NV12, NV21);
+    CVT_IMPL_SET_AVX2(nv21, nv12, NV21, NV12);
+#endif
+
+    return table;
+}();
+
+#define CVT_FOR_TO_RGB(X, S, SF)                \
+    X(S, rgba, SF, RGBA);                       \
+    X(S, rgb, SF, RGB);                         \
+    X(S, bgra, SF, BGRA);                       \
+    X(S, bgr, SF, BGR)
+
+#define CVT_FOR_YUV_TO_RGB(X)                   \
+    CVT_FOR_TO_RGB(X, yuyv, YUYV);              \
+    CVT_FOR_TO_RGB(X, uyvy, UYVY);              \
+    CVT_FOR_TO_RGB(X, i420, I420);              \
+    CVT_FOR_TO_RGB(X, nv12, NV12);              \
+    CVT_FOR_TO_RGB(X, nv21, NV21)
+
+// Layouts with chroma pairs on the planar kernels. NV24 and I444 carry a
+// sample per pixel, NEAREST is exact for them
+#define CVT_FOR_PLANAR_TO_RGB(X)                \
+    CVT_FOR_TO_RGB(X, yv12, YV12);              \
+    CVT_FOR_TO_RGB(X, i422, I422);              \
+    CVT_FOR_TO_RGB(X, nv16, NV16)
+
+#define CVT_FOR_TO_YUV(X, S, SF)                \
+    X(S, yuyv, SF, YUYV);                       \
+    X(S, uyvy, SF, UYVY);                       \
+    X(S, i420, SF, I420);                       \
+    X(S, nv12, SF, NV12);                       \
+    X(S, nv21, SF, NV21)
+
+#define CVT_FOR_RGB_TO_YUV(X)                   \
+    CVT_FOR_TO_YUV(X, rgba, RGBA);              \
+    CVT_FOR_TO_YUV(X, rgb, RGB);                \
+    CVT_FOR_TO_YUV(X, bgra, BGRA);              \
+    CVT_FOR_TO_YUV(X, bgr, BGR)
+
+// CvtPrecision::HIGH replaces the yuv <-> rgb kernels, the other pairs are
+// exact already and keep the FAST ones. Tiers without a HIGH kernel fall
+// back to the best lower one
+static constexpr CvtImplTable g_cvt_precise_impl = [] {
+    auto table = g_cvt_impl;
+
+    #define CVT_IMPL_SET_PRECISE(S, D, SF, DF)                                  \
+        table[getValueOf(ImageFormat::SF)][getValueOf(ImageFormat::DF)] =     \
+            CvtImpl{S##_to_##D##_precise_c, CVT_NEON(S##_to_##D##_precise_neon),  \
+                    nullptr, CVT_X86(S##_to_##D##_precise_avx2), nullptr}
+
+    CVT_FOR_YUV_TO_RGB(CVT_IMPL_SET_PRECISE);
+    CVT_FOR_RGB_TO_YUV(CVT_IMPL_SET_PRECISE);
+    #undef CVT_IMPL_SET_PRECISE
+
+    return table;
+}();
+
+// Bilinear chroma kernels convert a row range of the whole frame, so
+// cvtColor can band them without cutting the chroma rows around a band
+using CvtRowsFunction = void(*)(const Image&, const Image&, int32_t, int32_t);
+using CvtRowsImpl = std::array<CvtRowsFunction, k_tier_num>;
+
+template <CvtRowsFunction F>
+static void cvtAllRows(const Image &src, const Image &dst) {
+    F(src, dst, 0, src.rows());
+}
+
+static constexpr std::array<std::array<CvtRowsImpl, k_fmt_num>, k_fmt_num> g_cvt_bilinear_rows = [] {
+    std::array<std::array<CvtRowsImpl, k_fmt_num>, k_fmt_num> table{};
+
+    #define CVT_ROWS_SET_BILINEAR(S, D, SF, DF)                                 \
+        table[getValueOf(ImageFormat::SF)][getValueOf(ImageFormat::DF)] =     \
+            CvtRowsImpl{S##_to_##D##_bilinear_c, CVT_NEON(S##_to_##D##_bilinear_neon),  \
+                        nullptr, CVT_X86(S##_to_##D##_bilinear_avx2), nullptr}
+
+    CVT_FOR_YUV_TO_RGB(CVT_ROWS_SET_BILINEAR);
+    CVT_FOR_PLANAR_TO_RGB(CVT_ROWS_SET_BILINEAR);
+    #undef CVT_ROWS_SET_BILINEAR
+
+    return table;
+}();
+
+// ChromaFilter::BILINEAR runs on the HIGH arithmetic, only yuv -> rgb differs
+static constexpr CvtImplTable g_cvt_bilinear_impl = [] {
+    auto table = g_cvt_precise_impl;
+
+    #define CVT_IMPL_SET_BILINEAR(S, D, SF, DF)                                 \
+        table[getValueOf(ImageFormat::SF)][getValueOf(ImageFormat::DF)] =     \
+            CvtImpl{cvtAllRows<S##_to_##D##_bilinear_c>,                        \
+                    CVT_NEON(cvtAllRows<S##_to_##D##_bilinear_neon>), nullptr,  \
+                    CVT_X86(cvtAllRows<S##_to_##D##_bilinear_avx2>), nullptr}
+
+    CVT_FOR_YUV_TO_RGB(CVT_IMPL_SET_BILINEAR);
+    CVT_FOR_PLANAR_TO_RGB(CVT_IMPL_SET_BILINEAR);
+    #undef CVT_IMPL_SET_BILINEAR
+
+    // High bit depth sources have no bilinear kernels, the option is
+    // rejected for them rather than falling back to NEAREST
+    for (auto s : {ImageFormat::P010, ImageFormat::P016, ImageFormat::I010, ImageFormat::Y210}) {
+        for (auto d : {ImageFormat::RGBA, ImageFormat::RGB, ImageFormat::BGRA, ImageFormat::BGR, ImageFormat::RGB48}) {
+            table[getValueOf(s)][getValueOf(d)] = CvtImpl{};
+        }
+    }
+
+    return table;
+}();
+
+// AlphaOp kernels between rgba and bgra, indexed by op, source and dst
+// (rgba, bgra). NONE has none, it uses the kernel sets above
+constexpr size_t k_alpha_num = getValueOf(AlphaOp::END);
+using CvtAlphaTable = std::array<std::array<std::array<CvtImpl, 2>, 2>, k_alpha_num>;
+
+static constexpr CvtAlphaTable g_cvt_alpha_impl = [] {
+    CvtAlphaTable table{};
+
+    #define CVT_ALPHA_SET_OP(S, D, SI, DI, OP, OPF)                             \
+        table[getValueOf(AlphaOp::OPF)][SI][DI] =                               \
+            CvtImpl{S##_to_##D##_##OP##_c, CVT_NEON(S##_to_##D##_##OP##_neon),  \
+                    nullptr, CVT_X86(S##_to_##D##_##OP##_avx2), nullptr}
+
+    #define CVT_ALPHA_SET(S, D, SI, DI)                                         \
+        CVT_ALPHA_SET_OP(S, D, SI, DI, premultiply, PREMULTIPLY);             \
+        CVT_ALPHA_SET_OP(S, D, SI, DI, unpremultiply, UNPREMULTIPLY);         \
+        CVT_ALPHA_SET_OP(S, D, SI, DI, preserve, PRESERVE)
+
+    CVT_ALPHA_SET(rgba, rgba, 0, 0);
+    CVT_ALPHA_SET(rgba, bgra, 0, 1);
+    CVT_ALPHA_SET(bgra, rgba, 1, 0);
+    CVT_ALPHA_SET(bgra, bgra, 1, 1);
+    #undef CVT_ALPHA_SET
+    #undef CVT_ALPHA_SET_OP
+
+    return table;
+}();
+
+#undef CVT_FOR_RGB_TO_YUV
+#undef CVT_FOR_TO_YUV
+#undef CVT_FOR_PLANAR_TO_RGB
+#undef CVT_FOR_YUV_TO_RGB
+#undef CVT_FOR_TO_RGB
+#undef CVT_X86
+
+// Kernel sets selected by CvtOption: FAST, HIGH, bilinear chroma
+constexpr size_t k_impl_set_num = k_precision_num + 1;
+
+static constexpr std::array<const CvtImplTable*, k_impl_set_num> g_cvt_impl_of{
+    &g_cvt_impl, &g_cvt_precise_impl, &g_cvt_bilinear_impl
+};
+
+static bool isValidOption(const CvtOption &option) {
+    return option.m_precision < CvtPrecision::END && option.m_chroma_filter < ChromaFilter::END &&
+           option.m_alpha < AlphaOp::END;
+}
+
+static bool hasAlpha(ImageFormat fmt) {
+    return ImageFormat::RGBA == fmt || ImageFormat::BGRA == fmt;
+}
+
+// Whether the alpha op of the option changes src -> dst
+static bool isAlphaApplied(ImageFormat src, ImageFormat dst, AlphaOp op) {
+    return AlphaOp::PRESERVE == op ? hasAlpha(dst) : AlphaOp::NONE != op && hasAlpha(src);
+}
+
+static const CvtImpl *getAlphaImpl(ImageFormat src, ImageFormat dst, AlphaOp op) {
+    if (!hasAlpha(src) || !hasAlpha(dst)) {
+        return nullptr;
+    }
+    return &g_cvt_alpha_impl[getValueOf(op)][ImageFormat::BGRA == src][ImageFormat::BGRA == dst];
+}
+
+static size_t getImplSet(const CvtOption &option) {
+    return ChromaFilter::BILINEAR == option.m_chroma_filter ? k_precision_num : getValueOf(option.m_precision);
+}
+
+#undef CVT_IMPL_SET_AVX512
+#undef CVT_IMPL_SET_AVX2
+#undef CVT_IMPL_SET
+#undef CVT_IMPL_FROM
+#undef CVT_IMPL
+#undef CVT_NEON
+
+// Best implementation per kernel set and conversion for `g_bound_tier`,
+// rebound when the active tier changes
+static std::array<std::array<std::array<std::atomic<CvtFunction>, k_fmt_num>, k_fmt_num>, k_impl_set_num> g_cvt_bound;
+static std::atomic<CpuTier> g_bound_tier{CpuTier::END};
+static std::mutex g_bind_mutex;
+
+static void bindCvtFunc(CpuTier tier) {
+    std::lock_guard<std::mutex> lock(g_bind_mutex);
+    if (tier == g_bound_tier.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    for (size_t p = 0; p < k_impl_set_num; ++p) {
+        const auto &impl = *g_cvt_impl_of[p];
+        for (size_t i = 0; i < k_fmt_num; ++i) {
+            for (size_t j = 0; j < k_fmt_num; ++j) {
+                CvtFunction func = nullptr;
+                for (auto t = static_cast<int32_t>(getValueOf(tier)); t >= 0 && nullptr == func; --t) {
+                    if (isCpuTierSupported(static_cast<CpuTier>(t))) {
+                        func = impl[i][j][t];
+                    }
+                }
+                g_cvt_bound[p][i][j].store(func, std::memory_order_relaxed);
+            }
+        }
+    }
+    g_bound_tier.store(tier, std::memory_order_release);
+}
+
+CvtFunction getCvtFunc(ImageFormat src, ImageFormat dst, const CvtOption &option) {
+    if (src >= ImageFormat::END || dst >= ImageFormat::END || !isValidOption(option)) {
+        return nullptr;
+    }
+    if (isAlphaApplied(src, dst, option.m_alpha)) {
+        const auto *impl = getAlphaImpl(src, dst, option.m_alpha);
+        if (nullptr == impl) {
+            return nullptr;
+        }
+        for (auto t = static_cast<int32_t>(getValueOf(getCpuTier())); t >= 0; --t) {
+            if (nullptr != (*impl)[t] && isCpuTierSupported(static_cast<CpuTier>(t))) {
+                return (*impl)[t];
+            }
+        }
+        return nullptr;
+    }
+
+    auto tier = getCpuTier();
+    if (tier != g_bound_tier.load(std::memory_order_acquire)) {
+        bindCvtFunc(tier);
+    }
+    return g_cvt_bound[getImplSet(option)][getValueOf(src)][getValueOf(dst)].load(std::memory_order_relaxed);
+}
+
+CvtFunction getCvtFunc(ImageFormat src, ImageFormat dst, CpuTier tier, const CvtOption &option) {
+    if (src >= ImageFormat::END || dst >= ImageFormat::END || tier >= CpuTier::END || !isValidOption(option)) {
+        return nullptr;
+    }
+    if (isAlphaApplied(src, dst, option.m_alpha)) {
+        const auto *impl = getAlphaImpl(src, dst, option.m_alpha);
+        return nullptr == impl ? nullptr : (*impl)[getValueOf(tier)];
+    }
+    return (*g_cvt_impl_of[getImplSet(option)])[getValueOf(src)][getValueOf(dst)][getValueOf(tier)];
+}
+
+static bool isYuv420(ImageFormat fmt) {
+    return ImageFormat::I420 == fmt || ImageFormat::NV12 == fmt || ImageFormat::NV21 == fmt ||
+           ImageFormat::P010 == fmt || ImageFormat::P016 == fmt || ImageFormat::I010 == fmt ||
+           ImageFormat::YV12 == fmt;
+}
+
+static bool isSubsampled(ImageFormat fmt) {
+    return ImageFormat::YUYV == fmt || ImageFormat::UYVY == fmt || ImageFormat::Y210 == fmt ||
+           ImageFormat::NV16 == fmt || ImageFormat::I422 == fmt || isYuv420(fmt);
+}
+
+void checkCvtColor(const Image &src, const Image &dst) {
+    if (0 == src.pixels() || 0 == dst.pixels()) {
+        throw std::invalid_argument("Image must not be empty");
+    }
+    if (src.fmt() >= ImageFormat::END || dst.fmt() >= ImageFormat::END) {
+        throw std::invalid_argument("Unsupported image format");
+    }
+    if (nullptr == getCvtFunc(src.fmt(), dst.fmt(), CpuTier::SCALAR)) {
+        throw std::invalid_argument("Unsupported conversion");
+    }
+    if (src.rows() != dst.rows() || src.cols() != dst.cols()) {
+        throw std::invalid_argument("Image size must match");
+    }
+    if ((isSubsampled(src.fmt()) || isSubsampled(dst.fmt())) && 0 != src.cols() % 2) {
+        throw std::invalid_argument("Width must be even");
+    }
+    if ((isYuv420(src.fmt()) || isYuv420(dst.fmt())) && 0 != src.rows() % 2) {
+        throw std::invalid_argument("Height must be even");
+    }
+}
+
+// The named 8 bit conversions of cvt_color.hpp
+static void cvtEntry(ImageFormat src_fmt, ImageFormat dst_fmt, const Image &src, const Image &dst) {
+    if (src_fmt != src.fmt() || dst_fmt != dst.fmt()) {
+        throw std::invalid_argument("Image format must match");
+    }
+    checkCvtColor(src, dst);
+    getCvtFunc(src_fmt, dst_fmt)(src, dst);
+}
+
+#define CVT_ENTRY(S, D, SF, DF)                                             \
+    void S##_to_##D(const Image &src, const Image &dst) {                 \
+        cvtEntry(ImageFormat::SF, ImageFormat::DF, src, dst);              \
+    }
+
+#define CVT_ENTRY_FROM(S, SF)                                               \
+    CVT_ENTRY(S, gray, SF, GRAY)                                            \
+    CVT_ENTRY(S, rgba, SF, RGBA)                                            \
+    CVT_ENTRY(S, rgb, SF, RGB)                                              \
+    CVT_ENTRY(S, bgra, SF, BGRA)                                            \
+    CVT_ENTRY(S, bgr, SF, BGR)                                              \
+    CVT_ENTRY(S, yuyv, SF, YUYV)                                            \
+    CVT_ENTRY(S, uyvy, SF, UYVY)                                            \
+    CVT_ENTRY(S, i420, SF, I420)                                            \
+    CVT_ENTRY(S, nv12, SF, NV12)                                            \
+    CVT_ENTRY(S, nv21, SF, NV21)
+
+CVT_ENTRY_FROM(gray, GRAY)
+CVT_ENTRY_FROM(rgba, RGBA)
+CVT_ENTRY_FROM(rgb, RGB)
+CVT_ENTRY_FROM(bgra, BGRA)
+CVT_ENTRY_FROM(bgr, BGR)
+CVT_ENTRY_FROM(yuyv, YUYV)
+CVT_ENTRY_FROM(uyvy, UYVY)
+CVT_ENTRY_FROM(i420, I420)
+CVT_ENTRY_FROM(nv12, NV12)
+CVT_ENTRY_FROM(nv21, NV21)
+
+#undef CVT_ENTRY_FROM
+#undef CVT_ENTRY
+
+// Row range kernel of the option for the active tier, nullptr if the pair
+// has none
+static CvtRowsFunction getCvtRowsFunc(ImageFormat src, ImageFormat dst, const CvtOption &option) {
+    if (ChromaFilter::BILINEAR != option.m_chroma_filter) {
+        return nullptr;
+    }
+    const auto &impl = g_cvt_bilinear_rows[getValueOf(src)][getValueOf(dst)];
+    for (auto t = static_cast<int32_t>(getValueOf(getCpuTier())); t >= 0; --t) {
+        if (nullptr != impl[t] && isCpuTierSupported(static_cast<CpuTier>(t))) {
+            return impl[t];
+        }
+    }
+    return nullptr;
+}
+
+// Pairs whose kernels may run with src and dst on the same memory
+static bool isInPlacePair(ImageFormat src, ImageFormat dst) {
+    auto is = [=](ImageFormat a, ImageFormat b) {
+        return (a == src && b == dst) || (b == src && a == dst);
+    };
+    return src == dst || is(ImageFormat::RGB, ImageFormat::BGR) || is(ImageFormat::RGBA, ImageFormat::BGRA) ||
+           is(ImageFormat::YUYV, ImageFormat::UYVY) || is(ImageFormat::NV12, ImageFormat::NV21) ||
+           is(ImageFormat::I420, ImageFormat::YV12);
+}
+
+static bool isSameMemory(const Image &src, const Image &dst) {
+    if (src.rows() != dst.rows() || src.cols() != dst.cols() || src.planes() != dst.planes()) {
+        return false;
+    }
+    for (size_t p = 0; p < src.planes(); ++p) {
+        if (src.data(p) != dst.data(p) || src.stride(p) != dst.stride(p)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// A conversion validated and resolved up front. run() converts the rows
+// [row, row + rows), an even row band, and may be called concurrently for
+// disjoint bands with scratch of their own. src and dst are views of the
+// caller's images
+struct CvtPass {
+    Image m_src;
+    Image m_dst;
+    CvtFunction m_func{nullptr};
+    // Reads the rows around the band, used instead of m_func
+    CvtRowsFunction m_rows_func{nullptr};
+    // Alpha op through a cache sized strip, before m_func in the source
+    // format when m_alpha_first, after it in the dst format otherwise
+    CvtFunction m_alpha{nullptr};
+    bool m_alpha_first{false};
+    // i420 <-> yv12 in place only swaps the chroma planes
+    bool m_swap_chroma{false};
+
+    bool empty() const {
+        return nullptr == m_func && nullptr == m_rows_func && !m_swap_chroma;
+    }
+
+    // Bytes of scratch run() needs, the strip of an alpha op
+    size_t scratchSize() const {
+        return nullptr == m_alpha ? 0 : getImgSize(getStripRows(), m_src.cols(), getStripFmt());
+    }
+
+    void run(int32_t row, int32_t rows, uint8_t *scratch) const {
+        auto w = m_src.cols();
+        if (nullptr != m_rows_func) {
+            m_rows_func(m_src, m_dst, row, rows);
+        } else if (m_swap_chroma) {
+            for (auto i = row >> 1; i < (row + rows) >> 1; ++i) {
+                std::swap_ranges(m_dst.ptr(i, 1), m_dst.ptr(i, 1) + (w >> 1), m_dst.ptr(i, 2));
+            }
+        } else if (nullptr == m_alpha) {
+            if (rows == m_src.rows()) {
+                m_func(m_src, m_dst);
+            } else {
+                m_func(m_src.roi(0, row, w, rows), m_dst.roi(0, row, w, rows));
+            }
+        } else {
+            runAlphaStrips(row, rows, scratch);
+        }
+    }
+
+private:
+    // Even so 4:2:0 chroma rows pair up within a strip
+    int32_t getStripRows() const {
+        return std::max(2, static_cast<int32_t>(k_strip_bytes / (4UL * m_src.cols())) & ~1);
+    }
+
+    ImageFormat getStripFmt() const {
+        return m_alpha_first ? m_src.fmt() : m_dst.fmt();
+    }
+
+    // The source is premultiplied or unpremultiplied into the strip that
+    // m_func converts, or, for PRESERVE, m_func converts into the strip and
+    // dst takes its colours
+    void runAlphaStrips(int32_t row, int32_t rows, uint8_t *scratch) const {
+        auto w = m_src.cols();
+        auto strip = std::min(getStripRows(), rows);
+        Image tmp(strip, w, getStripFmt(), scratch);
+        for (auto i = row; i < row + rows; i += strip) {
+            auto n = std::min(strip, row + rows - i);
+            auto s = m_src.roi(0, i, w, n);
+            auto d = m_dst.roi(0, i, w, n);
+            auto t = tmp.roi(0, 0, w, n);
+            if (m_alpha_first) {
+                m_alpha(s, t);
+                m_func(t, d);
+            } else {
+                m_func(s, t);
+                m_alpha(t, d);
+            }
+        }
+    }
+};
+
+// src -> fmt over the memory of src, dst is relabelled to fmt. src may be
+// dst itself
+static CvtPass prepareInPlace(const Image &src, Image &dst, ImageFormat fmt, const CvtOption &option) {
+    if (!isInPlacePair(src.fmt(), fmt) || (dst.fmt() != src.fmt() && dst.fmt() != fmt) || !isSameMemory(src, dst)) {
+        throw std::invalid_argument("Conversion must not be in place");
+    }
+    CvtPass pass{src.roi(0, 0, src.cols(), src.rows()), dst.roi(0, 0, src.cols(), src.rows())};
+    if (src.fmt() == fmt && !isAlphaApplied(fmt, fmt, option.m_alpha)) {
+        dst.setFmt(fmt);
+        return pass;
+    }
+    pass.m_dst.setFmt(fmt);
+    checkCvtColor(pass.m_src, pass.m_dst);
+    pass.m_swap_chroma = (ImageFormat::I420 == src.fmt() && ImageFormat::YV12 == fmt) ||
+                         (ImageFormat::YV12 == src.fmt() && ImageFormat::I420 == fmt);
+    if (!pass.m_swap_chroma) {
+        pass.m_func = getCvtFunc(src.fmt(), fmt, option);
+    }
+    dst.setFmt(fmt);
+    return pass;
+}
+
+// Validates src -> fmt, (re)creates dst when needed and resolves the
+// kernels, an empty pass has nothing to convert
+static CvtPass prepareCvtColor(const Image &src, Image &dst, ImageFormat fmt, const CvtOption &option) {
+    if (fmt >= ImageFormat::END) {
+        throw std::invalid_argument("Unsupported image format");
+    }
+    if (!isValidOption(option)) {
+        throw std::invalid_argument("Unsupported conversion option");
+    }
+    if (src.data() == dst.data() && nullptr != src.data()) {
+        return prepareInPlace(src, dst, fmt, option);
+    }
+    auto alpha = option.m_alpha;
+    if (src.rows() != dst.rows() || src.cols() != dst.cols() || fmt != dst.fmt()) {
+        auto matrix = dst.colorMatrix();
+        auto range = dst.colorRange();
+        auto siting = dst.chromaSiting();
+        dst.create(src.rows(), src.cols(), fmt);
+        dst.setColorSpace(matrix, range);
+        dst.setChromaSiting(siting);
+        // A new dst has no alpha to keep
+        if (AlphaOp::PRESERVE == alpha) {
+            alpha = AlphaOp::NONE;
+        }
+    }
+    checkCvtColor(src, dst);
+
+    CvtPass pass{src.roi(0, 0, src.cols(), src.rows()), dst.roi(0, 0, src.cols(), src.rows())};
+    auto plain = option;
+    plain.m_alpha = AlphaOp::NONE;
+    if (isAlphaApplied(src.fmt(), fmt, alpha)) {
+        auto applied = option;
+        applied.m_alpha = alpha;
+        if (hasAlpha(src.fmt()) && hasAlpha(fmt)) {
+            pass.m_func = getCvtFunc(src.fmt(), fmt, applied);
+            return pass;
+        }
+        // Bilinear chroma needs the rows around each strip
+        if (ChromaFilter::BILINEAR == option.m_chroma_filter) {
+            throw std::invalid_argument("Unsupported conversion option");
+        }
+        pass.m_alpha_first = AlphaOp::PRESERVE != alpha;
+        auto strip_fmt = pass.m_alpha_first ? src.fmt() : fmt;
+        pass.m_func = getCvtFunc(src.fmt(), fmt, plain);
+        pass.m_alpha = getCvtFunc(strip_fmt, strip_fmt, applied);
+        return pass;
+    }
+    pass.m_rows_func = getCvtRowsFunc(src.fmt(), fmt, plain);
+    if (nullptr == pass.m_rows_func) {
+        pass.m_func = getCvtFunc(src.fmt(), fmt, plain);
+    }
+    // The pair converts, but not with this option
+    if (pass.empty()) {
+        throw std::invalid_argument("Unsupported conversion option");
+    }
+    return pass;
+}
+
+void cvtColor(const Image &src, Image &dst) {
+    cvtColor(src, dst, dst.fmt());
+}
+
+void cvtColor(const Image &src, Image &dst, ImageFormat fmt, const CvtOption &option) {
+    auto pass = prepareCvtColor(src, dst, fmt, option);
+    if (pass.empty()) {
+        return;
+    }
+    auto size = pass.scratchSize();
+    std::vector<uint8_t> scratch;
+    forEachRowBand(
+        src, [&](size_t bands) { scratch.resize(bands * size); },
+        [&](size_t band, int32_t row, int32_t rows) { pass.run(row, rows, scratch.data() + band * size); });
+}
+
+void cvtColorBatch(const Image *src, Image *dst, size_t n, ImageFormat fmt, const CvtOption &option) {
+    if (0 != n && (nullptr == src || nullptr == dst)) {
+        throw std::invalid_argument("Image array must not be null");
+    }
+    std::vector<CvtPass> passes;
+    passes.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto pass = prepareCvtColor(src[i], dst[i], fmt, option);
+        if (!pass.empty()) {
+            passes.push_back(std::move(pass));
+        }
+    }
+
+    // Frames are cut into even row bands of about k_band_pixels, and runs
+    // of bands, across frames, into tasks of at least that many pixels so
+    // small frames share a task and large ones spread over the threads
+    struct Band {
+        size_t m_pass;
+        int32_t m_row;
+        int32_t m_rows;
+    };
+    std::vector<Band> bands;
+    std::vector<size_t> tasks{0};
+    size_t task_pixels = 0;
+    for (size_t i = 0; i < passes.size(); ++i) {
+        auto h = passes[i].m_src.rows();
+        auto w = static_cast<size_t>(passes[i].m_src.cols());
+        auto step = std::max(2, static_cast<int32_t>(k_band_pixels / w) & ~1);
+        for (int32_t row = 0; row < h; row += step) {
+            bands.push_back({i, row, std::min(step, h - row)});
+            task_pixels += w * bands.back().m_rows;
+            if (task_pixels >= k_band_pixels) {
+                tasks.push_back(bands.size());
+                task_pixels = 0;
+            }
+        }
+    }
+    if (tasks.back() != bands.size()) {
+        tasks.push_back(bands.size());
+    }
+
+    // Workers pull the tasks in order, each with a scratch of the largest
+    // size allocated before any of them runs
+    size_t size = 0;
+    for (const auto &pass : passes) {
+        size = std::max(size, pass.scratchSize());
+    }
+    auto *executor = getDefaultExecutor();
+    auto workers = std::max(std::min(tasks.size() - 1, executor->concurrency()), size_t{1});
+    std::vector<uint8_t> scratch(workers * size);
+    std::atomic<size_t> next{0};
+    auto worker = [&](size_t k) {
+        for (auto t = next.fetch_add(1); t + 1 < tasks.size(); t = next.fetch_add(1)) {
+            for (auto b = tasks[t]; b < tasks[t + 1]; ++b) {
+                passes[bands[b].m_pass].run(bands[b].m_row, bands[b].m_rows, scratch.data() + k * size);
+            }
+        }
+    };
+    if (workers <= 1) {
+        worker(0);
+        return;
+    }
+    executor->run(workers, worker);
+}
+
+void cvtColor(const Image &src, Image &dst, ImageFormat fmt, ColorMatrix matrix, ColorRange range, const CvtOption &option) {
+    if (0 == src.pixels()) {
+        throw std::invalid_argument("Image must not be empty");
+    }
+    // The kernels read the colorimetry of the yuv side, tag a view of src
+    // rather than the caller's image
+    auto view = src.roi(0, 0, src.cols(), src.rows());
+    view.setColorSpace(matrix, range);
+    dst.setColorSpace(matrix, range);
+    cvtColor(view, dst, fmt, option);
+}
+
+NAMESPACE_END
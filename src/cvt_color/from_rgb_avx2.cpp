@@ -0,0 +1,278 @@
+#include "image.hpp"
+#include "types.hpp"
+#include "rgb.hpp"
+#include "x86.hpp"
+#include "x86_pixel.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+NAMESPACE_BEGIN
+
+constexpr int32_t k_offset = 1 << k_shift;
+
+// Per pixel y (packed to u8) and u/v (int16) with the _c fixed point math
+AVX2_FUNC static inline void rgbToYuv(const Rgb2YuvParam &param, __m128i r, __m128i g, __m128i b, __m128i &y, __m256i &u, __m256i &v) {
+    auto r16 = _mm256_cvtepu8_epi16(r);
+    auto g16 = _mm256_cvtepu8_epi16(g);
+    auto b16 = _mm256_cvtepu8_epi16(b);
+
+    auto y16 = _mm256_add_epi16(_mm256_add_epi16(_mm256_mullo_epi16(r16, _mm256_set1_epi16(param.m_yr)),
+                                                 _mm256_mullo_epi16(g16, _mm256_set1_epi16(param.m_yg))),
+                                _mm256_mullo_epi16(b16, _mm256_set1_epi16(param.m_yb)));
+    y16 = _mm256_srli_epi16(_mm256_add_epi16(y16, _mm256_set1_epi16(param.m_y_ofs)), k_shift);
+    y = _mm_packus_epi16(_mm256_castsi256_si128(y16), _mm256_extracti128_si256(y16, 1));
+
+    u = _mm256_srai_epi16(_mm256_sub_epi16(_mm256_mullo_epi16(b16, _mm256_set1_epi16(param.m_ub)),
+                                           _mm256_add_epi16(_mm256_mullo_epi16(r16, _mm256_set1_epi16(param.m_ur)),
+                                                            _mm256_mullo_epi16(g16, _mm256_set1_epi16(param.m_ug)))), k_shift);
+    v = _mm256_srai_epi16(_mm256_sub_epi16(_mm256_mullo_epi16(r16, _mm256_set1_epi16(param.m_vr)),
+                                           _mm256_add_epi16(_mm256_mullo_epi16(g16, _mm256_set1_epi16(param.m_vg)),
+                                                            _mm256_mullo_epi16(b16, _mm256_set1_epi16(param.m_vb)))), k_shift);
+}
+
+// Sum of each horizontal pair as int32
+AVX2_FUNC static inline __m256i sumPair(__m256i val) {
+    return _mm256_madd_epi16(val, _mm256_set1_epi16(1));
+}
+
+// (sum >> shift) + 128 of 8 int32 saturated to u8 in the low 8 bytes
+AVX2_FUNC static inline __m128i packChroma(__m256i sum, int32_t shift) {
+    sum = _mm256_add_epi32(_mm256_srai_epi32(sum, shift), _mm256_set1_epi32(k_offset));
+    auto val = _mm_packs_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    return _mm_packus_epi16(val, val);
+}
+
+// Row functions take the coefficients by value, a local copy cannot alias
+// the rows so they stay in registers across the stores
+template <ImageFormat S, ImageFormat D>
+AVX2_FUNC static int32_t rgbToYuv422RowAvx2(Rgb2YuvParam param, const uint8_t *src, uint8_t *dst, int32_t w) {
+    constexpr int32_t k_pixel_per_loop = 16;
+    int32_t j = 0;
+    for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+        __m128i r, g, b, y;
+        __m256i u, v;
+        loadRgb<S>(src + (j * getChannel<S>()), r, g, b);
+        rgbToYuv(param, r, g, b, y, u, v);
+        storeYuv422<D>(dst + (j << 1), y, packChroma(sumPair(u), 1), packChroma(sumPair(v), 1));
+    }
+    return j;
+}
+
+template <ImageFormat S, ImageFormat D>
+AVX2_FUNC static int32_t rgbToYuv420RowAvx2(Rgb2YuvParam param, const uint8_t *src0, const uint8_t *src1, uint8_t *y0, uint8_t *y1,
+                                            uint8_t *u_buf, uint8_t *v_buf, int32_t w) {
+    constexpr int32_t k_pixel_per_loop = 16;
+    int32_t j = 0;
+    for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+        __m128i r, g, b, y;
+        __m256i u0, v0, u1, v1;
+        loadRgb<S>(src0 + (j * getChannel<S>()), r, g, b);
+        rgbToYuv(param, r, g, b, y, u0, v0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y0 + j), y);
+        loadRgb<S>(src1 + (j * getChannel<S>()), r, g, b);
+        rgbToYuv(param, r, g, b, y, u1, v1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(y1 + j), y);
+
+        auto u = packChroma(_mm256_add_epi32(sumPair(u0), sumPair(u1)), 2);
+        auto v = packChroma(_mm256_add_epi32(sumPair(v0), sumPair(v1)), 2);
+        if constexpr (ImageFormat::I420 == D) {
+            storeUv420<D>(u_buf + (j >> 1), v_buf + (j >> 1), u, v);
+        } else {
+            storeUv420<D>(u_buf + j, nullptr, u, v);
+        }
+    }
+    return j;
+}
+
+// AVX-512BW does 32 pixels a loop, loads and stores reuse the 16 pixel
+// helpers, only the arithmetic runs on 512 bit registers
+AVX512_FUNC static inline void rgbToYuv(const Rgb2YuvParam &param, __m256i r, __m256i g, __m256i b, __m256i &y, __m512i &u, __m512i &v) {
+    auto r16 = _mm512_cvtepu8_epi16(r);
+    auto g16 = _mm512_cvtepu8_epi16(g);
+    auto b16 = _mm512_cvtepu8_epi16(b);
+
+    auto y16 = _mm512_add_epi16(_mm512_add_epi16(_mm512_mullo_epi16(r16, _mm512_set1_epi16(param.m_yr)),
+                                                 _mm512_mullo_epi16(g16, _mm512_set1_epi16(param.m_yg))),
+                                _mm512_mullo_epi16(b16, _mm512_set1_epi16(param.m_yb)));
+    y16 = _mm512_add_epi16(y16, _mm512_set1_epi16(param.m_y_ofs));
+    y = _mm512_cvtepi16_epi8(_mm512_srli_epi16(y16, k_shift));
+
+    u = _mm512_srai_epi16(_mm512_sub_epi16(_mm512_mullo_epi16(b16, _mm512_set1_epi16(param.m_ub)),
+                                           _mm512_add_epi16(_mm512_mullo_epi16(r16, _mm512_set1_epi16(param.m_ur)),
+                                                            _mm512_mullo_epi16(g16, _mm512_set1_epi16(param.m_ug)))), k_shift);
+    v = _mm512_srai_epi16(_mm512_sub_epi16(_mm512_mullo_epi16(r16, _mm512_set1_epi16(param.m_vr)),
+                                           _mm512_add_epi16(_mm512_mullo_epi16(g16, _mm512_set1_epi16(param.m_vg)),
+                                                            _mm512_mullo_epi16(b16, _mm512_set1_epi16(param.m_vb)))), k_shift);
+}
+
+AVX512_FUNC static inline __m512i sumPair(__m512i val) {
+    return _mm512_madd_epi16(val, _mm512_set1_epi16(1));
+}
+
+// Results are within [0, 255] so the truncating narrow saturates as well
+AVX512_FUNC static inline __m128i packChroma(__m512i sum, int32_t shift) {
+    sum = _mm512_add_epi32(_mm512_srai_epi32(sum, shift), _mm512_set1_epi32(k_offset));
+    return _mm512_cvtepi32_epi8(sum);
+}
+
+template <ImageFormat S>
+AVX512_FUNC static inline void loadRgb(const uint8_t *src, __m256i &r, __m256i &g, __m256i &b) {
+    __m128i r0, g0, b0, r1, g1, b1;
+    loadRgb<S>(src, r0, g0, b0);
+    loadRgb<S>(src + (16 * getChannel<S>()), r1, g1, b1);
+    r = _mm256_set_m128i(r1, r0);
+    g = _mm256_set_m128i(g1, g0);
+    b = _mm256_set_m128i(b1, b0);
+}
+
+template <ImageFormat S, ImageFormat D>
+AVX512_FUNC static int32_t rgbToYuv422RowAvx512(Rgb2YuvParam param, const uint8_t *src, uint8_t *dst, int32_t w) {
+    constexpr int32_t k_pixel_per_loop = 32;
+    int32_t j = 0;
+    for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+        __m256i r, g, b, y;
+        __m512i u, v;
+        loadRgb<S>(src + (j * getChannel<S>()), r, g, b);
+        rgbToYuv(param, r, g, b, y, u, v);
+        auto uu = packChroma(sumPair(u), 1);
+        auto vv = packChroma(sumPair(v), 1);
+        storeYuv422<D>(dst + (j << 1), _mm256_castsi256_si128(y), uu, vv);
+        storeYuv422<D>(dst + (j << 1) + 32, _mm256_extracti128_si256(y, 1), _mm_srli_si128(uu, 8), _mm_srli_si128(vv, 8));
+    }
+    return j + rgbToYuv422RowAvx2<S, D>(param, src + (j * getChannel<S>()), dst + (j << 1), w - j);
+}
+
+template <ImageFormat S, ImageFormat D>
+AVX512_FUNC static int32_t rgbToYuv420RowAvx512(Rgb2YuvParam param, const uint8_t *src0, const uint8_t *src1, uint8_t *y0, uint8_t *y1,
+                                                uint8_t *u_buf, uint8_t *v_buf, int32_t w) {
+    constexpr int32_t k_pixel_per_loop = 32;
+    int32_t j = 0;
+    for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+        __m256i r, g, b, y;
+        __m512i u0, v0, u1, v1;
+        loadRgb<S>(src0 + (j * getChannel<S>()), r, g, b);
+        rgbToYuv(param, r, g, b, y, u0, v0);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(y0 + j), y);
+        loadRgb<S>(src1 + (j * getChannel<S>()), r, g, b);
+        rgbToYuv(param, r, g, b, y, u1, v1);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(y1 + j), y);
+
+        auto u = packChroma(_mm512_add_epi32(sumPair(u0), sumPair(u1)), 2);
+        auto v = packChroma(_mm512_add_epi32(sumPair(v0), sumPair(v1)), 2);
+        if constexpr (ImageFormat::I420 == D) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(u_buf + (j >> 1)), u);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(v_buf + (j >> 1)), v);
+        } else {
+            storeUv420<D>(u_buf + j, nullptr, u, v);
+            storeUv420<D>(u_buf + j + 16, nullptr, _mm_srli_si128(u, 8), _mm_srli_si128(v, 8));
+        }
+    }
+    if constexpr (ImageFormat::I420 == D) {
+        return j + rgbToYuv420RowAvx2<S, D>(param, src0 + (j * getChannel<S>()), src1 + (j * getChannel<S>()), y0 + j, y1 + j,
+                                            u_buf + (j >> 1), v_buf + (j >> 1), w - j);
+    } else {
+        return j + rgbToYuv420RowAvx2<S, D>(param, src0 + (j * getChannel<S>()), src1 + (j * getChannel<S>()), y0 + j, y1 + j,
+                                            u_buf + j, nullptr, w - j);
+    }
+}
+
+template <ImageFormat S>
+static inline void rgbToYuvPixel(const Rgb2YuvParam &param, const uint8_t *src, int32_t &y, int32_t &u, int32_t &v) {
+    int32_t r = src[isBgr<S>() ? 2 : 0];
+    int32_t g = src[1];
+    int32_t b = src[isBgr<S>() ? 0 : 2];
+    y = (r * param.m_yr + g * param.m_yg + b * param.m_yb + param.m_y_ofs) >> k_shift;
+    u = (b * param.m_ub - r * param.m_ur - g * param.m_ug) >> k_shift;
+    v = (r * param.m_vr - g * param.m_vg - b * param.m_vb) >> k_shift;
+}
+
+// Row loop shared by both tiers, `Row` converts the SIMD part of a row and
+// the scalar code finishes the remaining pairs
+template <ImageFormat S, ImageFormat D, bool Avx512>
+static void rgbToYuvX86(const Image &src, const Image &dst) {
+    constexpr auto ch = getChannel<S>();
+    auto w = src.cols();
+    auto h = src.rows();
+    const auto &param = getRgb2YuvParam(dst);
+
+    if constexpr (!isYuv420<D>()) {
+        for (int32_t i = 0; i < h; ++i) {
+            auto src_buf = src.ptr(i);
+            auto dst_buf = dst.ptr(i);
+            auto j = Avx512 ? rgbToYuv422RowAvx512<S, D>(param, src_buf, dst_buf, w) : rgbToYuv422RowAvx2<S, D>(param, src_buf, dst_buf, w);
+            for (; j + 2 <= w; j += 2) {
+                int32_t y0, u0, v0, y1, u1, v1;
+                rgbToYuvPixel<S>(param, src_buf + (j * ch), y0, u0, v0);
+                rgbToYuvPixel<S>(param, src_buf + ((j + 1) * ch), y1, u1, v1);
+                auto pair = dst_buf + (j << 1);
+                pair[ImageFormat::YUYV == D ? 0 : 1] = saturate_u8(y0);
+                pair[ImageFormat::YUYV == D ? 1 : 0] = saturate_u8(((u0 + u1) >> 1) + k_offset);
+                pair[ImageFormat::YUYV == D ? 2 : 3] = saturate_u8(y1);
+                pair[ImageFormat::YUYV == D ? 3 : 2] = saturate_u8(((v0 + v1) >> 1) + k_offset);
+            }
+        }
+        return;
+    }
+
+    for (int32_t i = 0; i < h; i += 2) {
+        auto src0 = src.ptr(i);
+        auto src1 = src.ptr(i + 1);
+        auto y0 = dst.ptr(i, 0);
+        auto y1 = dst.ptr(i + 1, 0);
+        auto u_buf = dst.ptr(i >> 1, 1);
+        auto v_buf = ImageFormat::I420 == D ? dst.ptr(i >> 1, 2) : nullptr;
+        auto j = Avx512 ? rgbToYuv420RowAvx512<S, D>(param, src0, src1, y0, y1, u_buf, v_buf, w)
+                        : rgbToYuv420RowAvx2<S, D>(param, src0, src1, y0, y1, u_buf, v_buf, w);
+        for (; j + 2 <= w; j += 2) {
+            int32_t y00, u00, v00, y01, u01, v01, y10, u10, v10, y11, u11, v11;
+            rgbToYuvPixel<S>(param, src0 + (j * ch), y00, u00, v00);
+            rgbToYuvPixel<S>(param, src0 + ((j + 1) * ch), y01, u01, v01);
+            rgbToYuvPixel<S>(param, src1 + (j * ch), y10, u10, v10);
+            rgbToYuvPixel<S>(param, src1 + ((j + 1) * ch), y11, u11, v11);
+            y0[j + 0] = y00;
+            y0[j + 1] = y01;
+            y1[j + 0] = y10;
+            y1[j + 1] = y11;
+            auto u = saturate_u8(((u00 + u01 + u10 + u11) >> 2) + k_offset);
+            auto v = saturate_u8(((v00 + v01 + v10 + v11) >> 2) + k_offset);
+            if constexpr (ImageFormat::I420 == D) {
+                u_buf[j >> 1] = u;
+                v_buf[j >> 1] = v;
+            } else {
+                u_buf[j + (ImageFormat::NV12 == D ? 0 : 1)] = u;
+                u_buf[j + (ImageFormat::NV12 == D ? 1 : 0)] = v;
+            }
+        }
+    }
+}
+
+#define RGB_TO_YUV_X86(S, D, SF, DF)                                    \
+    void S##_to_##D##_avx2(const Image &src, const Image &dst)          \
+    {                                                                   \
+        rgbToYuvX86<ImageFormat::SF, ImageFormat::DF, false>(src, dst); \
+    }                                                                   \
+    void S##_to_##D##_avx512(const Image &src, const Image &dst)        \
+    {                                                                   \
+        rgbToYuvX86<ImageFormat::SF, ImageFormat::DF, true>(src, dst);  \
+    }
+
+#define RGB_TO_YUV_X86_FROM(S, SF)              \
+    RGB_TO_YUV_X86(S, yuyv, SF, YUYV)           \
+    RGB_TO_YUV_X86(S, uyvy, SF, UYVY)           \
+    RGB_TO_YUV_X86(S, i420, SF, I420)           \
+    RGB_TO_YUV_X86(S, nv12, SF, NV12)           \
+    RGB_TO_YUV_X86(S, nv21, SF, NV21)
+
+RGB_TO_YUV_X86_FROM(rgba, RGBA)
+RGB_TO_YUV_X86_FROM(rgb, RGB)
+RGB_TO_YUV_X86_FROM(bgra, BGRA)
+RGB_TO_YUV_X86_FROM(bgr, BGR)
+
+#undef RGB_TO_YUV_X86_FROM
+#undef RGB_TO_YUV_X86
+
+NAMESPACE_END
+
+#endif
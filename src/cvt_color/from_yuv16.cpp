@@ -0,0 +1,49 @@
+#include "image.hpp"
+#include "yuv16.hpp"
+
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+template <ImageFormat S, ImageFormat D>
+static void yuv16ToRgbC(const Image &src, const Image &dst) {
+    const auto param = getYuv16ToRgbParam(src);
+    for (int32_t i = 0; i < src.rows(); ++i) {
+        yuv16ToRgbRow<S, D>(param, getYuv16Row<S>(src, i), dst.ptr(i), 0, src.cols());
+    }
+}
+
+template <ImageFormat S>
+static void yuv16ToNv12C(const Image &src, const Image &dst) {
+    for (int32_t i = 0; i < src.rows(); i += 2) {
+        yuv16ToNv12Row<S>(getYuv16Row<S>(src, i), getYuv16Row<S>(src, i + 1), dst.ptr(i, 0), dst.ptr(i + 1, 0),
+                          dst.ptr(i >> 1, 1), 0, src.cols());
+    }
+}
+
+#define YUV16_TO_RGB_C(S, D, SF, DF)                                \
+    void S##_to_##D##_c(const Image &src, const Image &dst)         \
+    {                                                               \
+        yuv16ToRgbC<ImageFormat::SF, ImageFormat::DF>(src, dst);    \
+    }
+
+#define YUV16_C_FROM(S, SF)                                         \
+    YUV16_TO_RGB_C(S, rgba, SF, RGBA)                               \
+    YUV16_TO_RGB_C(S, rgb, SF, RGB)                                 \
+    YUV16_TO_RGB_C(S, bgra, SF, BGRA)                               \
+    YUV16_TO_RGB_C(S, bgr, SF, BGR)                                 \
+    YUV16_TO_RGB_C(S, rgb48, SF, RGB48)                             \
+    void S##_to_nv12_c(const Image &src, const Image &dst)          \
+    {                                                               \
+        yuv16ToNv12C<ImageFormat::SF>(src, dst);                    \
+    }
+
+YUV16_C_FROM(p010, P010)
+YUV16_C_FROM(p016, P016)
+YUV16_C_FROM(i010, I010)
+YUV16_C_FROM(y210, Y210)
+
+#undef YUV16_C_FROM
+#undef YUV16_TO_RGB_C
+
+NAMESPACE_END
@@ -0,0 +1,186 @@
+#include "image.hpp"
+#include "types.hpp"
+#include "x86.hpp"
+#include "x86_pixel.hpp"
+#include "yuv16.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+NAMESPACE_BEGIN
+
+constexpr int32_t k_pixel_per_loop = 16;
+
+// Loads 16 msb aligned Y and the 8 U/V pairs shared by them, interleaved
+// like nv12, starting at pixel j
+template <ImageFormat S>
+AVX2_FUNC static inline void loadYuv16(const Yuv16Row &buf, int32_t j, __m256i &y, __m256i &uv) {
+    if constexpr (ImageFormat::I010 == S) {
+        auto u = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf.m_u + (j >> 1)));
+        auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf.m_v + (j >> 1)));
+        y = _mm256_slli_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(buf.m_y + j)), getSampleShift<S>());
+        uv = _mm256_slli_epi16(_mm256_set_m128i(_mm_unpackhi_epi16(u, v), _mm_unpacklo_epi16(u, v)), getSampleShift<S>());
+    } else if constexpr (isYuv16420<S>()) {
+        y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buf.m_y + j));
+        uv = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(buf.m_u + j));
+    } else {
+        // y0 u y1 v, sorted to 4 y | 2 uv per lane, then the y and uv
+        // halves of both loads are gathered
+        const __m256i split = _mm256_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15,
+                                               0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15);
+        auto base = buf.m_y + (j << 1);
+        auto s0 = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(base)), split);
+        auto s1 = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(base + 16)), split);
+        s0 = _mm256_permute4x64_epi64(s0, 0xd8);
+        s1 = _mm256_permute4x64_epi64(s1, 0xd8);
+        y = _mm256_permute2x128_si256(s0, s1, 0x20);
+        uv = _mm256_permute2x128_si256(s0, s1, 0x31);
+    }
+}
+
+// U and V of each of the 16 pixels as (C16 - 32768)
+AVX2_FUNC static inline void splitUv(__m256i uv, __m256i &u, __m256i &v) {
+    const __m256i dup_u = _mm256_setr_epi8(0, 1, 0, 1, 4, 5, 4, 5, 8, 9, 8, 9, 12, 13, 12, 13,
+                                           0, 1, 0, 1, 4, 5, 4, 5, 8, 9, 8, 9, 12, 13, 12, 13);
+    const __m256i dup_v = _mm256_setr_epi8(2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15,
+                                           2, 3, 2, 3, 6, 7, 6, 7, 10, 11, 10, 11, 14, 15, 14, 15);
+    auto ofs = _mm256_set1_epi16(static_cast<int16_t>(0x8000));
+    u = _mm256_xor_si256(_mm256_shuffle_epi8(uv, dup_u), ofs);
+    v = _mm256_xor_si256(_mm256_shuffle_epi8(uv, dup_v), ofs);
+}
+
+// Same math as yuv16ToRgbS16
+AVX2_FUNC static inline void yuvToRgb(const Yuv2RgbPreciseParam &param, __m256i y, __m256i u, __m256i v, __m256i &r, __m256i &g, __m256i &b) {
+    auto t = _mm256_mulhi_epu16(y, _mm256_set1_epi16(static_cast<int16_t>(param.m_yg)));
+    t = _mm256_add_epi16(t, _mm256_set1_epi16(param.m_base));
+
+    auto vr = _mm256_mulhrs_epi16(v, _mm256_set1_epi16(param.m_vr));
+    auto uvg = _mm256_add_epi16(_mm256_mulhrs_epi16(u, _mm256_set1_epi16(param.m_ug)),
+                                _mm256_mulhrs_epi16(v, _mm256_set1_epi16(param.m_vg)));
+    auto ub = _mm256_mulhrs_epi16(u, _mm256_set1_epi16(param.m_ub));
+    r = _mm256_adds_epi16(t, vr);
+    g = _mm256_subs_epi16(t, uvg);
+    b = _mm256_adds_epi16(t, ub);
+}
+
+AVX2_FUNC static inline __m128i packU8(__m256i val) {
+    val = _mm256_srai_epi16(val, k_precise_shift);
+    return _mm_packus_epi16(_mm256_castsi256_si128(val), _mm256_extracti128_si256(val, 1));
+}
+
+// to8Bit of 16 samples
+AVX2_FUNC static inline __m128i packTo8Bit(__m256i val) {
+    val = _mm256_srli_epi16(_mm256_adds_epu16(val, _mm256_set1_epi16(128)), 8);
+    return _mm_packus_epi16(_mm256_castsi256_si128(val), _mm256_extracti128_si256(val, 1));
+}
+
+// toRgb48 of 16 samples
+AVX2_FUNC static inline __m256i packRgb48(__m256i val) {
+    val = _mm256_subs_epi16(val, _mm256_set1_epi16(1 << (k_precise_shift - 1)));
+    val = _mm256_min_epi16(_mm256_max_epi16(val, _mm256_setzero_si256()), _mm256_set1_epi16(255 << k_precise_shift));
+    return _mm256_add_epi16(_mm256_slli_epi16(val, 2), _mm256_srli_epi16(val, k_precise_shift));
+}
+
+// Interleaves 8 r, g, b words per lane. Each output word takes the same
+// pixel from all channels, the blends keep the channel due at its place
+AVX2_FUNC static inline void storeRgb48(uint8_t *dst, __m256i r, __m256i g, __m256i b) {
+    const __m256i m0 = _mm256_setr_epi8(0, 1, 0, 1, 0, 1, 2, 3, 2, 3, 2, 3, 4, 5, 4, 5,
+                                        0, 1, 0, 1, 0, 1, 2, 3, 2, 3, 2, 3, 4, 5, 4, 5);
+    const __m256i m1 = _mm256_setr_epi8(4, 5, 6, 7, 6, 7, 6, 7, 8, 9, 8, 9, 8, 9, 10, 11,
+                                        4, 5, 6, 7, 6, 7, 6, 7, 8, 9, 8, 9, 8, 9, 10, 11);
+    const __m256i m2 = _mm256_setr_epi8(10, 11, 10, 11, 12, 13, 12, 13, 12, 13, 14, 15, 14, 15, 14, 15,
+                                        10, 11, 10, 11, 12, 13, 12, 13, 12, 13, 14, 15, 14, 15, 14, 15);
+    // r g b r g b r g | b r g b r g b r | g b r g b r g b
+    auto o0 = _mm256_blend_epi16(_mm256_blend_epi16(_mm256_shuffle_epi8(r, m0), _mm256_shuffle_epi8(g, m0), 0x92),
+                                 _mm256_shuffle_epi8(b, m0), 0x24);
+    auto o1 = _mm256_blend_epi16(_mm256_blend_epi16(_mm256_shuffle_epi8(r, m1), _mm256_shuffle_epi8(g, m1), 0x24),
+                                 _mm256_shuffle_epi8(b, m1), 0x49);
+    auto o2 = _mm256_blend_epi16(_mm256_blend_epi16(_mm256_shuffle_epi8(r, m2), _mm256_shuffle_epi8(g, m2), 0x49),
+                                 _mm256_shuffle_epi8(b, m2), 0x92);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst), _mm256_permute2x128_si256(o0, o1, 0x20));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 32), _mm256_permute2x128_si256(o2, o0, 0x30));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + 64), _mm256_permute2x128_si256(o1, o2, 0x31));
+}
+
+template <ImageFormat S, ImageFormat D>
+AVX2_FUNC static void yuv16ToRgbAvx2(const Image &src, const Image &dst) {
+    auto w = src.cols();
+    auto h = src.rows();
+    constexpr auto size = getPixelSize16<D>();
+    const auto param = getYuv16ToRgbParam(src);
+    for (int32_t i = 0; i < h; ++i) {
+        auto buf = getYuv16Row<S>(src, i);
+        auto dst_buf = dst.ptr(i);
+        int32_t j = 0;
+        for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+            __m256i y, uv, u, v, r, g, b;
+            loadYuv16<S>(buf, j, y, uv);
+            splitUv(uv, u, v);
+            yuvToRgb(param, y, u, v, r, g, b);
+            if constexpr (ImageFormat::RGB48 == D) {
+                storeRgb48(dst_buf + (j * size), packRgb48(r), packRgb48(g), packRgb48(b));
+            } else if constexpr (isBgr<D>()) {
+                storeRgb<D>(dst_buf + (j * size), packU8(b), packU8(g), packU8(r));
+            } else {
+                storeRgb<D>(dst_buf + (j * size), packU8(r), packU8(g), packU8(b));
+            }
+        }
+        yuv16ToRgbRow<S, D>(param, buf, dst_buf, j, w);
+    }
+}
+
+template <ImageFormat S>
+AVX2_FUNC static void yuv16ToNv12Avx2(const Image &src, const Image &dst) {
+    auto w = src.cols();
+    auto h = src.rows();
+    for (int32_t i = 0; i < h; i += 2) {
+        auto buf0 = getYuv16Row<S>(src, i);
+        auto buf1 = getYuv16Row<S>(src, i + 1);
+        auto y0 = dst.ptr(i, 0);
+        auto y1 = dst.ptr(i + 1, 0);
+        auto uv_buf = dst.ptr(i >> 1, 1);
+        int32_t j = 0;
+        for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+            __m256i y, uv, uv1;
+            loadYuv16<S>(buf0, j, y, uv);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(y0 + j), packTo8Bit(y));
+            loadYuv16<S>(buf1, j, y, uv1);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(y1 + j), packTo8Bit(y));
+            if constexpr (!isYuv16420<S>()) {
+                uv = _mm256_avg_epu16(uv, uv1);
+            }
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(uv_buf + j), packTo8Bit(uv));
+        }
+        yuv16ToNv12Row<S>(buf0, buf1, y0, y1, uv_buf, j, w);
+    }
+}
+
+#define YUV16_TO_RGB_AVX2(S, D, SF, DF)                                 \
+    void S##_to_##D##_avx2(const Image &src, const Image &dst)          \
+    {                                                                   \
+        yuv16ToRgbAvx2<ImageFormat::SF, ImageFormat::DF>(src, dst);     \
+    }
+
+#define YUV16_AVX2_FROM(S, SF)                                          \
+    YUV16_TO_RGB_AVX2(S, rgba, SF, RGBA)                                \
+    YUV16_TO_RGB_AVX2(S, rgb, SF, RGB)                                  \
+    YUV16_TO_RGB_AVX2(S, bgra, SF, BGRA)                                \
+    YUV16_TO_RGB_AVX2(S, bgr, SF, BGR)                                  \
+    YUV16_TO_RGB_AVX2(S, rgb48, SF, RGB48)                              \
+    void S##_to_nv12_avx2(const Image &src, const Image &dst)           \
+    {                                                                   \
+        yuv16ToNv12Avx2<ImageFormat::SF>(src, dst);                     \
+    }
+
+YUV16_AVX2_FROM(p010, P010)
+YUV16_AVX2_FROM(p016, P016)
+YUV16_AVX2_FROM(i010, I010)
+YUV16_AVX2_FROM(y210, Y210)
+
+#undef YUV16_AVX2_FROM
+#undef YUV16_TO_RGB_AVX2
+
+NAMESPACE_END
+
+#endif
@@ -0,0 +1,105 @@
+#include "image.hpp"
+#include "types.hpp"
+#include "x86.hpp"
+#include "x86_pixel.hpp"
+#include "yuv.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+NAMESPACE_BEGIN
+
+constexpr int32_t k_pixel_per_loop = 16;
+
+AVX2_FUNC static inline __m128i packU8(__m256i val) {
+    val = _mm256_srai_epi16(val, k_shift);
+    return _mm_packus_epi16(_mm256_castsi256_si128(val), _mm256_extracti128_si256(val, 1));
+}
+
+// Same fixed point math as the _c kernels
+AVX2_FUNC static inline void yuvToRgb(const Yuv2RgbParam &param, __m128i y, __m128i u, __m128i v, __m128i &r, __m128i &g, __m128i &b) {
+    auto y16 = _mm256_mullo_epi16(_mm256_cvtepu8_epi16(y), _mm256_set1_epi16(param.m_yg));
+    auto u16 = _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(u, u));
+    auto v16 = _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(v, v));
+
+    auto vr = _mm256_sub_epi16(_mm256_mullo_epi16(v16, _mm256_set1_epi16(param.m_vr)), _mm256_set1_epi16(static_cast<int16_t>(param.m_ofs_r)));
+    auto uvg = _mm256_sub_epi16(_mm256_set1_epi16(static_cast<int16_t>(param.m_ofs_g)),
+                                _mm256_add_epi16(_mm256_mullo_epi16(u16, _mm256_set1_epi16(param.m_ug)),
+                                                 _mm256_mullo_epi16(v16, _mm256_set1_epi16(param.m_vg))));
+    auto ub = _mm256_sub_epi16(_mm256_mullo_epi16(u16, _mm256_set1_epi16(param.m_ub)), _mm256_set1_epi16(static_cast<int16_t>(param.m_ofs_b)));
+
+    // The limited range gain can push the sums past int16, saturate them
+    r = packU8(_mm256_adds_epi16(y16, vr));
+    g = packU8(_mm256_adds_epi16(y16, uvg));
+    b = packU8(_mm256_adds_epi16(y16, ub));
+}
+
+template <ImageFormat D>
+static inline void storePixel(const Yuv2RgbParam &param, uint8_t *dst, int32_t y, int32_t u, int32_t v) {
+    y *= param.m_yg;
+    auto r = saturate_u8((y + param.m_vr * v - param.m_ofs_r) >> k_shift);
+    auto g = saturate_u8((y - param.m_ug * u - param.m_vg * v + param.m_ofs_g) >> k_shift);
+    auto b = saturate_u8((y + param.m_ub * u - param.m_ofs_b) >> k_shift);
+    dst[0] = isBgr<D>() ? b : r;
+    dst[1] = g;
+    dst[2] = isBgr<D>() ? r : b;
+    if constexpr (4 == getChannel<D>()) {
+        dst[3] = k_alpha;
+    }
+}
+
+template <ImageFormat S, ImageFormat D>
+AVX2_FUNC static void yuvToRgbAvx2(const Image &src, const Image &dst) {
+    auto w = src.cols();
+    auto h = src.rows();
+    constexpr auto ch = getChannel<D>();
+    // A local copy cannot alias the rows, so the coefficients stay in registers
+    const auto param = getYuv2RgbParam(src);
+    for (int32_t i = 0; i < h; ++i) {
+        auto buf = getYuvRow<S>(src, i);
+        auto dst_buf = dst.ptr(i);
+        int32_t j = 0;
+        for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+            __m128i y, u, v, r, g, b;
+            loadYuv<S>(buf, j, y, u, v);
+            yuvToRgb(param, y, u, v, r, g, b);
+            if constexpr (isBgr<D>()) {
+                storeRgb<D>(dst_buf + (j * ch), b, g, r);
+            } else {
+                storeRgb<D>(dst_buf + (j * ch), r, g, b);
+            }
+        }
+        for (; j + 2 <= w; j += 2) {
+            int32_t y0, y1, u, v;
+            loadPair<S>(buf, j, y0, y1, u, v);
+            storePixel<D>(param, dst_buf + (j * ch), y0, u, v);
+            storePixel<D>(param, dst_buf + ((j + 1) * ch), y1, u, v);
+        }
+    }
+}
+
+#define YUV_TO_RGB_AVX2(S, D, SF, DF)                               \
+    void S##_to_##D##_avx2(const Image &src, const Image &dst)      \
+    {                                                               \
+        yuvToRgbAvx2<ImageFormat::SF, ImageFormat::DF>(src, dst);   \
+    }
+
+#define YUV_TO_RGB_AVX2_FROM(S, SF)             \
+    YUV_TO_RGB_AVX2(S, rgba, SF, RGBA)          \
+    YUV_TO_RGB_AVX2(S, rgb, SF, RGB)            \
+    YUV_TO_RGB_AVX2(S, bgra, SF, BGRA)          \
+    YUV_TO_RGB_AVX2(S, bgr, SF, BGR)
+
+YUV_TO_RGB_AVX2_FROM(yuyv, YUYV)
+YUV_TO_RGB_AVX2_FROM(uyvy, UYVY)
+YUV_TO_RGB_AVX2_FROM(i420, I420)
+YUV_TO_RGB_AVX2_FROM(nv12, NV12)
+YUV_TO_RGB_AVX2_FROM(nv21, NV21)
+
+#undef YUV_TO_RGB_AVX2_FROM
+#undef YUV_TO_RGB_AVX2
+
+NAMESPACE_END
+
+#endif
@@ -0,0 +1,41 @@
+#pragma once
+
+#include "image.hpp"
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+// Kernels of the named conversions of cvt_color.hpp, F##_c the scalar one
+// and F##_neon the aarch64 one. They do not validate their arguments,
+// dispatch binds them after checkCvtColor
+#define ADD_IMG_CONVERT_KERNEL(F)               \
+    void F##_c(const Image&, const Image&);     \
+    void F##_neon(const Image&, const Image&)
+
+#define ADD_IMG_CONVERT_KERNEL_FROM(S)          \
+    ADD_IMG_CONVERT_KERNEL(S##_to_gray);        \
+    ADD_IMG_CONVERT_KERNEL(S##_to_rgba);        \
+    ADD_IMG_CONVERT_KERNEL(S##_to_rgb);         \
+    ADD_IMG_CONVERT_KERNEL(S##_to_bgra);        \
+    ADD_IMG_CONVERT_KERNEL(S##_to_bgr);         \
+    ADD_IMG_CONVERT_KERNEL(S##_to_yuyv);        \
+    ADD_IMG_CONVERT_KERNEL(S##_to_uyvy);        \
+    ADD_IMG_CONVERT_KERNEL(S##_to_i420);        \
+    ADD_IMG_CONVERT_KERNEL(S##_to_nv12);        \
+    ADD_IMG_CONVERT_KERNEL(S##_to_nv21)
+
+ADD_IMG_CONVERT_KERNEL_FROM(gray);
+ADD_IMG_CONVERT_KERNEL_FROM(rgba);
+ADD_IMG_CONVERT_KERNEL_FROM(rgb);
+ADD_IMG_CONVERT_KERNEL_FROM(bgra);
+ADD_IMG_CONVERT_KERNEL_FROM(bgr);
+ADD_IMG_CONVERT_KERNEL_FROM(yuyv);
+ADD_IMG_CONVERT_KERNEL_FROM(uyvy);
+ADD_IMG_CONVERT_KERNEL_FROM(i420);
+ADD_IMG_CONVERT_KERNEL_FROM(nv12);
+ADD_IMG_CONVERT_KERNEL_FROM(nv21);
+
+#undef ADD_IMG_CONVERT_KERNEL_FROM
+#undef ADD_IMG_CONVERT_KERNEL
+
+NAMESPACE_END
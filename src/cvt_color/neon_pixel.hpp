@@ -0,0 +1,95 @@
+#pragma once
+
+#include "pixel.hpp"
+#include "types.hpp"
+
+#ifdef __aarch64__
+
+#include <arm_neon.h>
+
+NAMESPACE_BEGIN
+
+// 16 pixel loads and stores shared by the NEON kernels
+
+// Loads 16 Y and the 8 U/V samples shared by them, starting at pixel j
+template <ImageFormat S>
+inline void loadYuv(const YuvRow &buf, int32_t j, uint8x16_t &y, uint8x8_t &u, uint8x8_t &v) {
+    if constexpr (isSemiPlanar<S>()) {
+        y = vld1q_u8(buf.m_y + j);
+        auto uv = vld2_u8(buf.m_u + j);
+        u = uv.val[isVFirst<S>() ? 1 : 0];
+        v = uv.val[isVFirst<S>() ? 0 : 1];
+    } else if constexpr (!isPacked422<S>()) {
+        y = vld1q_u8(buf.m_y + j);
+        u = vld1_u8(buf.m_u + (j >> 1));
+        v = vld1_u8(buf.m_v + (j >> 1));
+    } else {
+        // yuyv: y0 u y1 v, uyvy: u y0 v y1
+        auto pair = vld2q_u8(buf.m_y + (j << 1));
+        y = pair.val[ImageFormat::YUYV == S ? 0 : 1];
+        auto uv = pair.val[ImageFormat::YUYV == S ? 1 : 0];
+        auto split = vuzp_u8(vget_low_u8(uv), vget_high_u8(uv));
+        u = split.val[0];
+        v = split.val[1];
+    }
+}
+
+// Stores 16 pixels in the channel order of D, alpha is opaque
+template <ImageFormat D>
+inline void storeRgb(uint8_t *dst, uint8x16_t r, uint8x16_t g, uint8x16_t b) {
+    auto c0 = isBgr<D>() ? b : r;
+    auto c2 = isBgr<D>() ? r : b;
+    if constexpr (4 == getChannel<D>()) {
+        vst4q_u8(dst, uint8x16x4_t{{c0, g, c2, vdupq_n_u8(255)}});
+    } else {
+        vst3q_u8(dst, uint8x16x3_t{{c0, g, c2}});
+    }
+}
+
+// Loads 16 pixels and splits them into r, g and b
+template <ImageFormat S>
+inline void loadRgb(const uint8_t *src, uint8x16_t &r, uint8x16_t &g, uint8x16_t &b) {
+    uint8x16_t c0, c2;
+    if constexpr (4 == getChannel<S>()) {
+        auto p = vld4q_u8(src);
+        c0 = p.val[0];
+        g = p.val[1];
+        c2 = p.val[2];
+    } else {
+        auto p = vld3q_u8(src);
+        c0 = p.val[0];
+        g = p.val[1];
+        c2 = p.val[2];
+    }
+    r = isBgr<S>() ? c2 : c0;
+    b = isBgr<S>() ? c0 : c2;
+}
+
+// Stores 16 y with the 8 u/v of their pairs as yuyv or uyvy
+template <ImageFormat D>
+inline void storeYuv422(uint8_t *dst, uint8x16_t y, uint8x8_t u, uint8x8_t v) {
+    auto zip = vzip_u8(u, v);
+    auto uv = vcombine_u8(zip.val[0], zip.val[1]);
+    if constexpr (ImageFormat::YUYV == D) {
+        vst2q_u8(dst, uint8x16x2_t{{y, uv}});
+    } else {
+        vst2q_u8(dst, uint8x16x2_t{{uv, y}});
+    }
+}
+
+// Stores 8 u/v to the chroma row(s) of i420, nv12 or nv21
+template <ImageFormat D>
+inline void storeUv420(uint8_t *u_buf, uint8_t *v_buf, uint8x8_t u, uint8x8_t v) {
+    if constexpr (ImageFormat::I420 == D) {
+        vst1_u8(u_buf, u);
+        vst1_u8(v_buf, v);
+    } else if constexpr (ImageFormat::NV12 == D) {
+        vst2_u8(u_buf, uint8x8x2_t{{u, v}});
+    } else {
+        vst2_u8(u_buf, uint8x8x2_t{{v, u}});
+    }
+}
+
+NAMESPACE_END
+
+#endif
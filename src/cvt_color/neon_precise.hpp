@@ -0,0 +1,102 @@
+#pragma once
+
+#include "pixel.hpp"
+#include "precise.hpp"
+#include "types.hpp"
+
+#ifdef __aarch64__
+
+#include <arm_neon.h>
+
+NAMESPACE_BEGIN
+
+// 16 pixel CvtPrecision::HIGH math shared by the NEON kernels. 16 bit lanes
+// hold 8 pixels, so the values per pixel come in low and high halves.
+// sqrdmulh only differs from pmulhrs for -32768 * -32768, which the
+// coefficients and inputs never reach
+
+inline uint8x16_t packPreciseU8(int16x8_t lo, int16x8_t hi) {
+    return vcombine_u8(vqshrun_n_s16(lo, k_precise_shift), vqshrun_n_s16(hi, k_precise_shift));
+}
+
+// (C - 128) << 8 of 8 chroma samples, each repeated for its pixel pair
+inline int16x8x2_t loadChroma(uint8x8_t c) {
+    auto c16 = vshlq_n_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(c)), vdupq_n_s16(k_chroma_ofs)), 8);
+    return int16x8x2_t{{vzip1q_s16(c16, c16), vzip2q_s16(c16, c16)}};
+}
+
+// Same math as yuvToRgbPreciseS16 for 8 pixels
+inline void yuvToRgb(const Yuv2RgbPreciseParam &param, uint8x8_t y, int16x8_t u16, int16x8_t v16,
+                     int16x8_t &r, int16x8_t &g, int16x8_t &b) {
+    auto y16 = vmovl_u8(y);
+    y16 = vorrq_u16(y16, vshlq_n_u16(y16, 8));
+    auto yg = vdupq_n_u16(param.m_yg);
+    auto t = vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(y16), vget_low_u16(yg)), 16),
+                          vshrn_n_u32(vmull_high_u16(y16, yg), 16));
+    auto t16 = vaddq_s16(vreinterpretq_s16_u16(t), vdupq_n_s16(param.m_base));
+
+    auto vr = vqrdmulhq_n_s16(v16, param.m_vr);
+    auto uvg = vaddq_s16(vqrdmulhq_n_s16(u16, param.m_ug), vqrdmulhq_n_s16(v16, param.m_vg));
+    auto ub = vqrdmulhq_n_s16(u16, param.m_ub);
+    r = vqaddq_s16(t16, vr);
+    g = vqsubq_s16(t16, uvg);
+    b = vqaddq_s16(t16, ub);
+}
+
+// 16 pixels, chroma of each pixel in the halves of u16/v16
+inline void yuvToRgb(const Yuv2RgbPreciseParam &param, uint8x16_t y, int16x8x2_t u16, int16x8x2_t v16,
+                     uint8x16_t &r, uint8x16_t &g, uint8x16_t &b) {
+    int16x8_t r0, g0, b0, r1, g1, b1;
+    yuvToRgb(param, vget_low_u8(y), u16.val[0], v16.val[0], r0, g0, b0);
+    yuvToRgb(param, vget_high_u8(y), u16.val[1], v16.val[1], r1, g1, b1);
+    r = packPreciseU8(r0, r1);
+    g = packPreciseU8(g0, g1);
+    b = packPreciseU8(b0, b1);
+}
+
+// Same math as rgbToYuvPrecise for 8 pixels, y still << k_precise_shift
+inline void rgbToYuv(const Rgb2YuvPreciseParam &param, uint8x8_t r, uint8x8_t g, uint8x8_t b,
+                     int16x8_t &y, int16x8_t &u, int16x8_t &v) {
+    auto r16 = vreinterpretq_s16_u16(vshll_n_u8(r, 7));
+    auto g16 = vreinterpretq_s16_u16(vshll_n_u8(g, 7));
+    auto b16 = vreinterpretq_s16_u16(vshll_n_u8(b, 7));
+
+    y = vaddq_s16(vaddq_s16(vqrdmulhq_n_s16(r16, param.m_yr), vqrdmulhq_n_s16(g16, param.m_yg)),
+                  vqrdmulhq_n_s16(b16, param.m_yb));
+    y = vaddq_s16(y, vdupq_n_s16(param.m_y_ofs));
+    u = vsubq_s16(vqrdmulhq_n_s16(b16, param.m_ub),
+                  vaddq_s16(vqrdmulhq_n_s16(r16, param.m_ur), vqrdmulhq_n_s16(g16, param.m_ug)));
+    v = vsubq_s16(vqrdmulhq_n_s16(r16, param.m_vr),
+                  vaddq_s16(vqrdmulhq_n_s16(g16, param.m_vg), vqrdmulhq_n_s16(b16, param.m_vb)));
+}
+
+// 16 pixels, y packed to u8 and u/v as int16 halves
+inline void rgbToYuv(const Rgb2YuvPreciseParam &param, uint8x16_t r, uint8x16_t g, uint8x16_t b,
+                     uint8x16_t &y, int16x8x2_t &u, int16x8x2_t &v) {
+    int16x8_t y0, y1;
+    rgbToYuv(param, vget_low_u8(r), vget_low_u8(g), vget_low_u8(b), y0, u.val[0], v.val[0]);
+    rgbToYuv(param, vget_high_u8(r), vget_high_u8(g), vget_high_u8(b), y1, u.val[1], v.val[1]);
+    y = packPreciseU8(y0, y1);
+}
+
+// Sum of each horizontal pair as int32
+inline int32x4x2_t sumPair(int16x8x2_t val) {
+    return int32x4x2_t{{vpaddlq_s16(val.val[0]), vpaddlq_s16(val.val[1])}};
+}
+
+inline int32x4x2_t addSum(int32x4x2_t a, int32x4x2_t b) {
+    return int32x4x2_t{{vaddq_s32(a.val[0], b.val[0]), vaddq_s32(a.val[1], b.val[1])}};
+}
+
+// packChromaPrecise of 8 int32 sums
+template <int32_t Shift>
+inline uint8x8_t packChroma(int32x4x2_t sum) {
+    auto ofs = vdupq_n_s32(k_chroma_ofs);
+    auto lo = vaddq_s32(vrshrq_n_s32(sum.val[0], Shift), ofs);
+    auto hi = vaddq_s32(vrshrq_n_s32(sum.val[1], Shift), ofs);
+    return vqmovun_s16(vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+}
+
+NAMESPACE_END
+
+#endif
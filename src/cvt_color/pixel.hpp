@@ -0,0 +1,101 @@
+#pragma once
+
+#include "image.hpp"
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+// Compile time format traits shared by the templated kernels
+template <ImageFormat F>
+constexpr bool isYuv420() {
+    return ImageFormat::I420 == F || ImageFormat::NV12 == F || ImageFormat::NV21 == F || ImageFormat::YV12 == F;
+}
+
+template <ImageFormat F>
+constexpr bool isSemiPlanar() {
+    return ImageFormat::NV12 == F || ImageFormat::NV21 == F || ImageFormat::NV16 == F || ImageFormat::NV24 == F;
+}
+
+// V plane or byte before the U one
+template <ImageFormat F>
+constexpr bool isVFirst() {
+    return ImageFormat::NV21 == F || ImageFormat::YV12 == F;
+}
+
+template <ImageFormat F>
+constexpr bool isPacked422() {
+    return ImageFormat::YUYV == F || ImageFormat::UYVY == F;
+}
+
+template <ImageFormat F>
+constexpr bool isBgr() {
+    return ImageFormat::BGRA == F || ImageFormat::BGR == F;
+}
+
+template <ImageFormat F>
+constexpr int32_t getChannel() {
+    return ImageFormat::RGBA == F || ImageFormat::BGRA == F ? 4 : 3;
+}
+
+// Rows feeding one output row of a layout with chroma pairs: y | u | v
+// for i420, yv12 and i422, y | uv for nv12, nv21 and nv16 and only the
+// packed row in y for yuyv/uyvy
+struct YuvRow {
+    const uint8_t *m_y{nullptr};
+    const uint8_t *m_u{nullptr};
+    const uint8_t *m_v{nullptr};
+};
+
+template <ImageFormat S>
+inline YuvRow getYuvRow(const Image &src, int32_t row) {
+    auto c = isYuv420<S>() ? row >> 1 : row;
+    if constexpr (isPacked422<S>()) {
+        return {src.ptr(row), nullptr, nullptr};
+    } else if constexpr (isSemiPlanar<S>()) {
+        return {src.ptr(row, 0), src.ptr(c, 1), nullptr};
+    } else {
+        return {src.ptr(row, 0), src.ptr(c, isVFirst<S>() ? 2 : 1), src.ptr(c, isVFirst<S>() ? 1 : 2)};
+    }
+}
+
+// Y of pixel j and U/V of the pair starting at even pixel j
+template <ImageFormat S>
+inline void loadPair(const YuvRow &buf, int32_t j, int32_t &y0, int32_t &y1, int32_t &u, int32_t &v) {
+    if constexpr (isSemiPlanar<S>()) {
+        y0 = buf.m_y[j];
+        y1 = buf.m_y[j + 1];
+        u = buf.m_u[isVFirst<S>() ? j + 1 : j];
+        v = buf.m_u[isVFirst<S>() ? j : j + 1];
+    } else if constexpr (!isPacked422<S>()) {
+        y0 = buf.m_y[j];
+        y1 = buf.m_y[j + 1];
+        u = buf.m_u[j >> 1];
+        v = buf.m_v[j >> 1];
+    } else {
+        auto pair = buf.m_y + (j << 1);
+        y0 = pair[ImageFormat::YUYV == S ? 0 : 1];
+        u = pair[ImageFormat::YUYV == S ? 1 : 0];
+        y1 = pair[ImageFormat::YUYV == S ? 2 : 3];
+        v = pair[ImageFormat::YUYV == S ? 3 : 2];
+    }
+}
+
+// Stores one pixel, alpha is opaque
+template <ImageFormat D>
+inline void storeRgbPixel(uint8_t *dst, uint8_t r, uint8_t g, uint8_t b) {
+    dst[0] = isBgr<D>() ? b : r;
+    dst[1] = g;
+    dst[2] = isBgr<D>() ? r : b;
+    if constexpr (4 == getChannel<D>()) {
+        dst[3] = 255;
+    }
+}
+
+template <ImageFormat S>
+inline void loadRgbPixel(const uint8_t *src, int32_t &r, int32_t &g, int32_t &b) {
+    r = src[isBgr<S>() ? 2 : 0];
+    g = src[1];
+    b = src[isBgr<S>() ? 0 : 2];
+}
+
+NAMESPACE_END
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include "image.hpp"
+#include "planar.hpp"
+
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+template <ImageFormat S, ImageFormat D>
+static void planarToRgbC(const Image &src, const Image &dst) {
+    const auto &param = getYuv2RgbPreciseParam(src);
+    for (int32_t i = 0; i < src.rows(); ++i) {
+        planarToRgbRow<S, D>(param, getPlanarRow<S>(src, i), dst.ptr(i), 0, src.cols());
+    }
+}
+
+template <ImageFormat S, ImageFormat D>
+static void rgbToPlanarC(const Image &src, const Image &dst) {
+    const auto &param = getRgb2YuvPreciseParam(dst);
+    constexpr auto sy = getChromaShiftY<D>();
+    for (int32_t i = 0; i < src.rows(); i += 1 << sy) {
+        rgbToPlanarRow<S, D>(param, src.ptr(i), src.ptr(i + sy), getPlanarRow<D>(dst, i), getPlanarRow<D>(dst, i + sy), 0, src.cols());
+    }
+}
+
+template <ImageFormat S, ImageFormat D>
+static void planarToPlanarC(const Image &src, const Image &dst) {
+    auto w = src.cols();
+    auto h = src.rows();
+    for (int32_t i = 0; i < h; ++i) {
+        std::copy_n(src.ptr(i, 0), w, dst.ptr(i, 0));
+    }
+    // src1 is the next row when chroma rows are averaged, src0 otherwise
+    constexpr auto sy = getChromaShiftY<D>();
+    for (int32_t i = 0; i < h; i += 1 << sy) {
+        resampleChromaRow<S, D>(getPlanarRow<S>(src, i), getPlanarRow<S>(src, i + sy), getPlanarRow<D>(dst, i), 0,
+                                w >> getChromaShiftX<D>());
+    }
+}
+
+#define CVT_PLANAR_C(S, D, SF, DF, F)                               \
+    void S##_to_##D##_c(const Image &src, const Image &dst)         \
+    {                                                               \
+        F<ImageFormat::SF, ImageFormat::DF>(src, dst);              \
+    }
+
+#define CVT_PLANAR_C_WITH(X, SF)                                    \
+    CVT_PLANAR_C(X, rgba, SF, RGBA, planarToRgbC)                   \
+    CVT_PLANAR_C(X, rgb, SF, RGB, planarToRgbC)                     \
+    CVT_PLANAR_C(X, bgra, SF, BGRA, planarToRgbC)                   \
+    CVT_PLANAR_C(X, bgr, SF, BGR, planarToRgbC)                     \
+    CVT_PLANAR_C(X, nv12, SF, NV12, planarToPlanarC)                \
+    CVT_PLANAR_C(X, i420, SF, I420, planarToPlanarC)                \
+    CVT_PLANAR_C(rgba, X, RGBA, SF, rgbToPlanarC)                   \
+    CVT_PLANAR_C(rgb, X, RGB, SF, rgbToPlanarC)                     \
+    CVT_PLANAR_C(bgra, X, BGRA, SF, rgbToPlanarC)                   \
+    CVT_PLANAR_C(bgr, X, BGR, SF, rgbToPlanarC)                     \
+    CVT_PLANAR_C(nv12, X, NV12, SF, planarToPlanarC)                \
+    CVT_PLANAR_C(i420, X, I420, SF, planarToPlanarC)
+
+CVT_PLANAR_C_WITH(nv16, NV16)
+CVT_PLANAR_C_WITH(nv24, NV24)
+CVT_PLANAR_C_WITH(i422, I422)
+CVT_PLANAR_C_WITH(i444, I444)
+CVT_PLANAR_C_WITH(yv12, YV12)
+
+#undef CVT_PLANAR_C_WITH
+#undef CVT_PLANAR_C
+
+NAMESPACE_END
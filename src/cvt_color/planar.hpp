@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include "image.hpp"
+#include "pixel.hpp"
+#include "precise.hpp"
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+// Kernels of the planar (i420, yv12, i422, i444) and semi planar (nv12,
+// nv16, nv24) layouts that have no hand written ones. They are generic
+// over the chroma subsampling and use the CvtPrecision::HIGH arithmetic
+// with NEAREST chroma. The _c kernels are bit exact to the SIMD ones.
+
+// log2 of the luma pixels per chroma sample along x and y
+template <ImageFormat F>
+constexpr int32_t getChromaShiftX() {
+    return ImageFormat::I444 == F || ImageFormat::NV24 == F ? 0 : 1;
+}
+
+template <ImageFormat F>
+constexpr int32_t getChromaShiftY() {
+    return ImageFormat::I420 == F || ImageFormat::YV12 == F || ImageFormat::NV12 == F || ImageFormat::NV21 == F ? 1 : 0;
+}
+
+// Bytes between two chroma samples of a row
+template <ImageFormat F>
+constexpr int32_t getChromaStep() {
+    return isSemiPlanar<F>() ? 2 : 1;
+}
+
+// Luma row with its chroma row, chroma sample k at m_u[k * step] and
+// m_v[k * step]
+struct PlanarRow {
+    uint8_t *m_y{nullptr};
+    uint8_t *m_u{nullptr};
+    uint8_t *m_v{nullptr};
+};
+
+template <ImageFormat F>
+inline PlanarRow getPlanarRow(const Image &img, int32_t row) {
+    auto c = row >> getChromaShiftY<F>();
+    uint8_t *u, *v;
+    if constexpr (isSemiPlanar<F>()) {
+        u = img.ptr(c, 1);
+        v = u + 1;
+    } else {
+        u = img.ptr(c, 1);
+        v = img.ptr(c, 2);
+    }
+    return isVFirst<F>() ? PlanarRow{img.ptr(row, 0), v, u} : PlanarRow{img.ptr(row, 0), u, v};
+}
+
+// Converts a row from pixel j on, j is a multiple of the subsampling
+template <ImageFormat S, ImageFormat D>
+inline void planarToRgbRow(const Yuv2RgbPreciseParam &param, const PlanarRow &buf, uint8_t *dst, int32_t j, int32_t w) {
+    constexpr auto ch = getChannel<D>();
+    for (; j < w; ++j) {
+        auto k = (j >> getChromaShiftX<S>()) * getChromaStep<S>();
+        yuvToRgbPrecise<D>(param, dst + (j * ch), buf.m_y[j], buf.m_u[k], buf.m_v[k]);
+    }
+}
+
+// Converts rgb rows src0 and, for 4:2:0, src1 into the rows of buf0 and
+// buf1 from pixel j on. Chroma is the rounded mean over its pixels
+template <ImageFormat S, ImageFormat D>
+inline void rgbToPlanarRow(const Rgb2YuvPreciseParam &param, const uint8_t *src0, const uint8_t *src1,
+                           const PlanarRow &buf0, const PlanarRow &buf1, int32_t j, int32_t w) {
+    constexpr auto ch = getChannel<S>();
+    constexpr auto sx = getChromaShiftX<D>();
+    constexpr auto sy = getChromaShiftY<D>();
+    for (; j + (1 << sx) <= w; j += 1 << sx) {
+        int32_t u = 0, v = 0;
+        for (auto x = j; x < j + (1 << sx); ++x) {
+            int32_t pu, pv;
+            rgbToYuvPrecise<S>(param, src0 + (x * ch), buf0.m_y[x], pu, pv);
+            u += pu;
+            v += pv;
+            if constexpr (1 == sy) {
+                rgbToYuvPrecise<S>(param, src1 + (x * ch), buf1.m_y[x], pu, pv);
+                u += pu;
+                v += pv;
+            }
+        }
+        auto k = (j >> sx) * getChromaStep<D>();
+        buf0.m_u[k] = packChromaPrecise(u, k_precise_shift + sx + sy);
+        buf0.m_v[k] = packChromaPrecise(v, k_precise_shift + sx + sy);
+    }
+}
+
+// Rounded mean of `1 << shift` samples
+constexpr uint8_t meanOf(int32_t sum, int32_t shift) {
+    return static_cast<uint8_t>(0 == shift ? sum : (sum + (1 << (shift - 1))) >> shift);
+}
+
+// Resamples the chroma of a dst row from chroma sample k on. Finer chroma
+// is averaged, coarser is repeated. src1 is the next source row when dst
+// has half as many chroma rows, src0 otherwise
+template <ImageFormat S, ImageFormat D>
+inline void resampleChromaRow(const PlanarRow &src0, const PlanarRow &src1, const PlanarRow &dst, int32_t k, int32_t n) {
+    constexpr auto down_x = getChromaShiftX<D>() > getChromaShiftX<S>();
+    constexpr auto down_y = getChromaShiftY<D>() > getChromaShiftY<S>();
+    constexpr auto ss = getChromaStep<S>();
+    constexpr auto ds = getChromaStep<D>();
+    auto sum = [](const uint8_t *c, int32_t x) {
+        return down_x ? c[x * ss] + c[(x + 1) * ss] : c[(x >> getChromaShiftX<S>()) * ss];
+    };
+    for (; k < n; ++k) {
+        // Luma column of the sample
+        auto x = k << getChromaShiftX<D>();
+        auto u = sum(src0.m_u, x);
+        auto v = sum(src0.m_v, x);
+        if constexpr (down_y) {
+            u += sum(src1.m_u, x);
+            v += sum(src1.m_v, x);
+        }
+        dst.m_u[k * ds] = meanOf(u, down_x + down_y);
+        dst.m_v[k * ds] = meanOf(v, down_x + down_y);
+    }
+}
+
+#define ADD_IMG_CONVERT_PLANAR(F)               \
+    void F##_c(const Image&, const Image&);     \
+    void F##_avx2(const Image&, const Image&)
+
+#define ADD_IMG_CONVERT_PLANAR_FROM(S)          \
+    ADD_IMG_CONVERT_PLANAR(S##_to_rgba);        \
+    ADD_IMG_CONVERT_PLANAR(S##_to_rgb);         \
+    ADD_IMG_CONVERT_PLANAR(S##_to_bgra);        \
+    ADD_IMG_CONVERT_PLANAR(S##_to_bgr);         \
+    ADD_IMG_CONVERT_PLANAR(S##_to_nv12);        \
+    ADD_IMG_CONVERT_PLANAR(S##_to_i420)
+
+#define ADD_IMG_CONVERT_PLANAR_TO(D)            \
+    ADD_IMG_CONVERT_PLANAR(rgba_to_##D);        \
+    ADD_IMG_CONVERT_PLANAR(rgb_to_##D);         \
+    ADD_IMG_CONVERT_PLANAR(bgra_to_##D);        \
+    ADD_IMG_CONVERT_PLANAR(bgr_to_##D);         \
+    ADD_IMG_CONVERT_PLANAR(nv12_to_##D);        \
+    ADD_IMG_CONVERT_PLANAR(i420_to_##D)
+
+ADD_IMG_CONVERT_PLANAR_FROM(nv16);
+ADD_IMG_CONVERT_PLANAR_FROM(nv24);
+ADD_IMG_CONVERT_PLANAR_FROM(i422);
+ADD_IMG_CONVERT_PLANAR_FROM(i444);
+ADD_IMG_CONVERT_PLANAR_FROM(yv12);
+ADD_IMG_CONVERT_PLANAR_TO(nv16);
+ADD_IMG_CONVERT_PLANAR_TO(nv24);
+ADD_IMG_CONVERT_PLANAR_TO(i422);
+ADD_IMG_CONVERT_PLANAR_TO(i444);
+ADD_IMG_CONVERT_PLANAR_TO(yv12);
+
+#undef ADD_IMG_CONVERT_PLANAR_TO
+#undef ADD_IMG_CONVERT_PLANAR_FROM
+
+NAMESPACE_END
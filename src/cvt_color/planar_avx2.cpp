@@ -0,0 +1,255 @@
+#include <algorithm>
+#include "image.hpp"
+#include "planar.hpp"
+#include "types.hpp"
+#include "x86.hpp"
+#include "x86_pixel.hpp"
+#include "x86_precise.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+NAMESPACE_BEGIN
+
+constexpr int32_t k_pixel_per_loop = 16;
+
+// Start of the interleaved chroma of a semi planar row
+template <ImageFormat F>
+static inline uint8_t *getUvBase(const PlanarRow &buf) {
+    return isVFirst<F>() ? buf.m_v : buf.m_u;
+}
+
+// 8 u and v samples from sample k, in the low 8 bytes
+template <ImageFormat F>
+AVX2_FUNC static inline void loadSamples8(const PlanarRow &buf, int32_t k, __m128i &u, __m128i &v) {
+    if constexpr (isSemiPlanar<F>()) {
+        const __m128i split = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+        auto uv = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(getUvBase<F>(buf) + (k << 1))), split);
+        u = isVFirst<F>() ? _mm_srli_si128(uv, 8) : uv;
+        v = isVFirst<F>() ? uv : _mm_srli_si128(uv, 8);
+    } else {
+        u = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(buf.m_u + k));
+        v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(buf.m_v + k));
+    }
+}
+
+// 16 u and v samples from sample k
+template <ImageFormat F>
+AVX2_FUNC static inline void loadSamples16(const PlanarRow &buf, int32_t k, __m128i &u, __m128i &v) {
+    if constexpr (isSemiPlanar<F>()) {
+        const __m256i split = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
+                                               0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+        auto uv = _mm256_shuffle_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(getUvBase<F>(buf) + (k << 1))), split);
+        // even bytes | odd bytes
+        uv = _mm256_permute4x64_epi64(uv, 0xd8);
+        auto even = _mm256_castsi256_si128(uv);
+        auto odd = _mm256_extracti128_si256(uv, 1);
+        u = isVFirst<F>() ? odd : even;
+        v = isVFirst<F>() ? even : odd;
+    } else {
+        u = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf.m_u + k));
+        v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf.m_v + k));
+    }
+}
+
+// Stores the low 8 u and v samples at sample k
+template <ImageFormat F>
+AVX2_FUNC static inline void storeSamples8(const PlanarRow &buf, int32_t k, __m128i u, __m128i v) {
+    if constexpr (isSemiPlanar<F>()) {
+        auto uv = isVFirst<F>() ? _mm_unpacklo_epi8(v, u) : _mm_unpacklo_epi8(u, v);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(getUvBase<F>(buf) + (k << 1)), uv);
+    } else {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(buf.m_u + k), u);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(buf.m_v + k), v);
+    }
+}
+
+template <ImageFormat F>
+AVX2_FUNC static inline void storeSamples16(const PlanarRow &buf, int32_t k, __m128i u, __m128i v) {
+    if constexpr (isSemiPlanar<F>()) {
+        auto first = isVFirst<F>() ? v : u;
+        auto second = isVFirst<F>() ? u : v;
+        auto base = getUvBase<F>(buf) + (k << 1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(base), _mm_unpacklo_epi8(first, second));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(base + 16), _mm_unpackhi_epi8(first, second));
+    } else {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(buf.m_u + k), u);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(buf.m_v + k), v);
+    }
+}
+
+// (C - 128) << 8 of 16 chroma samples, one per pixel
+AVX2_FUNC static inline __m256i loadChroma444(__m128i c) {
+    c = _mm_xor_si128(c, _mm_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_slli_epi16(_mm256_cvtepu8_epi16(c), 8);
+}
+
+// packChromaPrecise of 16 unsummed int16 chroma values
+AVX2_FUNC static inline __m128i packChroma444(__m256i val) {
+    constexpr auto ofs = (1 << (k_precise_shift - 1)) + (k_chroma_ofs << k_precise_shift);
+    val = _mm256_srai_epi16(_mm256_add_epi16(val, _mm256_set1_epi16(ofs)), k_precise_shift);
+    return _mm_packus_epi16(_mm256_castsi256_si128(val), _mm256_extracti128_si256(val, 1));
+}
+
+template <ImageFormat S, ImageFormat D>
+AVX2_FUNC static void planarToRgbAvx2(const Image &src, const Image &dst) {
+    auto w = src.cols();
+    auto h = src.rows();
+    constexpr auto ch = getChannel<D>();
+    const auto param = getYuv2RgbPreciseParam(src);
+    for (int32_t i = 0; i < h; ++i) {
+        auto buf = getPlanarRow<S>(src, i);
+        auto dst_buf = dst.ptr(i);
+        int32_t j = 0;
+        for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+            __m128i u, v, r, g, b;
+            auto y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf.m_y + j));
+            if constexpr (0 == getChromaShiftX<S>()) {
+                loadSamples16<S>(buf, j, u, v);
+                yuvToRgb(param, y, loadChroma444(u), loadChroma444(v), r, g, b);
+            } else {
+                loadSamples8<S>(buf, j >> 1, u, v);
+                yuvToRgb(param, y, loadChroma(u), loadChroma(v), r, g, b);
+            }
+            storeRgbOrdered<D>(dst_buf + (j * ch), r, g, b);
+        }
+        planarToRgbRow<S, D>(param, buf, dst_buf, j, w);
+    }
+}
+
+template <ImageFormat S, ImageFormat D>
+AVX2_FUNC static void rgbToPlanarAvx2(const Image &src, const Image &dst) {
+    auto w = src.cols();
+    auto h = src.rows();
+    constexpr auto ch = getChannel<S>();
+    constexpr auto sx = getChromaShiftX<D>();
+    constexpr auto sy = getChromaShiftY<D>();
+    const auto param = getRgb2YuvPreciseParam(dst);
+    for (int32_t i = 0; i < h; i += 1 << sy) {
+        auto src0 = src.ptr(i);
+        auto src1 = src.ptr(i + sy);
+        auto buf0 = getPlanarRow<D>(dst, i);
+        auto buf1 = getPlanarRow<D>(dst, i + sy);
+        int32_t j = 0;
+        for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+            __m128i r, g, b, y;
+            __m256i u, v;
+            loadRgb<S>(src0 + (j * ch), r, g, b);
+            rgbToYuv(param, r, g, b, y, u, v);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(buf0.m_y + j), y);
+            if constexpr (0 == sx) {
+                storeSamples16<D>(buf0, j, packChroma444(u), packChroma444(v));
+            } else {
+                auto sum_u = sumPair(u);
+                auto sum_v = sumPair(v);
+                if constexpr (1 == sy) {
+                    loadRgb<S>(src1 + (j * ch), r, g, b);
+                    rgbToYuv(param, r, g, b, y, u, v);
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(buf1.m_y + j), y);
+                    sum_u = _mm256_add_epi32(sum_u, sumPair(u));
+                    sum_v = _mm256_add_epi32(sum_v, sumPair(v));
+                }
+                storeSamples8<D>(buf0, j >> 1, packChroma(sum_u, k_precise_shift + 1 + sy),
+                                 packChroma(sum_v, k_precise_shift + 1 + sy));
+            }
+        }
+        rgbToPlanarRow<S, D>(param, src0, src1, buf0, buf1, j, w);
+    }
+}
+
+// Chroma of the 16 dst samples from sample k as int16 sums over the
+// source samples of one row, see resampleChromaRow
+template <ImageFormat S, ImageFormat D>
+AVX2_FUNC static inline void loadResampled(const PlanarRow &buf, int32_t k, __m256i &u, __m256i &v) {
+    __m128i u0, v0;
+    if constexpr (getChromaShiftX<D>() > getChromaShiftX<S>()) {
+        __m128i u1, v1;
+        loadSamples16<S>(buf, k << 1, u0, v0);
+        loadSamples16<S>(buf, (k << 1) + 16, u1, v1);
+        u = _mm256_maddubs_epi16(_mm256_set_m128i(u1, u0), _mm256_set1_epi8(1));
+        v = _mm256_maddubs_epi16(_mm256_set_m128i(v1, v0), _mm256_set1_epi8(1));
+    } else if constexpr (getChromaShiftX<D>() < getChromaShiftX<S>()) {
+        loadSamples8<S>(buf, k >> 1, u0, v0);
+        u = _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(u0, u0));
+        v = _mm256_cvtepu8_epi16(_mm_unpacklo_epi8(v0, v0));
+    } else {
+        loadSamples16<S>(buf, k, u0, v0);
+        u = _mm256_cvtepu8_epi16(u0);
+        v = _mm256_cvtepu8_epi16(v0);
+    }
+}
+
+// meanOf of 16 int16 sums
+template <int32_t shift>
+AVX2_FUNC static inline __m128i packMean(__m256i sum) {
+    if constexpr (0 != shift) {
+        sum = _mm256_srli_epi16(_mm256_add_epi16(sum, _mm256_set1_epi16(1 << (shift - 1))), shift);
+    }
+    return _mm_packus_epi16(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+}
+
+template <ImageFormat S, ImageFormat D>
+AVX2_FUNC static void planarToPlanarAvx2(const Image &src, const Image &dst) {
+    auto w = src.cols();
+    auto h = src.rows();
+    for (int32_t i = 0; i < h; ++i) {
+        std::copy_n(src.ptr(i, 0), w, dst.ptr(i, 0));
+    }
+
+    constexpr auto down_y = getChromaShiftY<D>() > getChromaShiftY<S>();
+    constexpr auto shift = static_cast<int32_t>(getChromaShiftX<D>() > getChromaShiftX<S>()) + down_y;
+    constexpr auto sy = getChromaShiftY<D>();
+    auto n = w >> getChromaShiftX<D>();
+    for (int32_t i = 0; i < h; i += 1 << sy) {
+        auto src0 = getPlanarRow<S>(src, i);
+        auto src1 = getPlanarRow<S>(src, i + sy);
+        auto dst_buf = getPlanarRow<D>(dst, i);
+        int32_t k = 0;
+        for (; k + k_pixel_per_loop <= n; k += k_pixel_per_loop) {
+            __m256i u, v;
+            loadResampled<S, D>(src0, k, u, v);
+            if constexpr (down_y) {
+                __m256i u1, v1;
+                loadResampled<S, D>(src1, k, u1, v1);
+                u = _mm256_add_epi16(u, u1);
+                v = _mm256_add_epi16(v, v1);
+            }
+            storeSamples16<D>(dst_buf, k, packMean<shift>(u), packMean<shift>(v));
+        }
+        resampleChromaRow<S, D>(src0, src1, dst_buf, k, n);
+    }
+}
+
+#define CVT_PLANAR_AVX2(S, D, SF, DF, F)                            \
+    void S##_to_##D##_avx2(const Image &src, const Image &dst)      \
+    {                                                               \
+        F<ImageFormat::SF, ImageFormat::DF>(src, dst);              \
+    }
+
+#define CVT_PLANAR_AVX2_WITH(X, SF)                                 \
+    CVT_PLANAR_AVX2(X, rgba, SF, RGBA, planarToRgbAvx2)             \
+    CVT_PLANAR_AVX2(X, rgb, SF, RGB, planarToRgbAvx2)               \
+    CVT_PLANAR_AVX2(X, bgra, SF, BGRA, planarToRgbAvx2)             \
+    CVT_PLANAR_AVX2(X, bgr, SF, BGR, planarToRgbAvx2)               \
+    CVT_PLANAR_AVX2(X, nv12, SF, NV12, planarToPlanarAvx2)          \
+    CVT_PLANAR_AVX2(X, i420, SF, I420, planarToPlanarAvx2)          \
+    CVT_PLANAR_AVX2(rgba, X, RGBA, SF, rgbToPlanarAvx2)             \
+    CVT_PLANAR_AVX2(rgb, X, RGB, SF, rgbToPlanarAvx2)               \
+    CVT_PLANAR_AVX2(bgra, X, BGRA, SF, rgbToPlanarAvx2)             \
+    CVT_PLANAR_AVX2(bgr, X, BGR, SF, rgbToPlanarAvx2)               \
+    CVT_PLANAR_AVX2(nv12, X, NV12, SF, planarToPlanarAvx2)          \
+    CVT_PLANAR_AVX2(i420, X, I420, SF, planarToPlanarAvx2)
+
+CVT_PLANAR_AVX2_WITH(nv16, NV16)
+CVT_PLANAR_AVX2_WITH(nv24, NV24)
+CVT_PLANAR_AVX2_WITH(i422, I422)
+CVT_PLANAR_AVX2_WITH(i444, I444)
+CVT_PLANAR_AVX2_WITH(yv12, YV12)
+
+#undef CVT_PLANAR_AVX2_WITH
+#undef CVT_PLANAR_AVX2
+
+NAMESPACE_END
+
+#endif
@@ -0,0 +1,270 @@
+#include <cmath>
+#include <stdexcept>
+#include "cvt_color.hpp"
+#include "image.hpp"
+#include "precise.hpp"
+
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+template <ImageFormat S, ImageFormat D>
+static void yuvToRgbPreciseC(const Image &src, const Image &dst) {
+    const auto &param = getYuv2RgbPreciseParam(src);
+    for (int32_t i = 0; i < src.rows(); ++i) {
+        yuvToRgbRowPrecise<S, D>(param, getYuvRow<S>(src, i), dst.ptr(i), 0, src.cols());
+    }
+}
+
+template <ImageFormat S, ImageFormat D>
+static void rgbToYuvPreciseC(const Image &src, const Image &dst) {
+    const auto &param = getRgb2YuvPreciseParam(dst);
+    if constexpr (!isYuv420<D>()) {
+        for (int32_t i = 0; i < src.rows(); ++i) {
+            rgbToYuv422RowPrecise<S, D>(param, src.ptr(i), dst.ptr(i), 0, src.cols());
+        }
+    } else {
+        for (int32_t i = 0; i < src.rows(); i += 2) {
+            rgbToYuv420RowPrecise<S, D>(param, src.ptr(i), src.ptr(i + 1), dst.ptr(i, 0), dst.ptr(i + 1, 0),
+                                        dst.ptr(i >> 1, 1), ImageFormat::I420 == D ? dst.ptr(i >> 1, 2) : nullptr, 0, src.cols());
+        }
+    }
+}
+
+template <ImageFormat S, ImageFormat D, ChromaSiting C>
+static void yuvToRgbBilinearC(const Image &src, const Image &dst, int32_t row, int32_t rows) {
+    const auto &param = getYuv2RgbPreciseParam(src);
+    for (int32_t i = row; i < row + rows; ++i) {
+        auto near = getYuvRow<S>(src, getNearChromaRow<S>(i, src.rows()));
+        yuvToRgbRowBilinear<S, D, C>(param, getYuvRow<S>(src, i), near, dst.ptr(i), 0, src.cols(), src.cols());
+    }
+}
+
+template <ImageFormat S, ImageFormat D>
+static void yuvToRgbBilinearC(const Image &src, const Image &dst, int32_t row, int32_t rows) {
+    if (ChromaSiting::CENTER == src.chromaSiting()) {
+        yuvToRgbBilinearC<S, D, ChromaSiting::CENTER>(src, dst, row, rows);
+    } else {
+        yuvToRgbBilinearC<S, D, ChromaSiting::LEFT>(src, dst, row, rows);
+    }
+}
+
+#define CVT_PRECISE_C(S, D, SF, DF, F)                              \
+    void S##_to_##D##_precise_c(const Image &src, const Image &dst) \
+    {                                                               \
+        F<ImageFormat::SF, ImageFormat::DF>(src, dst);              \
+    }
+
+#define CVT_BILINEAR_C(S, D, SF, DF)                                                            \
+    void S##_to_##D##_bilinear_c(const Image &src, const Image &dst, int32_t row, int32_t rows) \
+    {                                                                                           \
+        yuvToRgbBilinearC<ImageFormat::SF, ImageFormat::DF>(src, dst, row, rows);               \
+    }
+
+#define YUV_TO_RGB_BILINEAR_C(S, SF)                                \
+    CVT_BILINEAR_C(S, rgba, SF, RGBA)                               \
+    CVT_BILINEAR_C(S, rgb, SF, RGB)                                 \
+    CVT_BILINEAR_C(S, bgra, SF, BGRA)                               \
+    CVT_BILINEAR_C(S, bgr, SF, BGR)
+
+#define YUV_TO_RGB_PRECISE_C(S, SF)                                 \
+    CVT_PRECISE_C(S, rgba, SF, RGBA, yuvToRgbPreciseC)              \
+    CVT_PRECISE_C(S, rgb, SF, RGB, yuvToRgbPreciseC)                \
+    CVT_PRECISE_C(S, bgra, SF, BGRA, yuvToRgbPreciseC)              \
+    CVT_PRECISE_C(S, bgr, SF, BGR, yuvToRgbPreciseC)                \
+    YUV_TO_RGB_BILINEAR_C(S, SF)
+
+#define RGB_TO_YUV_PRECISE_C(S, SF)                                 \
+    CVT_PRECISE_C(S, yuyv, SF, YUYV, rgbToYuvPreciseC)              \
+    CVT_PRECISE_C(S, uyvy, SF, UYVY, rgbToYuvPreciseC)              \
+    CVT_PRECISE_C(S, i420, SF, I420, rgbToYuvPreciseC)              \
+    CVT_PRECISE_C(S, nv12, SF, NV12, rgbToYuvPreciseC)              \
+    CVT_PRECISE_C(S, nv21, SF, NV21, rgbToYuvPreciseC)
+
+YUV_TO_RGB_PRECISE_C(yuyv, YUYV)
+YUV_TO_RGB_PRECISE_C(uyvy, UYVY)
+YUV_TO_RGB_PRECISE_C(i420, I420)
+YUV_TO_RGB_PRECISE_C(nv12, NV12)
+YUV_TO_RGB_PRECISE_C(nv21, NV21)
+YUV_TO_RGB_BILINEAR_C(yv12, YV12)
+YUV_TO_RGB_BILINEAR_C(i422, I422)
+YUV_TO_RGB_BILINEAR_C(nv16, NV16)
+
+RGB_TO_YUV_PRECISE_C(rgba, RGBA)
+RGB_TO_YUV_PRECISE_C(rgb, RGB)
+RGB_TO_YUV_PRECISE_C(bgra, BGRA)
+RGB_TO_YUV_PRECISE_C(bgr, BGR)
+
+#undef RGB_TO_YUV_PRECISE_C
+#undef YUV_TO_RGB_PRECISE_C
+#undef YUV_TO_RGB_BILINEAR_C
+#undef CVT_BILINEAR_C
+#undef CVT_PRECISE_C
+
+// Reference conversion in double, pixels are addressed at run time
+
+static bool isRgbFormat(ImageFormat fmt) {
+    return ImageFormat::RGBA == fmt || ImageFormat::RGB == fmt || ImageFormat::BGRA == fmt || ImageFormat::BGR == fmt;
+}
+
+static bool isYuvFormat(ImageFormat fmt) {
+    return ImageFormat::YUYV == fmt || ImageFormat::UYVY == fmt || ImageFormat::I420 == fmt ||
+           ImageFormat::NV12 == fmt || ImageFormat::NV21 == fmt || ImageFormat::NV16 == fmt ||
+           ImageFormat::NV24 == fmt || ImageFormat::I422 == fmt || ImageFormat::I444 == fmt ||
+           ImageFormat::YV12 == fmt;
+}
+
+// log2 of the pixels per chroma sample across and down
+static int32_t getChromaShiftX(ImageFormat fmt) {
+    return ImageFormat::NV24 == fmt || ImageFormat::I444 == fmt ? 0 : 1;
+}
+
+static int32_t getChromaShiftY(ImageFormat fmt) {
+    return ImageFormat::I420 == fmt || ImageFormat::NV12 == fmt || ImageFormat::NV21 == fmt ||
+                   ImageFormat::YV12 == fmt
+               ? 1
+               : 0;
+}
+
+// Address of channel c (0 = r, 1 = g, 2 = b) of pixel (row, col)
+static uint8_t *rgbAt(const Image &img, int32_t row, int32_t col, int32_t c) {
+    auto bgr = ImageFormat::BGRA == img.fmt() || ImageFormat::BGR == img.fmt();
+    auto ch = ImageFormat::RGBA == img.fmt() || ImageFormat::BGRA == img.fmt() ? 4 : 3;
+    return img.ptr(row) + (col * ch) + (bgr ? 2 - c : c);
+}
+
+// Address of plane c (0 = y, 1 = u, 2 = v) of pixel (row, col), chroma is
+// shared by the block of the pixel
+static uint8_t *yuvAt(const Image &img, int32_t row, int32_t col, int32_t c) {
+    auto fmt = img.fmt();
+    if (ImageFormat::YUYV == fmt || ImageFormat::UYVY == fmt) {
+        auto pair = img.ptr(row) + ((col & ~1) << 1);
+        auto y_first = ImageFormat::YUYV == fmt ? 0 : 1;
+        if (0 == c) {
+            return pair + (col & 1) * 2 + y_first;
+        }
+        return pair + (1 - y_first) + (1 == c ? 0 : 2);
+    }
+    if (0 == c) {
+        return img.ptr(row, 0) + col;
+    }
+    auto chroma_row = row >> getChromaShiftY(fmt);
+    auto k = col >> getChromaShiftX(fmt);
+    if (ImageFormat::I420 == fmt || ImageFormat::I422 == fmt || ImageFormat::I444 == fmt) {
+        return img.ptr(chroma_row, c) + k;
+    }
+    if (ImageFormat::YV12 == fmt) {
+        return img.ptr(chroma_row, 3 - c) + k;
+    }
+    auto u_first = ImageFormat::NV21 == fmt ? 2 : 1;
+    return img.ptr(chroma_row, 1) + (k << 1) + (u_first == c ? 0 : 1);
+}
+
+// Chroma c of pixel (row, col) interpolated as ChromaFilter::BILINEAR
+static double getBilinearChroma(const Image &img, int32_t row, int32_t col, int32_t c) {
+    auto sx = getChromaShiftX(img.fmt());
+    auto sy = getChromaShiftY(img.fmt());
+    auto last_k = (img.cols() >> sx) - 1;
+    auto last_m = (img.rows() >> sy) - 1;
+    auto sample = [&](int32_t m, int32_t k) -> double {
+        m = std::min(std::max(m, 0), last_m);
+        k = std::min(std::max(k, 0), last_k);
+        return *yuvAt(img, m << sy, k << sx, c);
+    };
+
+    double x = col;
+    if (0 != sx) {
+        x = ChromaSiting::LEFT == img.chromaSiting() ? col / 2.0 : (col - 0.5) / 2;
+    }
+    auto y = 0 != sy ? (row - 0.5) / 2 : row;
+    auto k = static_cast<int32_t>(std::floor(x));
+    auto m = static_cast<int32_t>(std::floor(y));
+    auto fx = x - k;
+    auto fy = y - m;
+    return (1 - fy) * ((1 - fx) * sample(m, k) + fx * sample(m, k + 1)) +
+           fy * ((1 - fx) * sample(m + 1, k) + fx * sample(m + 1, k + 1));
+}
+
+struct FloatMatrix {
+    double m_kr;
+    double m_kg;
+    double m_kb;
+    double m_ys;        // luma gain of the range
+    double m_cs;        // chroma gain of the range
+    double m_y_ofs;
+};
+
+static FloatMatrix getFloatMatrix(const Image &yuv) {
+    const auto &weight = k_luma_weight[getValueOf(yuv.colorMatrix())];
+    auto limited = ColorRange::LIMITED == yuv.colorRange();
+    return {weight.m_kr, 1 - weight.m_kr - weight.m_kb, weight.m_kb,
+            limited ? 219.0 / 255 : 1.0, limited ? 224.0 / 255 : 1.0, limited ? 16.0 : 0.0};
+}
+
+static double roundSample(double value) {
+    return std::round(std::min(std::max(value, 0.0), 255.0));
+}
+
+CvtError measureCvtError(const Image &src, const Image &dst, const CvtOption &option) {
+    checkCvtColor(src, dst);
+    auto to_rgb = isYuvFormat(src.fmt()) && isRgbFormat(dst.fmt());
+    if (!to_rgb && !(isRgbFormat(src.fmt()) && isYuvFormat(dst.fmt()))) {
+        throw std::invalid_argument("Only yuv <-> rgb conversions can be measured");
+    }
+
+    auto m = getFloatMatrix(to_rgb ? src : dst);
+    double sum = 0;
+    size_t count = 0;
+    CvtError error;
+    auto add = [&](double ref, uint8_t val) {
+        auto diff = std::abs(roundSample(ref) - val);
+        error.m_max = std::max(error.m_max, diff);
+        sum += diff;
+        ++count;
+    };
+
+    auto h = src.rows();
+    auto w = src.cols();
+    auto bilinear = ChromaFilter::BILINEAR == option.m_chroma_filter;
+    if (to_rgb) {
+        for (int32_t i = 0; i < h; ++i) {
+            for (int32_t j = 0; j < w; ++j) {
+                auto y = (*yuvAt(src, i, j, 0) - m.m_y_ofs) / m.m_ys;
+                auto u = (bilinear ? getBilinearChroma(src, i, j, 1) : *yuvAt(src, i, j, 1)) - 128.0;
+                auto v = (bilinear ? getBilinearChroma(src, i, j, 2) : *yuvAt(src, i, j, 2)) - 128.0;
+                u /= m.m_cs;
+                v /= m.m_cs;
+                add(y + 2 * (1 - m.m_kr) * v, *rgbAt(dst, i, j, 0));
+                add(y - (2 * (1 - m.m_kb) * m.m_kb * u + 2 * (1 - m.m_kr) * m.m_kr * v) / m.m_kg, *rgbAt(dst, i, j, 1));
+                add(y + 2 * (1 - m.m_kb) * u, *rgbAt(dst, i, j, 2));
+            }
+        }
+    } else {
+        // Chroma is the mean over the pixels sharing it
+        auto block_w = 1 << getChromaShiftX(dst.fmt());
+        auto block_h = 1 << getChromaShiftY(dst.fmt());
+        for (int32_t i = 0; i < h; i += block_h) {
+            for (int32_t j = 0; j < w; j += block_w) {
+                double u = 0;
+                double v = 0;
+                for (int32_t bi = i; bi < i + block_h; ++bi) {
+                    for (int32_t bj = j; bj < j + block_w; ++bj) {
+                        double r = *rgbAt(src, bi, bj, 0);
+                        double g = *rgbAt(src, bi, bj, 1);
+                        double b = *rgbAt(src, bi, bj, 2);
+                        auto y = m.m_kr * r + m.m_kg * g + m.m_kb * b;
+                        add(m.m_y_ofs + m.m_ys * y, *yuvAt(dst, bi, bj, 0));
+                        u += (b - y) / (2 * (1 - m.m_kb));
+                        v += (r - y) / (2 * (1 - m.m_kr));
+                    }
+                }
+                add(128 + m.m_cs * u / (block_w * block_h), *yuvAt(dst, i, j, 1));
+                add(128 + m.m_cs * v / (block_w * block_h), *yuvAt(dst, i, j, 2));
+            }
+        }
+    }
+    error.m_mean = sum / count;
+    return error;
+}
+
+NAMESPACE_END
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <algorithm>
+#include "colorimetry.hpp"
+#include "image.hpp"
+#include "pixel.hpp"
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+// CvtPrecision::HIGH kernels. Coefficients carry 13 or 14 fraction bits and
+// are applied with a rounding multiply high of 16 bit lanes (pmulhrsw on
+// x86, sqrdmulh on neon), sums keep k_precise_shift fraction bits until
+// the final rounding. The _c kernels are bit exact to the SIMD ones.
+constexpr int32_t k_precise_shift = 6;
+constexpr int32_t k_chroma_ofs = 128;
+
+// (x * c + 0x4000) >> 15, the same as _mm_mulhrs_epi16
+constexpr int32_t mulhrs(int32_t x, int32_t c) {
+    return (x * c + 0x4000) >> 15;
+}
+
+constexpr int32_t saturate_s16(int32_t value) {
+    return value < -32768 ? -32768 : (value > 32767 ? 32767 : value);
+}
+
+constexpr int16_t roundToS16(double value) {
+    return static_cast<int16_t>(value < 0 ? value - 0.5 : value + 0.5);
+}
+
+struct Yuv2RgbPreciseParam {
+    uint16_t m_yg;      // (Y * 257 * m_yg) >> 16 is the luma gain << k_precise_shift
+    int16_t m_base;     // rounding minus the luma foot, << k_precise_shift
+    int16_t m_vr;       // +, << 13
+    int16_t m_ug;       // -
+    int16_t m_vg;       // -
+    int16_t m_ub;       // +
+};
+
+// Chroma enters as (C - 128) << 8, so mulhrs by a << 13 coefficient leaves
+// k_precise_shift fraction bits
+constexpr Yuv2RgbPreciseParam makeYuv2RgbPreciseParam(double kr, double kb, ColorRange range) {
+    constexpr double scale = 1 << 13;
+    auto limited = ColorRange::LIMITED == range;
+    auto ys = limited ? 255.0 / 219 : 1.0;
+    auto cs = limited ? 255.0 / 224 : 1.0;
+    auto kg = 1 - kr - kb;
+
+    return {
+        static_cast<uint16_t>(ys * (1 << k_precise_shift) * 65536 / 257 + 0.5),
+        static_cast<int16_t>((1 << (k_precise_shift - 1)) - roundToS16((limited ? 16 : 0) * ys * (1 << k_precise_shift))),
+        roundToS16(2 * (1 - kr) * cs * scale),
+        roundToS16(2 * (1 - kb) * kb / kg * cs * scale),
+        roundToS16(2 * (1 - kr) * kr / kg * cs * scale),
+        roundToS16(2 * (1 - kb) * cs * scale)
+    };
+}
+
+struct Rgb2YuvPreciseParam {
+    int16_t m_yr;       // +, << 14
+    int16_t m_yg;       // +
+    int16_t m_yb;       // +
+    int16_t m_y_ofs;    // rounding plus the luma foot, << k_precise_shift
+    int16_t m_ur;       // -
+    int16_t m_ug;       // -
+    int16_t m_ub;       // +
+    int16_t m_vr;       // +
+    int16_t m_vg;       // -
+    int16_t m_vb;       // -
+};
+
+// Rgb enters as X << 7, so mulhrs by a << 14 coefficient leaves
+// k_precise_shift fraction bits. Balanced like makeRgb2YuvParam.
+constexpr Rgb2YuvPreciseParam makeRgb2YuvPreciseParam(double kr, double kb, ColorRange range) {
+    constexpr double scale = 1 << 14;
+    auto limited = ColorRange::LIMITED == range;
+    auto ys = limited ? 219.0 / 255 : 1.0;
+    auto cs = limited ? 224.0 / 255 : 1.0;
+
+    auto yr = roundToS16(kr * ys * scale);
+    auto yb = roundToS16(kb * ys * scale);
+    auto half = roundToS16(0.5 * cs * scale);
+    auto ur = roundToS16(kr / (2 * (1 - kb)) * cs * scale);
+    auto vb = roundToS16(kb / (2 * (1 - kr)) * cs * scale);
+    return {
+        yr, static_cast<int16_t>(roundToS16(ys * scale) - yr - yb), yb,
+        static_cast<int16_t>((1 << (k_precise_shift - 1)) + ((limited ? 16 : 0) << k_precise_shift)),
+        ur, static_cast<int16_t>(half - ur), half,
+        half, static_cast<int16_t>(half - vb), vb
+    };
+}
+
+static constexpr auto k_yuv_2_rgb_precise_param = makeColorSpaceTable<Yuv2RgbPreciseParam>(makeYuv2RgbPreciseParam);
+static constexpr auto k_rgb_2_yuv_precise_param = makeColorSpaceTable<Rgb2YuvPreciseParam>(makeRgb2YuvPreciseParam);
+
+inline const Yuv2RgbPreciseParam &getYuv2RgbPreciseParam(const Image &img) {
+    return k_yuv_2_rgb_precise_param[getColorSpaceIdx(img)];
+}
+
+inline const Rgb2YuvPreciseParam &getRgb2YuvPreciseParam(const Image &img) {
+    return k_rgb_2_yuv_precise_param[getColorSpaceIdx(img)];
+}
+
+// u and v are (C - 128) << 8, interpolated chroma fills the low bits
+template <ImageFormat D>
+inline void yuvToRgbPreciseS16(const Yuv2RgbPreciseParam &param, uint8_t *dst, int32_t y, int32_t u, int32_t v) {
+    auto t = static_cast<int32_t>((static_cast<uint32_t>(y * 257) * param.m_yg) >> 16) + param.m_base;
+    auto r = saturate_s16(t + mulhrs(v, param.m_vr));
+    auto g = saturate_s16(t - (mulhrs(u, param.m_ug) + mulhrs(v, param.m_vg)));
+    auto b = saturate_s16(t + mulhrs(u, param.m_ub));
+    storeRgbPixel<D>(dst, saturate_u8(r >> k_precise_shift), saturate_u8(g >> k_precise_shift), saturate_u8(b >> k_precise_shift));
+}
+
+template <ImageFormat D>
+inline void yuvToRgbPrecise(const Yuv2RgbPreciseParam &param, uint8_t *dst, int32_t y, int32_t u, int32_t v) {
+    yuvToRgbPreciseS16<D>(param, dst, y, (u - k_chroma_ofs) * 256, (v - k_chroma_ofs) * 256);
+}
+
+// Converts the pairs of a row from pixel j on
+template <ImageFormat S, ImageFormat D>
+inline void yuvToRgbRowPrecise(const Yuv2RgbPreciseParam &param, const YuvRow &buf, uint8_t *dst, int32_t j, int32_t w) {
+    constexpr auto ch = getChannel<D>();
+    for (; j + 2 <= w; j += 2) {
+        int32_t y0, y1, u, v;
+        loadPair<S>(buf, j, y0, y1, u, v);
+        yuvToRgbPrecise<D>(param, dst + (j * ch), y0, u, v);
+        yuvToRgbPrecise<D>(param, dst + ((j + 1) * ch), y1, u, v);
+    }
+}
+
+// Bilinear chroma: 4:2:0 chroma row m lies between rows 2m and 2m + 1, so
+// row 2m blends 3/4 of it with 1/4 of row m - 1 and row 2m + 1 with row
+// m + 1. Horizontally LEFT sited samples hit the even pixels and the odd
+// ones take the mean of both sides, CENTER sited ones weight 3/4 : 1/4
+// like the rows. Samples past the frame edge repeat the last one.
+
+// Luma row whose chroma row is blended into row i of a frame of h rows
+template <ImageFormat S>
+inline int32_t getNearChromaRow(int32_t i, int32_t h) {
+    if constexpr (isYuv420<S>()) {
+        return 0 != (i & 1) ? std::min(i + 1, h - 1) : std::max(i - 2, 0);
+    } else {
+        return i;
+    }
+}
+
+// Chroma sample k blended with the near row, in 1/4 steps
+template <ImageFormat S>
+inline void loadUvBlend(const YuvRow &buf, const YuvRow &near, int32_t k, int32_t &u, int32_t &v) {
+    int32_t y0, y1;
+    loadPair<S>(buf, k << 1, y0, y1, u, v);
+    if constexpr (isYuv420<S>()) {
+        int32_t near_u, near_v;
+        loadPair<S>(near, k << 1, y0, y1, near_u, near_v);
+        u = 3 * u + near_u;
+        v = 3 * v + near_v;
+    } else {
+        u <<= 2;
+        v <<= 2;
+    }
+}
+
+// 1/16 steps to (C - 128) << 8
+constexpr int32_t getChromaS16(int32_t c) {
+    return (c - (k_chroma_ofs << 4)) * 16;
+}
+
+// Converts the pairs [j, end) of a row w pixels wide
+template <ImageFormat S, ImageFormat D, ChromaSiting C>
+inline void yuvToRgbRowBilinear(const Yuv2RgbPreciseParam &param, const YuvRow &buf, const YuvRow &near, uint8_t *dst,
+                                int32_t j, int32_t end, int32_t w) {
+    constexpr auto ch = getChannel<D>();
+    auto last = (w >> 1) - 1;
+    for (; j + 2 <= end; j += 2) {
+        auto k = j >> 1;
+        int32_t y0, y1, u, v, next_u, next_v, even_u, even_v, odd_u, odd_v;
+        loadPair<S>(buf, j, y0, y1, u, v);
+        loadUvBlend<S>(buf, near, k, u, v);
+        loadUvBlend<S>(buf, near, std::min(k + 1, last), next_u, next_v);
+        if constexpr (ChromaSiting::LEFT == C) {
+            even_u = u << 2;
+            even_v = v << 2;
+            odd_u = (u + next_u) << 1;
+            odd_v = (v + next_v) << 1;
+        } else {
+            int32_t prev_u, prev_v;
+            loadUvBlend<S>(buf, near, std::max(k - 1, 0), prev_u, prev_v);
+            even_u = 3 * u + prev_u;
+            even_v = 3 * v + prev_v;
+            odd_u = 3 * u + next_u;
+            odd_v = 3 * v + next_v;
+        }
+        yuvToRgbPreciseS16<D>(param, dst + (j * ch), y0, getChromaS16(even_u), getChromaS16(even_v));
+        yuvToRgbPreciseS16<D>(param, dst + ((j + 1) * ch), y1, getChromaS16(odd_u), getChromaS16(odd_v));
+    }
+}
+
+// Y as u8, U and V without the offset and << k_precise_shift
+template <ImageFormat S>
+inline void rgbToYuvPrecise(const Rgb2YuvPreciseParam &param, const uint8_t *src, uint8_t &y, int32_t &u, int32_t &v) {
+    int32_t r, g, b;
+    loadRgbPixel<S>(src, r, g, b);
+    r <<= 7;
+    g <<= 7;
+    b <<= 7;
+    y = saturate_u8((mulhrs(r, param.m_yr) + mulhrs(g, param.m_yg) + mulhrs(b, param.m_yb) + param.m_y_ofs) >> k_precise_shift);
+    u = mulhrs(b, param.m_ub) - (mulhrs(r, param.m_ur) + mulhrs(g, param.m_ug));
+    v = mulhrs(r, param.m_vr) - (mulhrs(g, param.m_vg) + mulhrs(b, param.m_vb));
+}
+
+// Rounded mean of a chroma sum over 1 << shift pixels
+inline uint8_t packChromaPrecise(int32_t sum, int32_t shift) {
+    return saturate_u8(((sum + (1 << (shift - 1))) >> shift) + k_chroma_ofs);
+}
+
+template <ImageFormat S, ImageFormat D>
+inline void rgbToYuv422RowPrecise(const Rgb2YuvPreciseParam &param, const uint8_t *src, uint8_t *dst, int32_t j, int32_t w) {
+    constexpr auto ch = getChannel<S>();
+    for (; j + 2 <= w; j += 2) {
+        uint8_t y0, y1;
+        int32_t u0, v0, u1, v1;
+        rgbToYuvPrecise<S>(param, src + (j * ch), y0, u0, v0);
+        rgbToYuvPrecise<S>(param, src + ((j + 1) * ch), y1, u1, v1);
+        auto pair = dst + (j << 1);
+        pair[ImageFormat::YUYV == D ? 0 : 1] = y0;
+        pair[ImageFormat::YUYV == D ? 1 : 0] = packChromaPrecise(u0 + u1, k_precise_shift + 1);
+        pair[ImageFormat::YUYV == D ? 2 : 3] = y1;
+        pair[ImageFormat::YUYV == D ? 3 : 2] = packChromaPrecise(v0 + v1, k_precise_shift + 1);
+    }
+}
+
+// u_buf/v_buf point at the start of the chroma rows
+template <ImageFormat S, ImageFormat D>
+inline void rgbToYuv420RowPrecise(const Rgb2YuvPreciseParam &param, const uint8_t *src0, const uint8_t *src1, uint8_t *y0, uint8_t *y1,
+                                  uint8_t *u_buf, uint8_t *v_buf, int32_t j, int32_t w) {
+    constexpr auto ch = getChannel<S>();
+    for (; j + 2 <= w; j += 2) {
+        int32_t u00, v00, u01, v01, u10, v10, u11, v11;
+        rgbToYuvPrecise<S>(param, src0 + (j * ch), y0[j], u00, v00);
+        rgbToYuvPrecise<S>(param, src0 + ((j + 1) * ch), y0[j + 1], u01, v01);
+        rgbToYuvPrecise<S>(param, src1 + (j * ch), y1[j], u10, v10);
+        rgbToYuvPrecise<S>(param, src1 + ((j + 1) * ch), y1[j + 1], u11, v11);
+        auto u = packChromaPrecise(u00 + u01 + u10 + u11, k_precise_shift + 2);
+        auto v = packChromaPrecise(v00 + v01 + v10 + v11, k_precise_shift + 2);
+        if constexpr (ImageFormat::I420 == D) {
+            u_buf[j >> 1] = u;
+            v_buf[j >> 1] = v;
+        } else {
+            u_buf[j + (ImageFormat::NV12 == D ? 0 : 1)] = u;
+            u_buf[j + (ImageFormat::NV12 == D ? 1 : 0)] = v;
+        }
+    }
+}
+
+#define ADD_IMG_CONVERT_PRECISE(F)                      \
+    void F##_precise_c(const Image&, const Image&);     \
+    void F##_precise_neon(const Image&, const Image&);  \
+    void F##_precise_avx2(const Image&, const Image&)
+
+// Bilinear kernels read the chroma rows around a band, so they convert
+// rows [row, row + rows) of the whole frame rather than a roi view
+#define ADD_IMG_CONVERT_BILINEAR(F)                                             \
+    void F##_bilinear_c(const Image&, const Image&, int32_t, int32_t);          \
+    void F##_bilinear_neon(const Image&, const Image&, int32_t, int32_t);       \
+    void F##_bilinear_avx2(const Image&, const Image&, int32_t, int32_t)
+
+#define ADD_IMG_CONVERT_BILINEAR_TO_RGB(S)      \
+    ADD_IMG_CONVERT_BILINEAR(S##_to_rgba);      \
+    ADD_IMG_CONVERT_BILINEAR(S##_to_rgb);       \
+    ADD_IMG_CONVERT_BILINEAR(S##_to_bgra);      \
+    ADD_IMG_CONVERT_BILINEAR(S##_to_bgr)
+
+#define ADD_IMG_CONVERT_PRECISE_TO_RGB(S)       \
+    ADD_IMG_CONVERT_PRECISE(S##_to_rgba);       \
+    ADD_IMG_CONVERT_PRECISE(S##_to_rgb);        \
+    ADD_IMG_CONVERT_PRECISE(S##_to_bgra);       \
+    ADD_IMG_CONVERT_PRECISE(S##_to_bgr);        \
+    ADD_IMG_CONVERT_BILINEAR_TO_RGB(S)
+
+#define ADD_IMG_CONVERT_PRECISE_TO_YUV(S)       \
+    ADD_IMG_CONVERT_PRECISE(S##_to_yuyv);       \
+    ADD_IMG_CONVERT_PRECISE(S##_to_uyvy);       \
+    ADD_IMG_CONVERT_PRECISE(S##_to_i420);       \
+    ADD_IMG_CONVERT_PRECISE(S##_to_nv12);       \
+    ADD_IMG_CONVERT_PRECISE(S##_to_nv21)
+
+ADD_IMG_CONVERT_PRECISE_TO_RGB(yuyv);
+ADD_IMG_CONVERT_PRECISE_TO_RGB(uyvy);
+ADD_IMG_CONVERT_PRECISE_TO_RGB(i420);
+ADD_IMG_CONVERT_PRECISE_TO_RGB(nv12);
+ADD_IMG_CONVERT_PRECISE_TO_RGB(nv21);
+
+// HIGH of the other layouts with chroma pairs stays on their planar
+// kernels, only bilinear chroma has its own
+ADD_IMG_CONVERT_BILINEAR_TO_RGB(yv12);
+ADD_IMG_CONVERT_BILINEAR_TO_RGB(i422);
+ADD_IMG_CONVERT_BILINEAR_TO_RGB(nv16);
+
+ADD_IMG_CONVERT_PRECISE_TO_YUV(rgba);
+ADD_IMG_CONVERT_PRECISE_TO_YUV(rgb);
+ADD_IMG_CONVERT_PRECISE_TO_YUV(bgra);
+ADD_IMG_CONVERT_PRECISE_TO_YUV(bgr);
+
+#undef ADD_IMG_CONVERT_PRECISE_TO_YUV
+#undef ADD_IMG_CONVERT_PRECISE_TO_RGB
+
+NAMESPACE_END
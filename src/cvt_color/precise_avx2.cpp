@@ -0,0 +1,223 @@
+#include <algorithm>
+#include "image.hpp"
+#include "precise.hpp"
+#include "types.hpp"
+#include "x86.hpp"
+#include "x86_pixel.hpp"
+#include "x86_precise.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+NAMESPACE_BEGIN
+
+constexpr int32_t k_pixel_per_loop = 16;
+
+template <ImageFormat S, ImageFormat D>
+AVX2_FUNC static void yuvToRgbPreciseAvx2(const Image &src, const Image &dst) {
+    auto w = src.cols();
+    auto h = src.rows();
+    constexpr auto ch = getChannel<D>();
+    const auto param = getYuv2RgbPreciseParam(src);
+    for (int32_t i = 0; i < h; ++i) {
+        auto buf = getYuvRow<S>(src, i);
+        auto dst_buf = dst.ptr(i);
+        int32_t j = 0;
+        for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+            __m128i y, u, v, r, g, b;
+            loadYuv<S>(buf, j, y, u, v);
+            yuvToRgb(param, y, loadChroma(u), loadChroma(v), r, g, b);
+            storeRgbOrdered<D>(dst_buf + (j * ch), r, g, b);
+        }
+        yuvToRgbRowPrecise<S, D>(param, buf, dst_buf, j, w);
+    }
+}
+
+// 8 chroma samples from sample k blended with the near row, as int16 in
+// 1/4 steps like loadUvBlend
+template <ImageFormat S>
+AVX2_FUNC static inline void loadUvBlend(const YuvRow &buf, const YuvRow &near, int32_t k, __m128i &u, __m128i &v) {
+    __m128i y;
+    loadYuv<S>(buf, k << 1, y, u, v);
+    u = _mm_cvtepu8_epi16(u);
+    v = _mm_cvtepu8_epi16(v);
+    if constexpr (isYuv420<S>()) {
+        __m128i near_u, near_v;
+        loadYuv<S>(near, k << 1, y, near_u, near_v);
+        u = _mm_add_epi16(_mm_add_epi16(u, _mm_slli_epi16(u, 1)), _mm_cvtepu8_epi16(near_u));
+        v = _mm_add_epi16(_mm_add_epi16(v, _mm_slli_epi16(v, 1)), _mm_cvtepu8_epi16(near_v));
+    } else {
+        u = _mm_slli_epi16(u, 2);
+        v = _mm_slli_epi16(v, 2);
+    }
+}
+
+// Chroma of the 16 pixels around 8 blended samples cur, prev and next are
+// the same samples shifted by one, see yuvToRgbRowBilinear
+template <ChromaSiting C>
+AVX2_FUNC static inline __m256i upsample(__m128i prev, __m128i cur, __m128i next) {
+    __m128i even, odd;
+    if constexpr (ChromaSiting::LEFT == C) {
+        even = _mm_slli_epi16(cur, 2);
+        odd = _mm_slli_epi16(_mm_add_epi16(cur, next), 1);
+    } else {
+        auto cur3 = _mm_add_epi16(cur, _mm_slli_epi16(cur, 1));
+        even = _mm_add_epi16(cur3, prev);
+        odd = _mm_add_epi16(cur3, next);
+    }
+    auto val = _mm256_set_m128i(_mm_unpackhi_epi16(even, odd), _mm_unpacklo_epi16(even, odd));
+    return _mm256_slli_epi16(_mm256_sub_epi16(val, _mm256_set1_epi16(k_chroma_ofs << 4)), 4);
+}
+
+template <ImageFormat S, ImageFormat D, ChromaSiting C>
+AVX2_FUNC static void yuvToRgbBilinearAvx2(const Image &src, const Image &dst, int32_t row, int32_t rows) {
+    auto w = src.cols();
+    constexpr auto ch = getChannel<D>();
+    const auto param = getYuv2RgbPreciseParam(src);
+    // The loads of the next samples reach 2 pixels past the block and the
+    // center sited first pair reads the sample before it, C does the edges
+    constexpr int32_t first = ChromaSiting::CENTER == C ? 2 : 0;
+    for (int32_t i = row; i < row + rows; ++i) {
+        auto buf = getYuvRow<S>(src, i);
+        auto near = getYuvRow<S>(src, getNearChromaRow<S>(i, src.rows()));
+        auto dst_buf = dst.ptr(i);
+        auto j = std::min(first, w);
+        yuvToRgbRowBilinear<S, D, C>(param, buf, near, dst_buf, 0, j, w);
+        for (; j + k_pixel_per_loop + 2 <= w; j += k_pixel_per_loop) {
+            __m128i y, u, v, prev_u, prev_v, next_u, next_v, r, g, b;
+            loadYuv<S>(buf, j, y, u, v);
+            loadUvBlend<S>(buf, near, j >> 1, u, v);
+            loadUvBlend<S>(buf, near, (j >> 1) + 1, next_u, next_v);
+            if constexpr (ChromaSiting::CENTER == C) {
+                loadUvBlend<S>(buf, near, (j >> 1) - 1, prev_u, prev_v);
+            } else {
+                prev_u = u;
+                prev_v = v;
+            }
+            yuvToRgb(param, y, upsample<C>(prev_u, u, next_u), upsample<C>(prev_v, v, next_v), r, g, b);
+            storeRgbOrdered<D>(dst_buf + (j * ch), r, g, b);
+        }
+        yuvToRgbRowBilinear<S, D, C>(param, buf, near, dst_buf, j, w, w);
+    }
+}
+
+template <ImageFormat S, ImageFormat D>
+AVX2_FUNC static void yuvToRgbBilinearAvx2(const Image &src, const Image &dst, int32_t row, int32_t rows) {
+    if (ChromaSiting::CENTER == src.chromaSiting()) {
+        yuvToRgbBilinearAvx2<S, D, ChromaSiting::CENTER>(src, dst, row, rows);
+    } else {
+        yuvToRgbBilinearAvx2<S, D, ChromaSiting::LEFT>(src, dst, row, rows);
+    }
+}
+
+template <ImageFormat S, ImageFormat D>
+AVX2_FUNC static void rgbToYuvPreciseAvx2(const Image &src, const Image &dst) {
+    constexpr auto ch = getChannel<S>();
+    auto w = src.cols();
+    auto h = src.rows();
+    const auto param = getRgb2YuvPreciseParam(dst);
+
+    if constexpr (!isYuv420<D>()) {
+        for (int32_t i = 0; i < h; ++i) {
+            auto src_buf = src.ptr(i);
+            auto dst_buf = dst.ptr(i);
+            int32_t j = 0;
+            for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+                __m128i r, g, b, y;
+                __m256i u, v;
+                loadRgb<S>(src_buf + (j * ch), r, g, b);
+                rgbToYuv(param, r, g, b, y, u, v);
+                storeYuv422<D>(dst_buf + (j << 1), y, packChroma(sumPair(u), k_precise_shift + 1),
+                               packChroma(sumPair(v), k_precise_shift + 1));
+            }
+            rgbToYuv422RowPrecise<S, D>(param, src_buf, dst_buf, j, w);
+        }
+        return;
+    }
+
+    for (int32_t i = 0; i < h; i += 2) {
+        auto src0 = src.ptr(i);
+        auto src1 = src.ptr(i + 1);
+        auto y0 = dst.ptr(i, 0);
+        auto y1 = dst.ptr(i + 1, 0);
+        auto u_buf = dst.ptr(i >> 1, 1);
+        auto v_buf = ImageFormat::I420 == D ? dst.ptr(i >> 1, 2) : nullptr;
+        int32_t j = 0;
+        for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+            __m128i r, g, b, y;
+            __m256i u0, v0, u1, v1;
+            loadRgb<S>(src0 + (j * ch), r, g, b);
+            rgbToYuv(param, r, g, b, y, u0, v0);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(y0 + j), y);
+            loadRgb<S>(src1 + (j * ch), r, g, b);
+            rgbToYuv(param, r, g, b, y, u1, v1);
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(y1 + j), y);
+
+            auto u = packChroma(_mm256_add_epi32(sumPair(u0), sumPair(u1)), k_precise_shift + 2);
+            auto v = packChroma(_mm256_add_epi32(sumPair(v0), sumPair(v1)), k_precise_shift + 2);
+            if constexpr (ImageFormat::I420 == D) {
+                storeUv420<D>(u_buf + (j >> 1), v_buf + (j >> 1), u, v);
+            } else {
+                storeUv420<D>(u_buf + j, nullptr, u, v);
+            }
+        }
+        rgbToYuv420RowPrecise<S, D>(param, src0, src1, y0, y1, u_buf, v_buf, j, w);
+    }
+}
+
+#define CVT_PRECISE_AVX2(S, D, SF, DF, F)                               \
+    void S##_to_##D##_precise_avx2(const Image &src, const Image &dst)  \
+    {                                                                   \
+        F<ImageFormat::SF, ImageFormat::DF>(src, dst);                  \
+    }
+
+#define CVT_BILINEAR_AVX2(S, D, SF, DF)                                                             \
+    void S##_to_##D##_bilinear_avx2(const Image &src, const Image &dst, int32_t row, int32_t rows)  \
+    {                                                                                               \
+        yuvToRgbBilinearAvx2<ImageFormat::SF, ImageFormat::DF>(src, dst, row, rows);                \
+    }
+
+#define YUV_TO_RGB_BILINEAR_AVX2(S, SF)                                 \
+    CVT_BILINEAR_AVX2(S, rgba, SF, RGBA)                                \
+    CVT_BILINEAR_AVX2(S, rgb, SF, RGB)                                  \
+    CVT_BILINEAR_AVX2(S, bgra, SF, BGRA)                                \
+    CVT_BILINEAR_AVX2(S, bgr, SF, BGR)
+
+#define YUV_TO_RGB_PRECISE_AVX2(S, SF)                                  \
+    CVT_PRECISE_AVX2(S, rgba, SF, RGBA, yuvToRgbPreciseAvx2)            \
+    CVT_PRECISE_AVX2(S, rgb, SF, RGB, yuvToRgbPreciseAvx2)              \
+    CVT_PRECISE_AVX2(S, bgra, SF, BGRA, yuvToRgbPreciseAvx2)            \
+    CVT_PRECISE_AVX2(S, bgr, SF, BGR, yuvToRgbPreciseAvx2)              \
+    YUV_TO_RGB_BILINEAR_AVX2(S, SF)
+
+#define RGB_TO_YUV_PRECISE_AVX2(S, SF)                                  \
+    CVT_PRECISE_AVX2(S, yuyv, SF, YUYV, rgbToYuvPreciseAvx2)            \
+    CVT_PRECISE_AVX2(S, uyvy, SF, UYVY, rgbToYuvPreciseAvx2)            \
+    CVT_PRECISE_AVX2(S, i420, SF, I420, rgbToYuvPreciseAvx2)            \
+    CVT_PRECISE_AVX2(S, nv12, SF, NV12, rgbToYuvPreciseAvx2)            \
+    CVT_PRECISE_AVX2(S, nv21, SF, NV21, rgbToYuvPreciseAvx2)
+
+YUV_TO_RGB_PRECISE_AVX2(yuyv, YUYV)
+YUV_TO_RGB_PRECISE_AVX2(uyvy, UYVY)
+YUV_TO_RGB_PRECISE_AVX2(i420, I420)
+YUV_TO_RGB_PRECISE_AVX2(nv12, NV12)
+YUV_TO_RGB_PRECISE_AVX2(nv21, NV21)
+YUV_TO_RGB_BILINEAR_AVX2(yv12, YV12)
+YUV_TO_RGB_BILINEAR_AVX2(i422, I422)
+YUV_TO_RGB_BILINEAR_AVX2(nv16, NV16)
+
+RGB_TO_YUV_PRECISE_AVX2(rgba, RGBA)
+RGB_TO_YUV_PRECISE_AVX2(rgb, RGB)
+RGB_TO_YUV_PRECISE_AVX2(bgra, BGRA)
+RGB_TO_YUV_PRECISE_AVX2(bgr, BGR)
+
+#undef RGB_TO_YUV_PRECISE_AVX2
+#undef YUV_TO_RGB_PRECISE_AVX2
+#undef YUV_TO_RGB_BILINEAR_AVX2
+#undef CVT_BILINEAR_AVX2
+#undef CVT_PRECISE_AVX2
+
+NAMESPACE_END
+
+#endif
@@ -0,0 +1,225 @@
+#include <algorithm>
+#include "image.hpp"
+#include "neon_pixel.hpp"
+#include "neon_precise.hpp"
+#include "precise.hpp"
+#include "types.hpp"
+
+#ifdef __aarch64__
+
+#include <arm_neon.h>
+
+NAMESPACE_BEGIN
+
+constexpr int32_t k_pixel_per_loop = 16;
+
+template <ImageFormat S, ImageFormat D>
+static void yuvToRgbPreciseNeon(const Image &src, const Image &dst) {
+    auto w = src.cols();
+    auto h = src.rows();
+    constexpr auto ch = getChannel<D>();
+    const auto param = getYuv2RgbPreciseParam(src);
+    for (int32_t i = 0; i < h; ++i) {
+        auto buf = getYuvRow<S>(src, i);
+        auto dst_buf = dst.ptr(i);
+        int32_t j = 0;
+        for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+            uint8x16_t y, r, g, b;
+            uint8x8_t u, v;
+            loadYuv<S>(buf, j, y, u, v);
+            yuvToRgb(param, y, loadChroma(u), loadChroma(v), r, g, b);
+            storeRgb<D>(dst_buf + (j * ch), r, g, b);
+        }
+        yuvToRgbRowPrecise<S, D>(param, buf, dst_buf, j, w);
+    }
+}
+
+// 8 chroma samples from sample k blended with the near row, as int16 in
+// 1/4 steps like loadUvBlend
+template <ImageFormat S>
+static inline void loadUvBlend(const YuvRow &buf, const YuvRow &near, int32_t k, int16x8_t &u, int16x8_t &v) {
+    uint8x16_t y;
+    uint8x8_t u8, v8;
+    loadYuv<S>(buf, k << 1, y, u8, v8);
+    if constexpr (isYuv420<S>()) {
+        uint8x8_t near_u, near_v;
+        loadYuv<S>(near, k << 1, y, near_u, near_v);
+        u = vreinterpretq_s16_u16(vmlal_u8(vmovl_u8(near_u), u8, vdup_n_u8(3)));
+        v = vreinterpretq_s16_u16(vmlal_u8(vmovl_u8(near_v), v8, vdup_n_u8(3)));
+    } else {
+        u = vreinterpretq_s16_u16(vshll_n_u8(u8, 2));
+        v = vreinterpretq_s16_u16(vshll_n_u8(v8, 2));
+    }
+}
+
+// Chroma of the 16 pixels around 8 blended samples cur, prev and next are
+// the same samples shifted by one, see yuvToRgbRowBilinear
+template <ChromaSiting C>
+static inline int16x8x2_t upsample(int16x8_t prev, int16x8_t cur, int16x8_t next) {
+    int16x8_t even, odd;
+    if constexpr (ChromaSiting::LEFT == C) {
+        even = vshlq_n_s16(cur, 2);
+        odd = vshlq_n_s16(vaddq_s16(cur, next), 1);
+    } else {
+        auto cur3 = vmulq_n_s16(cur, 3);
+        even = vaddq_s16(cur3, prev);
+        odd = vaddq_s16(cur3, next);
+    }
+    auto ofs = vdupq_n_s16(k_chroma_ofs << 4);
+    return int16x8x2_t{{vshlq_n_s16(vsubq_s16(vzip1q_s16(even, odd), ofs), 4),
+                        vshlq_n_s16(vsubq_s16(vzip2q_s16(even, odd), ofs), 4)}};
+}
+
+template <ImageFormat S, ImageFormat D, ChromaSiting C>
+static void yuvToRgbBilinearNeon(const Image &src, const Image &dst, int32_t row, int32_t rows) {
+    auto w = src.cols();
+    constexpr auto ch = getChannel<D>();
+    const auto param = getYuv2RgbPreciseParam(src);
+    // The loads of the next samples reach 2 pixels past the block and the
+    // center sited first pair reads the sample before it, C does the edges
+    constexpr int32_t first = ChromaSiting::CENTER == C ? 2 : 0;
+    for (int32_t i = row; i < row + rows; ++i) {
+        auto buf = getYuvRow<S>(src, i);
+        auto near = getYuvRow<S>(src, getNearChromaRow<S>(i, src.rows()));
+        auto dst_buf = dst.ptr(i);
+        auto j = std::min(first, w);
+        yuvToRgbRowBilinear<S, D, C>(param, buf, near, dst_buf, 0, j, w);
+        for (; j + k_pixel_per_loop + 2 <= w; j += k_pixel_per_loop) {
+            uint8x16_t y, r, g, b;
+            uint8x8_t u8, v8;
+            int16x8_t u, v, prev_u, prev_v, next_u, next_v;
+            loadYuv<S>(buf, j, y, u8, v8);
+            loadUvBlend<S>(buf, near, j >> 1, u, v);
+            loadUvBlend<S>(buf, near, (j >> 1) + 1, next_u, next_v);
+            if constexpr (ChromaSiting::CENTER == C) {
+                loadUvBlend<S>(buf, near, (j >> 1) - 1, prev_u, prev_v);
+            } else {
+                prev_u = u;
+                prev_v = v;
+            }
+            yuvToRgb(param, y, upsample<C>(prev_u, u, next_u), upsample<C>(prev_v, v, next_v), r, g, b);
+            storeRgb<D>(dst_buf + (j * ch), r, g, b);
+        }
+        yuvToRgbRowBilinear<S, D, C>(param, buf, near, dst_buf, j, w, w);
+    }
+}
+
+template <ImageFormat S, ImageFormat D>
+static void yuvToRgbBilinearNeon(const Image &src, const Image &dst, int32_t row, int32_t rows) {
+    if (ChromaSiting::CENTER == src.chromaSiting()) {
+        yuvToRgbBilinearNeon<S, D, ChromaSiting::CENTER>(src, dst, row, rows);
+    } else {
+        yuvToRgbBilinearNeon<S, D, ChromaSiting::LEFT>(src, dst, row, rows);
+    }
+}
+
+template <ImageFormat S, ImageFormat D>
+static void rgbToYuvPreciseNeon(const Image &src, const Image &dst) {
+    constexpr auto ch = getChannel<S>();
+    auto w = src.cols();
+    auto h = src.rows();
+    const auto param = getRgb2YuvPreciseParam(dst);
+
+    if constexpr (!isYuv420<D>()) {
+        for (int32_t i = 0; i < h; ++i) {
+            auto src_buf = src.ptr(i);
+            auto dst_buf = dst.ptr(i);
+            int32_t j = 0;
+            for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+                uint8x16_t r, g, b, y;
+                int16x8x2_t u, v;
+                loadRgb<S>(src_buf + (j * ch), r, g, b);
+                rgbToYuv(param, r, g, b, y, u, v);
+                storeYuv422<D>(dst_buf + (j << 1), y, packChroma<k_precise_shift + 1>(sumPair(u)),
+                               packChroma<k_precise_shift + 1>(sumPair(v)));
+            }
+            rgbToYuv422RowPrecise<S, D>(param, src_buf, dst_buf, j, w);
+        }
+        return;
+    }
+
+    for (int32_t i = 0; i < h; i += 2) {
+        auto src0 = src.ptr(i);
+        auto src1 = src.ptr(i + 1);
+        auto y0 = dst.ptr(i, 0);
+        auto y1 = dst.ptr(i + 1, 0);
+        auto u_buf = dst.ptr(i >> 1, 1);
+        auto v_buf = ImageFormat::I420 == D ? dst.ptr(i >> 1, 2) : nullptr;
+        int32_t j = 0;
+        for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+            uint8x16_t r, g, b, y;
+            int16x8x2_t u0, v0, u1, v1;
+            loadRgb<S>(src0 + (j * ch), r, g, b);
+            rgbToYuv(param, r, g, b, y, u0, v0);
+            vst1q_u8(y0 + j, y);
+            loadRgb<S>(src1 + (j * ch), r, g, b);
+            rgbToYuv(param, r, g, b, y, u1, v1);
+            vst1q_u8(y1 + j, y);
+
+            auto u = packChroma<k_precise_shift + 2>(addSum(sumPair(u0), sumPair(u1)));
+            auto v = packChroma<k_precise_shift + 2>(addSum(sumPair(v0), sumPair(v1)));
+            if constexpr (ImageFormat::I420 == D) {
+                storeUv420<D>(u_buf + (j >> 1), v_buf + (j >> 1), u, v);
+            } else {
+                storeUv420<D>(u_buf + j, nullptr, u, v);
+            }
+        }
+        rgbToYuv420RowPrecise<S, D>(param, src0, src1, y0, y1, u_buf, v_buf, j, w);
+    }
+}
+
+#define CVT_PRECISE_NEON(S, D, SF, DF, F)                               \
+    void S##_to_##D##_precise_neon(const Image &src, const Image &dst)  \
+    {                                                                   \
+        F<ImageFormat::SF, ImageFormat::DF>(src, dst);                  \
+    }
+
+#define CVT_BILINEAR_NEON(S, D, SF, DF)                                                             \
+    void S##_to_##D##_bilinear_neon(const Image &src, const Image &dst, int32_t row, int32_t rows)  \
+    {                                                                                               \
+        yuvToRgbBilinearNeon<ImageFormat::SF, ImageFormat::DF>(src, dst, row, rows);                \
+    }
+
+#define YUV_TO_RGB_BILINEAR_NEON(S, SF)                                 \
+    CVT_BILINEAR_NEON(S, rgba, SF, RGBA)                                \
+    CVT_BILINEAR_NEON(S, rgb, SF, RGB)                                  \
+    CVT_BILINEAR_NEON(S, bgra, SF, BGRA)                                \
+    CVT_BILINEAR_NEON(S, bgr, SF, BGR)
+
+#define YUV_TO_RGB_PRECISE_NEON(S, SF)                                  \
+    CVT_PRECISE_NEON(S, rgba, SF, RGBA, yuvToRgbPreciseNeon)            \
+    CVT_PRECISE_NEON(S, rgb, SF, RGB, yuvToRgbPreciseNeon)              \
+    CVT_PRECISE_NEON(S, bgra, SF, BGRA, yuvToRgbPreciseNeon)            \
+    CVT_PRECISE_NEON(S, bgr, SF, BGR, yuvToRgbPreciseNeon)              \
+    YUV_TO_RGB_BILINEAR_NEON(S, SF)
+
+#define RGB_TO_YUV_PRECISE_NEON(S, SF)                                  \
+    CVT_PRECISE_NEON(S, yuyv, SF, YUYV, rgbToYuvPreciseNeon)            \
+    CVT_PRECISE_NEON(S, uyvy, SF, UYVY, rgbToYuvPreciseNeon)            \
+    CVT_PRECISE_NEON(S, i420, SF, I420, rgbToYuvPreciseNeon)            \
+    CVT_PRECISE_NEON(S, nv12, SF, NV12, rgbToYuvPreciseNeon)            \
+    CVT_PRECISE_NEON(S, nv21, SF, NV21, rgbToYuvPreciseNeon)
+
+YUV_TO_RGB_PRECISE_NEON(yuyv, YUYV)
+YUV_TO_RGB_PRECISE_NEON(uyvy, UYVY)
+YUV_TO_RGB_PRECISE_NEON(i420, I420)
+YUV_TO_RGB_PRECISE_NEON(nv12, NV12)
+YUV_TO_RGB_PRECISE_NEON(nv21, NV21)
+YUV_TO_RGB_BILINEAR_NEON(yv12, YV12)
+YUV_TO_RGB_BILINEAR_NEON(i422, I422)
+YUV_TO_RGB_BILINEAR_NEON(nv16, NV16)
+
+RGB_TO_YUV_PRECISE_NEON(rgba, RGBA)
+RGB_TO_YUV_PRECISE_NEON(rgb, RGB)
+RGB_TO_YUV_PRECISE_NEON(bgra, BGRA)
+RGB_TO_YUV_PRECISE_NEON(bgr, BGR)
+
+#undef RGB_TO_YUV_PRECISE_NEON
+#undef YUV_TO_RGB_PRECISE_NEON
+#undef YUV_TO_RGB_BILINEAR_NEON
+#undef CVT_BILINEAR_NEON
+#undef CVT_PRECISE_NEON
+
+NAMESPACE_END
+
+#endif
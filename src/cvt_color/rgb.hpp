@@ -1,34 +1,77 @@
 #pragma once
 
+#include "colorimetry.hpp"
+#include "image.hpp"
 #include "types.hpp"
 
 NAMESPACE_BEGIN
 
 constexpr uint8_t k_shift = 7U;
 constexpr uint8_t k_alpha = 255;
-static const struct Rgb2YuvParam {  // NOLINT
-    uint8_t m_yr = 38;
-    uint8_t m_yg = 75;
-    uint8_t m_yb = 15;
-    uint8_t m_placehold = 0;
-    uint16_t m_ur = 22;    // -
-    uint16_t m_ug = 42;    // -
-    uint16_t m_ub = 64;    // +
-    uint16_t m_vr = 64;    // +
-    uint16_t m_vg = 54;    // -
-    uint16_t m_vb = 10;    // -
-} k_rgb_2_yuv{};
+struct Rgb2YuvParam {
+    uint8_t m_yr;
+    uint8_t m_yg;
+    uint8_t m_yb;
+    uint8_t m_placehold;
+    uint16_t m_ur;      // -
+    uint16_t m_ug;      // -
+    uint16_t m_ub;      // +
+    uint16_t m_vr;      // +
+    uint16_t m_vg;      // -
+    uint16_t m_vb;      // -
+    uint16_t m_y_ofs;   // + luma foot of the limited range, << k_shift
+};
+
+// Coefficients of a matrix with luma weights kr/kb in k_shift fixed point.
+// The weights of y, u and v are balanced so white stays in range and gray
+// has no chroma, the neon kernels also rely on m_ub == m_vr.
+constexpr Rgb2YuvParam makeRgb2YuvParam(double kr, double kb, ColorRange range) {
+    constexpr double scale = 1 << k_shift;
+    auto limited = ColorRange::LIMITED == range;
+    auto ys = limited ? 219.0 / 255 : 1.0;
+    auto cs = limited ? 224.0 / 255 : 1.0;
+
+    auto yr = static_cast<int32_t>(kr * ys * scale + 0.5);
+    auto yb = static_cast<int32_t>(kb * ys * scale + 0.5);
+    auto yg = static_cast<int32_t>(ys * scale + 0.5) - yr - yb;
+    auto half = static_cast<int32_t>(0.5 * cs * scale + 0.5);
+    auto ur = static_cast<int32_t>(kr / (2 * (1 - kb)) * cs * scale + 0.5);
+    auto vb = static_cast<int32_t>(kb / (2 * (1 - kr)) * cs * scale + 0.5);
+    return {
+        static_cast<uint8_t>(yr), static_cast<uint8_t>(yg), static_cast<uint8_t>(yb), 0,
+        static_cast<uint16_t>(ur), static_cast<uint16_t>(half - ur), static_cast<uint16_t>(half),
+        static_cast<uint16_t>(half), static_cast<uint16_t>(half - vb), static_cast<uint16_t>(vb),
+        static_cast<uint16_t>(limited ? 16 << k_shift : 0)
+    };
+}
+
+static constexpr auto k_rgb_2_yuv_param = makeColorSpaceTable<Rgb2YuvParam>(makeRgb2YuvParam);
+
+static_assert(38 == k_rgb_2_yuv_param[0].m_yr && 75 == k_rgb_2_yuv_param[0].m_yg && 15 == k_rgb_2_yuv_param[0].m_yb &&
+              22 == k_rgb_2_yuv_param[0].m_ur && 42 == k_rgb_2_yuv_param[0].m_ug && 64 == k_rgb_2_yuv_param[0].m_ub &&
+              54 == k_rgb_2_yuv_param[0].m_vg && 10 == k_rgb_2_yuv_param[0].m_vb,
+              "BT.601 full range must keep the original coefficients");
+
+// Gray is full range luma, it keeps the BT.601 full range weights
+static constexpr const Rgb2YuvParam &k_rgb_2_yuv = k_rgb_2_yuv_param[0];
+
+// Coefficients for converting rgb to the yuv image `img`
+inline const Rgb2YuvParam &getRgb2YuvParam(const Image &img) {
+    return k_rgb_2_yuv_param[getColorSpaceIdx(img)];
+}
 
 #define LOAD_Y_PARAM                                        \
-    "mov x0, #4 \n"                                         \
-    "ld3r {v29.16b, v30.16b, v31.16b}, [%[param]], x0   \n"
+    "ld3r {v29.16b, v30.16b, v31.16b}, [%[param]]       \n"
 
+// x0 is scratch, every kernel loading the params clobbers it
 #define LOAD_YUV_PARAM                                  \
     LOAD_Y_PARAM                                        \
-    "ld3r {v24.8h, v25.8h, v26.8h}, [%[param]], #6  \n" \
-    "ld3r {v26.8h, v27.8h, v28.8h}, [%[param]], #6  \n"
+    "add x0, %[param], #4                           \n" \
+    "ld3r {v24.8h, v25.8h, v26.8h}, [x0], #6        \n" \
+    "ld3r {v26.8h, v27.8h, v28.8h}, [x0], #6        \n" \
+    "ld1r {v22.8h}, [x0]                            \n"
 
 #define USED_Y_REG  "x0", "v31", "v30", "v29"
-#define USED_YUV_REG  USED_Y_REG, "v28", "v27", "v26", "v25", "v24"
+#define USED_YUV_REG  USED_Y_REG, "v28", "v27", "v26", "v25", "v24", "v22"
 
 NAMESPACE_END
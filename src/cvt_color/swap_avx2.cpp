@@ -0,0 +1,124 @@
+#include <algorithm>
+#include "image.hpp"
+#include "types.hpp"
+#include "x86.hpp"
+#include "x86_pixel.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+NAMESPACE_BEGIN
+
+// Byte order swaps between layouts of the same size. Each block is loaded
+// before it is stored and nothing past it is read, so src may be dst
+
+// Swaps bytes 0 and 2 of every 4 byte group when Quad, else the bytes of
+// every pair, over n bytes
+template <bool Quad>
+AVX2_FUNC static inline void swapRow(const uint8_t *src, uint8_t *dst, int32_t n) {
+    const __m256i mask = Quad
+        ? _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                           2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15)
+        : _mm256_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+                           1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+    int32_t j = 0;
+    for (; j + 32 <= n; j += 32) {
+        auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + j));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + j), _mm256_shuffle_epi8(x, mask));
+    }
+    for (; j < n; j += Quad ? 4 : 2) {
+        auto b0 = src[j];
+        if constexpr (Quad) {
+            dst[j] = src[j + 2];
+            dst[j + 1] = src[j + 1];
+            dst[j + 2] = b0;
+            dst[j + 3] = src[j + 3];
+        } else {
+            dst[j] = src[j + 1];
+            dst[j + 1] = b0;
+        }
+    }
+}
+
+template <ImageFormat S, ImageFormat D>
+AVX2_FUNC static void swapRgbAvx2(const Image &src, const Image &dst) {
+    auto w = src.cols();
+    for (int32_t i = 0; i < src.rows(); ++i) {
+        auto src_buf = src.ptr(i);
+        auto dst_buf = dst.ptr(i);
+        int32_t j = 0;
+        for (; j + 16 <= w; j += 16) {
+            __m128i r, g, b;
+            loadRgb<S>(src_buf + (j * 3), r, g, b);
+            if constexpr (isBgr<D>()) {
+                storeRgb<D>(dst_buf + (j * 3), b, g, r);
+            } else {
+                storeRgb<D>(dst_buf + (j * 3), r, g, b);
+            }
+        }
+        for (; j < w; ++j) {
+            auto c0 = src_buf[j * 3];
+            dst_buf[j * 3] = src_buf[j * 3 + 2];
+            dst_buf[j * 3 + 1] = src_buf[j * 3 + 1];
+            dst_buf[j * 3 + 2] = c0;
+        }
+    }
+}
+
+template <bool Quad>
+AVX2_FUNC static void swapPackedAvx2(const Image &src, const Image &dst) {
+    auto n = static_cast<int32_t>(getPlaneStride(src.cols(), src.fmt(), 0));
+    for (int32_t i = 0; i < src.rows(); ++i) {
+        swapRow<Quad>(src.ptr(i), dst.ptr(i), n);
+    }
+}
+
+// Luma is copied unless it is the same memory, chroma pairs are swapped
+AVX2_FUNC static void swapSemiPlanarAvx2(const Image &src, const Image &dst) {
+    auto w = src.cols();
+    for (int32_t i = 0; i < src.rows(); ++i) {
+        if (src.ptr(i, 0) != dst.ptr(i, 0)) {
+            std::copy_n(src.ptr(i, 0), w, dst.ptr(i, 0));
+        }
+    }
+    for (int32_t i = 0; i < src.rows() >> 1; ++i) {
+        swapRow<false>(src.ptr(i, 1), dst.ptr(i, 1), w);
+    }
+}
+
+void rgb_to_bgr_avx2(const Image &src, const Image &dst) {
+    swapRgbAvx2<ImageFormat::RGB, ImageFormat::BGR>(src, dst);
+}
+
+void bgr_to_rgb_avx2(const Image &src, const Image &dst) {
+    swapRgbAvx2<ImageFormat::BGR, ImageFormat::RGB>(src, dst);
+}
+
+void rgba_to_bgra_avx2(const Image &src, const Image &dst) {
+    swapPackedAvx2<true>(src, dst);
+}
+
+void bgra_to_rgba_avx2(const Image &src, const Image &dst) {
+    swapPackedAvx2<true>(src, dst);
+}
+
+void yuyv_to_uyvy_avx2(const Image &src, const Image &dst) {
+    swapPackedAvx2<false>(src, dst);
+}
+
+void uyvy_to_yuyv_avx2(const Image &src, const Image &dst) {
+    swapPackedAvx2<false>(src, dst);
+}
+
+void nv12_to_nv21_avx2(const Image &src, const Image &dst) {
+    swapSemiPlanarAvx2(src, dst);
+}
+
+void nv21_to_nv12_avx2(const Image &src, const Image &dst) {
+    swapSemiPlanarAvx2(src, dst);
+}
+
+NAMESPACE_END
+
+#endif
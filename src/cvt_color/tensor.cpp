@@ -0,0 +1,200 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include "band.hpp"
+#include "cpu_feature.hpp"
+#include "cvt_color.hpp"
+#include "image.hpp"
+#include "tensor.hpp"
+
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+template <ImageFormat S, TensorLayout L, TensorType T>
+static void rgbToTensorC(const TensorParam &param, const uint8_t *src, void *dst, size_t plane, int32_t w) {
+    rgbToTensorRow<S, L, T>(param, src, dst, plane, 0, w);
+}
+
+#define TENSOR_C(S, L, T, SF, LF, TF)                                                           \
+    void S##_to_##L##_##T##_c(const TensorParam &param, const uint8_t *src, void *dst, size_t plane, int32_t w) \
+    {                                                                                           \
+        rgbToTensorC<ImageFormat::SF, TensorLayout::LF, TensorType::TF>(param, src, dst, plane, w); \
+    }
+
+#define TENSOR_C_TYPES(S, L, SF, LF)                                                            \
+    TENSOR_C(S, L, f32, SF, LF, FLOAT32)                                                        \
+    TENSOR_C(S, L, f16, SF, LF, FLOAT16)                                                        \
+    TENSOR_C(S, L, bf16, SF, LF, BFLOAT16)                                                      \
+    TENSOR_C(S, L, s8, SF, LF, INT8)                                                            \
+    TENSOR_C(S, L, u8, SF, LF, UINT8)
+
+#define TENSOR_C_TO(L, LF)                                                                      \
+    TENSOR_C_TYPES(rgba, L, RGBA, LF)                                                           \
+    TENSOR_C_TYPES(rgb, L, RGB, LF)                                                             \
+    TENSOR_C_TYPES(bgra, L, BGRA, LF)                                                           \
+    TENSOR_C_TYPES(bgr, L, BGR, LF)
+
+TENSOR_C_TO(nchw, NCHW)
+TENSOR_C_TO(nhwc, NHWC)
+
+#undef TENSOR_C_TO
+#undef TENSOR_C_TYPES
+#undef TENSOR_C
+
+#ifdef __aarch64__
+#define TENSOR_NEON(F) F
+#else
+#define TENSOR_NEON(F) nullptr
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define TENSOR_X86(F) F
+#else
+#define TENSOR_X86(F) nullptr
+#endif
+
+constexpr size_t k_tensor_type_num = getValueOf(TensorType::END);
+
+using TensorRowFunction = void(*)(const TensorParam&, const uint8_t*, void*, size_t, int32_t);
+using TensorImpl = std::array<TensorRowFunction, getValueOf(CpuTier::END)>;
+using TensorTypeImpl = std::array<TensorImpl, k_tensor_type_num>;
+
+// Indexed by the rgb source (rgba, rgb, bgra, bgr), the layout, the type
+// and CpuTier: scalar, neon, sse4.1, avx2, avx512bw
+#define TENSOR_IMPL(F) TensorImpl{F##_c, TENSOR_NEON(F##_neon), nullptr, TENSOR_X86(F##_avx2), nullptr}
+#define TENSOR_IMPL_TYPES(F)                                                                    \
+    TensorTypeImpl{TENSOR_IMPL(F##_f32), TENSOR_IMPL(F##_f16), TENSOR_IMPL(F##_bf16),          \
+                   TENSOR_IMPL(F##_s8), TENSOR_IMPL(F##_u8)}
+
+static constexpr std::array<std::array<TensorTypeImpl, getValueOf(TensorLayout::END)>, 4> g_tensor_impl{{
+    {TENSOR_IMPL_TYPES(rgba_to_nchw), TENSOR_IMPL_TYPES(rgba_to_nhwc)},
+    {TENSOR_IMPL_TYPES(rgb_to_nchw), TENSOR_IMPL_TYPES(rgb_to_nhwc)},
+    {TENSOR_IMPL_TYPES(bgra_to_nchw), TENSOR_IMPL_TYPES(bgra_to_nhwc)},
+    {TENSOR_IMPL_TYPES(bgr_to_nchw), TENSOR_IMPL_TYPES(bgr_to_nhwc)},
+}};
+
+#undef TENSOR_IMPL_TYPES
+#undef TENSOR_IMPL
+#undef TENSOR_X86
+#undef TENSOR_NEON
+
+static size_t getTensorElemSize(TensorType type) {
+    static constexpr size_t size[] = {
+        getTensorElemSize<TensorType::FLOAT32>(), getTensorElemSize<TensorType::FLOAT16>(),
+        getTensorElemSize<TensorType::BFLOAT16>(), getTensorElemSize<TensorType::INT8>(),
+        getTensorElemSize<TensorType::UINT8>(),
+    };
+    return size[getValueOf(type)];
+}
+
+size_t getTensorBytes(int32_t rows, int32_t cols, TensorType type) {
+    if (rows < 0 || cols < 0 || type >= TensorType::END) {
+        return 0;
+    }
+    return 3 * static_cast<size_t>(rows) * static_cast<size_t>(cols) * getTensorElemSize(type);
+}
+
+static bool isRgb(ImageFormat fmt) {
+    return ImageFormat::RGBA == fmt || ImageFormat::RGB == fmt || ImageFormat::BGRA == fmt || ImageFormat::BGR == fmt;
+}
+
+// Row kernel reading fmt for the active tier. Reading rgb as bgr and the
+// other way around swaps the stored r and b
+static TensorRowFunction getTensorRowFunc(ImageFormat fmt, TensorLayout layout, TensorType type, bool bgr) {
+    static constexpr ImageFormat swapped[] = {ImageFormat::BGRA, ImageFormat::BGR, ImageFormat::RGBA, ImageFormat::RGB};
+    auto idx = getValueOf(fmt) - getValueOf(ImageFormat::RGBA);
+    if (bgr) {
+        idx = getValueOf(swapped[idx]) - getValueOf(ImageFormat::RGBA);
+    }
+    const auto &impl = g_tensor_impl[idx][getValueOf(layout)][getValueOf(type)];
+    for (auto t = static_cast<int32_t>(getValueOf(getCpuTier())); t >= 0; --t) {
+        if (nullptr != impl[t] && isCpuTierSupported(static_cast<CpuTier>(t))) {
+            return impl[t];
+        }
+    }
+    return impl[0];
+}
+
+void cvtToTensor(const Image &src, void *dst, const TensorOption &option) {
+    if (0 == src.pixels()) {
+        throw std::invalid_argument("Image must not be empty");
+    }
+    if (nullptr == dst) {
+        throw std::invalid_argument("Tensor must not be null");
+    }
+    if (option.m_layout >= TensorLayout::END) {
+        throw std::invalid_argument("Unsupported tensor layout");
+    }
+    if (option.m_type >= TensorType::END) {
+        throw std::invalid_argument("Unsupported tensor type");
+    }
+    // Bilinear chroma needs the rows around each strip, which the strip
+    // conversion does not see, alpha is not stored
+    if (ChromaFilter::NEAREST != option.m_cvt.m_chroma_filter || option.m_cvt.m_precision >= CvtPrecision::END ||
+        AlphaOp::NONE != option.m_cvt.m_alpha) {
+        throw std::invalid_argument("Unsupported conversion option");
+    }
+
+    TensorParam param{option.m_mean, option.m_scale};
+    if (TensorType::INT8 == option.m_type || TensorType::UINT8 == option.m_type) {
+        auto lo = TensorType::INT8 == option.m_type ? -128 : 0;
+        auto hi = TensorType::INT8 == option.m_type ? 127 : 255;
+        if (!(option.m_quant_scale > 0) || !std::isfinite(option.m_quant_scale)) {
+            throw std::invalid_argument("Quantization scale must be positive");
+        }
+        if (option.m_zero_point < lo || option.m_zero_point > hi) {
+            throw std::invalid_argument("Zero point out of range");
+        }
+        param.m_quant_scale = option.m_quant_scale;
+        param.m_quant_min = static_cast<float>(lo - option.m_zero_point);
+        param.m_quant_max = static_cast<float>(hi - option.m_zero_point);
+        param.m_zero_point = option.m_zero_point;
+    }
+
+    auto fmt = src.fmt();
+    CvtFunction cvt = nullptr;
+    if (!isRgb(fmt)) {
+        // Header over the tensor memory so checkCvtColor sees the rgb
+        // size, it is never written through
+        checkCvtColor(src, Image(src.rows(), src.cols(), ImageFormat::RGB, static_cast<uint8_t*>(dst)));
+        cvt = getCvtFunc(fmt, ImageFormat::RGB, option.m_cvt);
+        fmt = ImageFormat::RGB;
+    }
+
+    auto row_func = getTensorRowFunc(fmt, option.m_layout, option.m_type, option.m_bgr);
+    auto w = src.cols();
+    auto plane = src.pixels();
+    // Bytes between the starts of two tensor rows
+    auto row_step = static_cast<size_t>(w) * (TensorLayout::NCHW == option.m_layout ? 1 : 3) * getTensorElemSize(option.m_type);
+    auto *out = static_cast<uint8_t*>(dst);
+
+    // Even so 4:2:0 chroma rows pair up within a strip
+    auto strip = std::min(std::max(2, static_cast<int32_t>(k_strip_bytes / (3UL * w)) & ~1), src.rows());
+    std::vector<Image> rgb;
+    auto init = [&](size_t bands) {
+        for (size_t i = 0; nullptr != cvt && i < bands; ++i) {
+            rgb.emplace_back(strip, w, ImageFormat::RGB);
+        }
+    };
+    forEachRowBand(src, init, [&](size_t band, int32_t row, int32_t rows) {
+        if (nullptr == cvt) {
+            for (auto i = row; i < row + rows; ++i) {
+                row_func(param, src.ptr(i), out + i * row_step, plane, w);
+            }
+            return;
+        }
+
+        for (auto i = row; i < row + rows; i += strip) {
+            auto n = std::min(strip, row + rows - i);
+            cvt(src.roi(0, i, w, n), rgb[band].roi(0, 0, w, n));
+            for (int32_t k = 0; k < n; ++k) {
+                row_func(param, rgb[band].ptr(k), out + (i + k) * row_step, plane, w);
+            }
+        }
+    });
+}
+
+NAMESPACE_END
@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include "cvt_color.hpp"
+#include "image.hpp"
+#include "pixel.hpp"
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+// Mean and scale of the output channels, in the order they are stored,
+// with the quantization of INT8 and UINT8
+struct TensorParam {
+    std::array<float, 3> m_mean{};
+    std::array<float, 3> m_scale{};
+    float m_quant_scale{1};
+    // Range of v / m_quant_scale, the type range less the zero point
+    float m_quant_min{0};
+    float m_quant_max{0};
+    int32_t m_zero_point{0};
+};
+
+template <TensorType T>
+constexpr size_t getTensorElemSize() {
+    return TensorType::FLOAT32 == T ? 4 : TensorType::INT8 == T || TensorType::UINT8 == T ? 1 : 2;
+}
+
+// Round to nearest even like F16C and FCVT, NaN stays quiet
+inline uint16_t toHalf(float v) {
+#ifdef __aarch64__
+    return std::bit_cast<uint16_t>(static_cast<__fp16>(v));
+#else
+    constexpr uint32_t half_max = (127 + 16) << 23;
+    constexpr uint32_t half_min_normal = 113 << 23;
+    // Adding it shifts a subnormal half's bits to the bottom of the float
+    constexpr uint32_t denorm_magic = ((127 - 15) + (23 - 10) + 1) << 23;
+    auto x = std::bit_cast<uint32_t>(v);
+    auto sign = static_cast<uint16_t>((x >> 16) & 0x8000);
+    x &= 0x7fffffff;
+    if (x >= half_max) {
+        return sign | (x > 0x7f800000 ? 0x7e00 | ((x >> 13) & 0x3ff) : 0x7c00);
+    }
+    if (x < half_min_normal) {
+        auto f = std::bit_cast<float>(x) + std::bit_cast<float>(denorm_magic);
+        return sign | static_cast<uint16_t>(std::bit_cast<uint32_t>(f) - denorm_magic);
+    }
+    x += ((15U - 127U) << 23) + 0xfff + ((x >> 13) & 1);
+    return sign | static_cast<uint16_t>(x >> 13);
+#endif
+}
+
+// Round to nearest even on the upper 16 bits
+inline uint16_t toBfloat16(float v) {
+    auto x = std::bit_cast<uint32_t>(v);
+    return static_cast<uint16_t>((x + 0x7fff + ((x >> 16) & 1)) >> 16);
+}
+
+// The bounds are whole so clamping before rounding equals clamping after
+inline int32_t quantize(const TensorParam &param, float v) {
+    auto t = std::min(std::max(v / param.m_quant_scale, param.m_quant_min), param.m_quant_max);
+    return static_cast<int32_t>(std::nearbyint(t)) + param.m_zero_point;
+}
+
+template <TensorType T>
+inline void storeTensor(const TensorParam &param, void *dst, size_t idx, float v) {
+    if constexpr (TensorType::FLOAT32 == T) {
+        static_cast<float*>(dst)[idx] = v;
+    } else if constexpr (TensorType::FLOAT16 == T) {
+        static_cast<uint16_t*>(dst)[idx] = toHalf(v);
+    } else if constexpr (TensorType::BFLOAT16 == T) {
+        static_cast<uint16_t*>(dst)[idx] = toBfloat16(v);
+    } else if constexpr (TensorType::INT8 == T) {
+        static_cast<int8_t*>(dst)[idx] = static_cast<int8_t>(quantize(param, v));
+    } else {
+        static_cast<uint8_t*>(dst)[idx] = static_cast<uint8_t>(quantize(param, v));
+    }
+}
+
+// Normalizes pixels [j, w) of a rgb row. NCHW channel c goes to element
+// c * plane + j of dst, NHWC to j * 3 + c. The _c kernels are bit exact
+// to the SIMD ones, both subtract and then multiply
+template <ImageFormat S, TensorLayout L, TensorType T>
+inline void rgbToTensorRow(const TensorParam &param, const uint8_t *src, void *dst, size_t plane, int32_t j, int32_t w) {
+    constexpr auto ch = getChannel<S>();
+    for (; j < w; ++j) {
+        int32_t val[3];
+        loadRgbPixel<S>(src + (j * ch), val[0], val[1], val[2]);
+        for (int32_t c = 0; c < 3; ++c) {
+            auto v = (static_cast<float>(val[c]) - param.m_mean[c]) * param.m_scale[c];
+            storeTensor<T>(param, dst, TensorLayout::NCHW == L ? c * plane + j : j * 3 + c, v);
+        }
+    }
+}
+
+#define ADD_TENSOR_CONVERT(F)                                                           \
+    void F##_c(const TensorParam&, const uint8_t*, void*, size_t, int32_t);             \
+    void F##_neon(const TensorParam&, const uint8_t*, void*, size_t, int32_t);          \
+    void F##_avx2(const TensorParam&, const uint8_t*, void*, size_t, int32_t)
+
+#define ADD_TENSOR_CONVERT_TYPES(F)                                                     \
+    ADD_TENSOR_CONVERT(F##_f32);                                                        \
+    ADD_TENSOR_CONVERT(F##_f16);                                                        \
+    ADD_TENSOR_CONVERT(F##_bf16);                                                       \
+    ADD_TENSOR_CONVERT(F##_s8);                                                         \
+    ADD_TENSOR_CONVERT(F##_u8)
+
+ADD_TENSOR_CONVERT_TYPES(rgba_to_nchw);
+ADD_TENSOR_CONVERT_TYPES(rgb_to_nchw);
+ADD_TENSOR_CONVERT_TYPES(bgra_to_nchw);
+ADD_TENSOR_CONVERT_TYPES(bgr_to_nchw);
+ADD_TENSOR_CONVERT_TYPES(rgba_to_nhwc);
+ADD_TENSOR_CONVERT_TYPES(rgb_to_nhwc);
+ADD_TENSOR_CONVERT_TYPES(bgra_to_nhwc);
+ADD_TENSOR_CONVERT_TYPES(bgr_to_nhwc);
+
+#undef ADD_TENSOR_CONVERT_TYPES
+#undef ADD_TENSOR_CONVERT
+
+NAMESPACE_END
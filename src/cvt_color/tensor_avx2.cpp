@@ -0,0 +1,141 @@
+#include "image.hpp"
+#include "tensor.hpp"
+#include "types.hpp"
+#include "x86.hpp"
+#include "x86_pixel.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+NAMESPACE_BEGIN
+
+// The AVX2 tier also requires f16c
+#define TENSOR_FUNC __attribute__((target("avx2,f16c")))
+
+constexpr int32_t k_pixel_per_loop = 16;
+
+struct QuantVec {
+    __m256 m_scale;
+    __m256 m_min;
+    __m256 m_max;
+    __m256i m_zero_point;
+};
+
+// (x - mean) * scale of 8 bytes
+TENSOR_FUNC static inline __m256 normalize(__m128i val, __m256 mean, __m256 scale) {
+    auto x = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(val));
+    return _mm256_mul_ps(_mm256_sub_ps(x, mean), scale);
+}
+
+// Stores 8 elements from element idx on, same rounding as storeTensor
+template <TensorType T>
+TENSOR_FUNC static inline void storeTensor8(const QuantVec &quant, void *dst, size_t idx, __m256 v) {
+    if constexpr (TensorType::FLOAT32 == T) {
+        _mm256_storeu_ps(static_cast<float*>(dst) + idx, v);
+    } else if constexpr (TensorType::FLOAT16 == T) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(static_cast<uint16_t*>(dst) + idx),
+                         _mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+    } else if constexpr (TensorType::BFLOAT16 == T) {
+        auto x = _mm256_castps_si256(v);
+        auto odd = _mm256_and_si256(_mm256_srli_epi32(x, 16), _mm256_set1_epi32(1));
+        x = _mm256_srli_epi32(_mm256_add_epi32(x, _mm256_add_epi32(odd, _mm256_set1_epi32(0x7fff))), 16);
+        x = _mm256_permute4x64_epi64(_mm256_packus_epi32(x, x), 0x08);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(static_cast<uint16_t*>(dst) + idx), _mm256_castsi256_si128(x));
+    } else {
+        auto t = _mm256_min_ps(_mm256_max_ps(_mm256_div_ps(v, quant.m_scale), quant.m_min), quant.m_max);
+        auto x = _mm256_add_epi32(_mm256_cvtps_epi32(t), quant.m_zero_point);
+        x = _mm256_packs_epi32(x, x);
+        x = TensorType::INT8 == T ? _mm256_packs_epi16(x, x) : _mm256_packus_epi16(x, x);
+        auto q = _mm_unpacklo_epi32(_mm256_castsi256_si128(x), _mm256_extracti128_si256(x, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(static_cast<uint8_t*>(dst) + idx), q);
+    }
+}
+
+// Interleaves 8 r, g, b floats into o0 | o1 | o2. Per lane r0 g0 b0 r1 |
+// g1 b1 r2 g2 | b2 r3 g3 b3 are gathered from the channel pairs, then the
+// lanes are reordered so pixels 0-3 come before 4-7
+TENSOR_FUNC static inline void interleaveRgb(__m256 r, __m256 g, __m256 b, __m256 &o0, __m256 &o1, __m256 &o2) {
+    auto rg_lo = _mm256_unpacklo_ps(r, g);
+    auto rg_hi = _mm256_unpackhi_ps(r, g);
+    auto br_lo = _mm256_unpacklo_ps(b, r);
+    auto br_hi = _mm256_unpackhi_ps(b, r);
+    auto gb_lo = _mm256_unpacklo_ps(g, b);
+    auto gb_hi = _mm256_unpackhi_ps(g, b);
+    auto t0 = _mm256_shuffle_ps(rg_lo, br_lo, _MM_SHUFFLE(3, 0, 1, 0));
+    auto t1 = _mm256_shuffle_ps(gb_lo, rg_hi, _MM_SHUFFLE(1, 0, 3, 2));
+    auto t2 = _mm256_shuffle_ps(br_hi, gb_hi, _MM_SHUFFLE(3, 2, 3, 0));
+    o0 = _mm256_permute2f128_ps(t0, t1, 0x20);
+    o1 = _mm256_permute2f128_ps(t2, t0, 0x30);
+    o2 = _mm256_permute2f128_ps(t1, t2, 0x31);
+}
+
+template <ImageFormat S, TensorLayout L, TensorType T>
+TENSOR_FUNC static void rgbToTensorAvx2(const TensorParam &param, const uint8_t *src, void *dst, size_t plane, int32_t w) {
+    constexpr auto ch = getChannel<S>();
+    __m256 mean[3], scale[3];
+    for (int32_t c = 0; c < 3; ++c) {
+        mean[c] = _mm256_set1_ps(param.m_mean[c]);
+        scale[c] = _mm256_set1_ps(param.m_scale[c]);
+    }
+    const QuantVec quant{_mm256_set1_ps(param.m_quant_scale), _mm256_set1_ps(param.m_quant_min),
+                         _mm256_set1_ps(param.m_quant_max), _mm256_set1_epi32(param.m_zero_point)};
+    int32_t j = 0;
+    for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+        __m128i val[3];
+        loadRgb<S>(src + (j * ch), val[0], val[1], val[2]);
+        __m256 lo[3], hi[3];
+        for (int32_t c = 0; c < 3; ++c) {
+            lo[c] = normalize(val[c], mean[c], scale[c]);
+            hi[c] = normalize(_mm_srli_si128(val[c], 8), mean[c], scale[c]);
+        }
+        if constexpr (TensorLayout::NCHW == L) {
+            for (int32_t c = 0; c < 3; ++c) {
+                storeTensor8<T>(quant, dst, c * plane + j, lo[c]);
+                storeTensor8<T>(quant, dst, c * plane + j + 8, hi[c]);
+            }
+        } else {
+            __m256 o[3];
+            interleaveRgb(lo[0], lo[1], lo[2], o[0], o[1], o[2]);
+            for (int32_t k = 0; k < 3; ++k) {
+                storeTensor8<T>(quant, dst, j * 3 + k * 8, o[k]);
+            }
+            interleaveRgb(hi[0], hi[1], hi[2], o[0], o[1], o[2]);
+            for (int32_t k = 0; k < 3; ++k) {
+                storeTensor8<T>(quant, dst, j * 3 + 24 + k * 8, o[k]);
+            }
+        }
+    }
+    rgbToTensorRow<S, L, T>(param, src, dst, plane, j, w);
+}
+
+#define TENSOR_AVX2(S, L, T, SF, LF, TF)                                                        \
+    void S##_to_##L##_##T##_avx2(const TensorParam &param, const uint8_t *src, void *dst, size_t plane, int32_t w) \
+    {                                                                                           \
+        rgbToTensorAvx2<ImageFormat::SF, TensorLayout::LF, TensorType::TF>(param, src, dst, plane, w); \
+    }
+
+#define TENSOR_AVX2_TYPES(S, L, SF, LF)                                                         \
+    TENSOR_AVX2(S, L, f32, SF, LF, FLOAT32)                                                     \
+    TENSOR_AVX2(S, L, f16, SF, LF, FLOAT16)                                                     \
+    TENSOR_AVX2(S, L, bf16, SF, LF, BFLOAT16)                                                   \
+    TENSOR_AVX2(S, L, s8, SF, LF, INT8)                                                         \
+    TENSOR_AVX2(S, L, u8, SF, LF, UINT8)
+
+#define TENSOR_AVX2_TO(L, LF)                                                                   \
+    TENSOR_AVX2_TYPES(rgba, L, RGBA, LF)                                                        \
+    TENSOR_AVX2_TYPES(rgb, L, RGB, LF)                                                          \
+    TENSOR_AVX2_TYPES(bgra, L, BGRA, LF)                                                        \
+    TENSOR_AVX2_TYPES(bgr, L, BGR, LF)
+
+TENSOR_AVX2_TO(nchw, NCHW)
+TENSOR_AVX2_TO(nhwc, NHWC)
+
+#undef TENSOR_AVX2_TO
+#undef TENSOR_AVX2_TYPES
+#undef TENSOR_AVX2
+#undef TENSOR_FUNC
+
+NAMESPACE_END
+
+#endif
@@ -0,0 +1,153 @@
+#include "image.hpp"
+#include "neon_pixel.hpp"
+#include "tensor.hpp"
+#include "types.hpp"
+
+#ifdef __aarch64__
+
+#include <arm_neon.h>
+
+NAMESPACE_BEGIN
+
+constexpr int32_t k_pixel_per_loop = 16;
+
+struct QuantVec {
+    float32x4_t m_scale;
+    float32x4_t m_min;
+    float32x4_t m_max;
+    int32x4_t m_zero_point;
+};
+
+// (x - mean) * scale of 16 bytes, 4 per vector
+static inline float32x4x4_t normalize(uint8x16_t val, float32x4_t mean, float32x4_t scale) {
+    auto lo = vmovl_u8(vget_low_u8(val));
+    auto hi = vmovl_high_u8(val);
+    auto cvt = [=](uint32x4_t x) { return vmulq_f32(vsubq_f32(vcvtq_f32_u32(x), mean), scale); };
+    return float32x4x4_t{{cvt(vmovl_u16(vget_low_u16(lo))), cvt(vmovl_high_u16(lo)),
+                          cvt(vmovl_u16(vget_low_u16(hi))), cvt(vmovl_high_u16(hi))}};
+}
+
+// FLOAT16 or BFLOAT16 bits of 4 floats, same rounding as storeTensor
+template <TensorType T>
+static inline uint16x4_t toU16(float32x4_t v) {
+    if constexpr (TensorType::FLOAT16 == T) {
+        return vreinterpret_u16_f16(vcvt_f16_f32(v));
+    } else {
+        auto x = vreinterpretq_u32_f32(v);
+        auto odd = vandq_u32(vshrq_n_u32(x, 16), vdupq_n_u32(1));
+        return vaddhn_u32(x, vaddq_u32(odd, vdupq_n_u32(0x7fff)));
+    }
+}
+
+// INT8 or UINT8 bytes of 16 floats, same rounding as storeTensor
+template <TensorType T>
+static inline uint8x16_t quantize16(const QuantVec &quant, float32x4x4_t v) {
+    int16x8_t half[2];
+    for (int32_t k = 0; k < 2; ++k) {
+        int32x4_t x[2];
+        for (int32_t i = 0; i < 2; ++i) {
+            auto t = vminq_f32(vmaxq_f32(vdivq_f32(v.val[2 * k + i], quant.m_scale), quant.m_min), quant.m_max);
+            x[i] = vaddq_s32(vcvtnq_s32_f32(t), quant.m_zero_point);
+        }
+        half[k] = vcombine_s16(vqmovn_s32(x[0]), vqmovn_s32(x[1]));
+    }
+    if constexpr (TensorType::INT8 == T) {
+        return vreinterpretq_u8_s8(vcombine_s8(vqmovn_s16(half[0]), vqmovn_s16(half[1])));
+    } else {
+        return vcombine_u8(vqmovun_s16(half[0]), vqmovun_s16(half[1]));
+    }
+}
+
+template <ImageFormat S, TensorLayout L, TensorType T>
+static void rgbToTensorNeon(const TensorParam &param, const uint8_t *src, void *dst, size_t plane, int32_t w) {
+    constexpr auto ch = getChannel<S>();
+    float32x4_t mean[3], scale[3];
+    for (int32_t c = 0; c < 3; ++c) {
+        mean[c] = vdupq_n_f32(param.m_mean[c]);
+        scale[c] = vdupq_n_f32(param.m_scale[c]);
+    }
+    const QuantVec quant{vdupq_n_f32(param.m_quant_scale), vdupq_n_f32(param.m_quant_min),
+                         vdupq_n_f32(param.m_quant_max), vdupq_n_s32(param.m_zero_point)};
+    int32_t j = 0;
+    for (; j + k_pixel_per_loop <= w; j += k_pixel_per_loop) {
+        uint8x16_t val[3];
+        loadRgb<S>(src + (j * ch), val[0], val[1], val[2]);
+        float32x4x4_t v[3];
+        for (int32_t c = 0; c < 3; ++c) {
+            v[c] = normalize(val[c], mean[c], scale[c]);
+        }
+
+        // NHWC goes through the interleaving stores, 4, 8 or 16 pixels each
+        if constexpr (TensorType::FLOAT32 == T) {
+            auto *out = static_cast<float*>(dst);
+            for (int32_t k = 0; k < 4; ++k) {
+                if constexpr (TensorLayout::NCHW == L) {
+                    for (int32_t c = 0; c < 3; ++c) {
+                        vst1q_f32(out + c * plane + j + k * 4, v[c].val[k]);
+                    }
+                } else {
+                    vst3q_f32(out + (j + k * 4) * 3, float32x4x3_t{{v[0].val[k], v[1].val[k], v[2].val[k]}});
+                }
+            }
+        } else if constexpr (2 == getTensorElemSize<T>()) {
+            auto *out = static_cast<uint16_t*>(dst);
+            for (int32_t k = 0; k < 2; ++k) {
+                uint16x8_t h[3];
+                for (int32_t c = 0; c < 3; ++c) {
+                    h[c] = vcombine_u16(toU16<T>(v[c].val[k * 2]), toU16<T>(v[c].val[k * 2 + 1]));
+                }
+                if constexpr (TensorLayout::NCHW == L) {
+                    for (int32_t c = 0; c < 3; ++c) {
+                        vst1q_u16(out + c * plane + j + k * 8, h[c]);
+                    }
+                } else {
+                    vst3q_u16(out + (j + k * 8) * 3, uint16x8x3_t{{h[0], h[1], h[2]}});
+                }
+            }
+        } else {
+            auto *out = static_cast<uint8_t*>(dst);
+            uint8x16_t q[3];
+            for (int32_t c = 0; c < 3; ++c) {
+                q[c] = quantize16<T>(quant, v[c]);
+            }
+            if constexpr (TensorLayout::NCHW == L) {
+                for (int32_t c = 0; c < 3; ++c) {
+                    vst1q_u8(out + c * plane + j, q[c]);
+                }
+            } else {
+                vst3q_u8(out + j * 3, uint8x16x3_t{{q[0], q[1], q[2]}});
+            }
+        }
+    }
+    rgbToTensorRow<S, L, T>(param, src, dst, plane, j, w);
+}
+
+#define TENSOR_NEON(S, L, T, SF, LF, TF)                                                        \
+    void S##_to_##L##_##T##_neon(const TensorParam &param, const uint8_t *src, void *dst, size_t plane, int32_t w) \
+    {                                                                                           \
+        rgbToTensorNeon<ImageFormat::SF, TensorLayout::LF, TensorType::TF>(param, src, dst, plane, w); \
+    }
+
+#define TENSOR_NEON_TYPES(S, L, SF, LF)                                                         \
+    TENSOR_NEON(S, L, f32, SF, LF, FLOAT32)                                                     \
+    TENSOR_NEON(S, L, f16, SF, LF, FLOAT16)                                                     \
+    TENSOR_NEON(S, L, bf16, SF, LF, BFLOAT16)                                                   \
+    TENSOR_NEON(S, L, s8, SF, LF, INT8)                                                         \
+    TENSOR_NEON(S, L, u8, SF, LF, UINT8)
+
+#define TENSOR_NEON_TO(L, LF)                                                                   \
+    TENSOR_NEON_TYPES(rgba, L, RGBA, LF)                                                        \
+    TENSOR_NEON_TYPES(rgb, L, RGB, LF)                                                          \
+    TENSOR_NEON_TYPES(bgra, L, BGRA, LF)                                                        \
+    TENSOR_NEON_TYPES(bgr, L, BGR, LF)
+
+TENSOR_NEON_TO(nchw, NCHW)
+TENSOR_NEON_TO(nhwc, NHWC)
+
+#undef TENSOR_NEON_TO
+#undef TENSOR_NEON_TYPES
+#undef TENSOR_NEON
+
+NAMESPACE_END
+
+#endif
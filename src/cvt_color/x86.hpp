@@ -0,0 +1,75 @@
+#pragma once
+
+#include "types.hpp"
+#include "image.hpp"
+
+NAMESPACE_BEGIN
+
+// x86 kernels are built with per function target attributes so the rest
+// of the library keeps the baseline ISA and dispatch picks them at run time
+#define SSE41_FUNC __attribute__((target("sse4.1")))
+#define AVX2_FUNC __attribute__((target("avx2")))
+#define AVX512_FUNC __attribute__((target("avx2,avx512f,avx512bw")))
+
+#define ADD_IMG_CONVERT_AVX2(F) \
+    void F##_avx2(const Image&, const Image&)
+
+#define ADD_IMG_CONVERT_X86(F)                  \
+    void F##_avx2(const Image&, const Image&);  \
+    void F##_avx512(const Image&, const Image&)
+
+// yuv to rgb
+ADD_IMG_CONVERT_AVX2(yuyv_to_rgba);
+ADD_IMG_CONVERT_AVX2(yuyv_to_rgb);
+ADD_IMG_CONVERT_AVX2(yuyv_to_bgra);
+ADD_IMG_CONVERT_AVX2(yuyv_to_bgr);
+ADD_IMG_CONVERT_AVX2(uyvy_to_rgba);
+ADD_IMG_CONVERT_AVX2(uyvy_to_rgb);
+ADD_IMG_CONVERT_AVX2(uyvy_to_bgra);
+ADD_IMG_CONVERT_AVX2(uyvy_to_bgr);
+ADD_IMG_CONVERT_AVX2(i420_to_rgba);
+ADD_IMG_CONVERT_AVX2(i420_to_rgb);
+ADD_IMG_CONVERT_AVX2(i420_to_bgra);
+ADD_IMG_CONVERT_AVX2(i420_to_bgr);
+ADD_IMG_CONVERT_AVX2(nv12_to_rgba);
+ADD_IMG_CONVERT_AVX2(nv12_to_rgb);
+ADD_IMG_CONVERT_AVX2(nv12_to_bgra);
+ADD_IMG_CONVERT_AVX2(nv12_to_bgr);
+ADD_IMG_CONVERT_AVX2(nv21_to_rgba);
+ADD_IMG_CONVERT_AVX2(nv21_to_rgb);
+ADD_IMG_CONVERT_AVX2(nv21_to_bgra);
+ADD_IMG_CONVERT_AVX2(nv21_to_bgr);
+
+// rgb to yuv
+ADD_IMG_CONVERT_X86(rgba_to_yuyv);
+ADD_IMG_CONVERT_X86(rgba_to_uyvy);
+ADD_IMG_CONVERT_X86(rgba_to_i420);
+ADD_IMG_CONVERT_X86(rgba_to_nv12);
+ADD_IMG_CONVERT_X86(rgba_to_nv21);
+ADD_IMG_CONVERT_X86(rgb_to_yuyv);
+ADD_IMG_CONVERT_X86(rgb_to_uyvy);
+ADD_IMG_CONVERT_X86(rgb_to_i420);
+ADD_IMG_CONVERT_X86(rgb_to_nv12);
+ADD_IMG_CONVERT_X86(rgb_to_nv21);
+ADD_IMG_CONVERT_X86(bgra_to_yuyv);
+ADD_IMG_CONVERT_X86(bgra_to_uyvy);
+ADD_IMG_CONVERT_X86(bgra_to_i420);
+ADD_IMG_CONVERT_X86(bgra_to_nv12);
+ADD_IMG_CONVERT_X86(bgra_to_nv21);
+ADD_IMG_CONVERT_X86(bgr_to_yuyv);
+ADD_IMG_CONVERT_X86(bgr_to_uyvy);
+ADD_IMG_CONVERT_X86(bgr_to_i420);
+ADD_IMG_CONVERT_X86(bgr_to_nv12);
+ADD_IMG_CONVERT_X86(bgr_to_nv21);
+
+// layout swaps, alias safe
+ADD_IMG_CONVERT_AVX2(rgb_to_bgr);
+ADD_IMG_CONVERT_AVX2(bgr_to_rgb);
+ADD_IMG_CONVERT_AVX2(rgba_to_bgra);
+ADD_IMG_CONVERT_AVX2(bgra_to_rgba);
+ADD_IMG_CONVERT_AVX2(yuyv_to_uyvy);
+ADD_IMG_CONVERT_AVX2(uyvy_to_yuyv);
+ADD_IMG_CONVERT_AVX2(nv12_to_nv21);
+ADD_IMG_CONVERT_AVX2(nv21_to_nv12);
+
+NAMESPACE_END
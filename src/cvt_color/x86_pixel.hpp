@@ -0,0 +1,131 @@
+#pragma once
+
+#include "pixel.hpp"
+#include "types.hpp"
+#include "x86.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+NAMESPACE_BEGIN
+
+// 16 pixel loads and stores shared by the AVX2 kernels
+
+// Loads 16 Y and the 8 U/V samples shared by them, starting at pixel j
+template <ImageFormat S>
+AVX2_FUNC inline void loadYuv(const YuvRow &buf, int32_t j, __m128i &y, __m128i &u, __m128i &v) {
+    if constexpr (isSemiPlanar<S>()) {
+        const __m128i split = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+        y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf.m_y + j));
+        auto uv = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(buf.m_u + j)), split);
+        u = isVFirst<S>() ? _mm_srli_si128(uv, 8) : uv;
+        v = isVFirst<S>() ? uv : _mm_srli_si128(uv, 8);
+    } else if constexpr (!isPacked422<S>()) {
+        y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf.m_y + j));
+        u = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(buf.m_u + (j >> 1)));
+        v = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(buf.m_v + (j >> 1)));
+    } else {
+        // yuyv: y0 u y1 v, uyvy: u y0 v y1, sorted to 8 y | 4 u | 4 v
+        const __m128i split = ImageFormat::YUYV == S
+            ? _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 5, 9, 13, 3, 7, 11, 15)
+            : _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, 0, 4, 8, 12, 2, 6, 10, 14);
+        auto base = buf.m_y + (j << 1);
+        auto s0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(base)), split);
+        auto s1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(base + 16)), split);
+        y = _mm_unpacklo_epi64(s0, s1);
+        u = _mm_unpacklo_epi32(_mm_srli_si128(s0, 8), _mm_srli_si128(s1, 8));
+        v = _mm_unpacklo_epi32(_mm_srli_si128(s0, 12), _mm_srli_si128(s1, 12));
+    }
+}
+
+template <ImageFormat D>
+AVX2_FUNC inline void storeRgb(uint8_t *dst, __m128i c0, __m128i c1, __m128i c2) {
+    // Opaque alpha
+    auto c3 = _mm_set1_epi8(-1);
+    auto lo01 = _mm_unpacklo_epi8(c0, c1);
+    auto hi01 = _mm_unpackhi_epi8(c0, c1);
+    auto lo23 = _mm_unpacklo_epi8(c2, c3);
+    auto hi23 = _mm_unpackhi_epi8(c2, c3);
+    auto p0 = _mm_unpacklo_epi16(lo01, lo23);
+    auto p1 = _mm_unpackhi_epi16(lo01, lo23);
+    auto p2 = _mm_unpacklo_epi16(hi01, hi23);
+    auto p3 = _mm_unpackhi_epi16(hi01, hi23);
+    if constexpr (4 == getChannel<D>()) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 0), p0);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), p1);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), p2);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 48), p3);
+    } else {
+        // Drop every 4th byte, 4 x 12 bytes are glued into 3 x 16 bytes
+        const __m128i drop = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+        p0 = _mm_shuffle_epi8(p0, drop);
+        p1 = _mm_shuffle_epi8(p1, drop);
+        p2 = _mm_shuffle_epi8(p2, drop);
+        p3 = _mm_shuffle_epi8(p3, drop);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 0), _mm_or_si128(p0, _mm_slli_si128(p1, 12)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_or_si128(_mm_srli_si128(p1, 4), _mm_slli_si128(p2, 8)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 32), _mm_or_si128(_mm_srli_si128(p2, 8), _mm_slli_si128(p3, 4)));
+    }
+}
+
+// Loads 16 pixels and splits them into r, g and b
+template <ImageFormat S>
+AVX2_FUNC inline void loadRgb(const uint8_t *src, __m128i &r, __m128i &g, __m128i &b) {
+    __m128i p0, p1, p2, p3;
+    if constexpr (4 == getChannel<S>()) {
+        const __m128i split = _mm_setr_epi8(0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15);
+        p0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 0)), split);
+        p1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 16)), split);
+        p2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32)), split);
+        p3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 48)), split);
+    } else {
+        // 4 pixels per 12 bytes, the last group is loaded from byte 32 so
+        // nothing past the 48 bytes of the block is touched
+        const __m128i split0 = _mm_setr_epi8(0, 3, 6, 9, 1, 4, 7, 10, 2, 5, 8, 11, -1, -1, -1, -1);
+        const __m128i split1 = _mm_setr_epi8(4, 7, 10, 13, 5, 8, 11, 14, 6, 9, 12, 15, -1, -1, -1, -1);
+        p0 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 0)), split0);
+        p1 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 12)), split0);
+        p2 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 24)), split0);
+        p3 = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 32)), split1);
+    }
+    auto t0 = _mm_unpacklo_epi32(p0, p1);
+    auto t1 = _mm_unpacklo_epi32(p2, p3);
+    auto t2 = _mm_unpackhi_epi32(p0, p1);
+    auto t3 = _mm_unpackhi_epi32(p2, p3);
+    auto c0 = _mm_unpacklo_epi64(t0, t1);
+    auto c2 = _mm_unpacklo_epi64(t2, t3);
+    r = isBgr<S>() ? c2 : c0;
+    g = _mm_unpackhi_epi64(t0, t1);
+    b = isBgr<S>() ? c0 : c2;
+}
+
+// Stores 16 y with the 8 u/v of their pairs as yuyv or uyvy
+template <ImageFormat D>
+AVX2_FUNC inline void storeYuv422(uint8_t *dst, __m128i y, __m128i u, __m128i v) {
+    auto uv = _mm_unpacklo_epi8(u, v);
+    if constexpr (ImageFormat::YUYV == D) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 0), _mm_unpacklo_epi8(y, uv));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi8(y, uv));
+    } else {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 0), _mm_unpacklo_epi8(uv, y));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + 16), _mm_unpackhi_epi8(uv, y));
+    }
+}
+
+// Stores 8 u/v to the chroma row(s) of i420, nv12 or nv21
+template <ImageFormat D>
+AVX2_FUNC inline void storeUv420(uint8_t *u_buf, uint8_t *v_buf, __m128i u, __m128i v) {
+    if constexpr (ImageFormat::I420 == D) {
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(u_buf), u);
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(v_buf), v);
+    } else if constexpr (ImageFormat::NV12 == D) {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(u_buf), _mm_unpacklo_epi8(u, v));
+    } else {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(u_buf), _mm_unpacklo_epi8(v, u));
+    }
+}
+
+NAMESPACE_END
+
+#endif
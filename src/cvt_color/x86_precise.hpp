@@ -0,0 +1,88 @@
+#pragma once
+
+#include "pixel.hpp"
+#include "precise.hpp"
+#include "types.hpp"
+#include "x86.hpp"
+#include "x86_pixel.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+NAMESPACE_BEGIN
+
+// 16 pixel CvtPrecision::HIGH math shared by the AVX2 kernels
+
+AVX2_FUNC inline __m128i packPreciseU8(__m256i val) {
+    val = _mm256_srai_epi16(val, k_precise_shift);
+    return _mm_packus_epi16(_mm256_castsi256_si128(val), _mm256_extracti128_si256(val, 1));
+}
+
+// (C - 128) << 8 of 8 chroma samples, each repeated for its pixel pair
+AVX2_FUNC inline __m256i loadChroma(__m128i c) {
+    c = _mm_xor_si128(_mm_unpacklo_epi8(c, c), _mm_set1_epi8(static_cast<char>(0x80)));
+    return _mm256_slli_epi16(_mm256_cvtepu8_epi16(c), 8);
+}
+
+// Same math as yuvToRgbPreciseS16, chroma of each pixel in u16/v16
+AVX2_FUNC inline void yuvToRgb(const Yuv2RgbPreciseParam &param, __m128i y, __m256i u16, __m256i v16, __m128i &r, __m128i &g, __m128i &b) {
+    auto y16 = _mm256_cvtepu8_epi16(y);
+    auto t = _mm256_mulhi_epu16(_mm256_or_si256(y16, _mm256_slli_epi16(y16, 8)), _mm256_set1_epi16(static_cast<int16_t>(param.m_yg)));
+    t = _mm256_add_epi16(t, _mm256_set1_epi16(param.m_base));
+
+    auto vr = _mm256_mulhrs_epi16(v16, _mm256_set1_epi16(param.m_vr));
+    auto uvg = _mm256_add_epi16(_mm256_mulhrs_epi16(u16, _mm256_set1_epi16(param.m_ug)),
+                                _mm256_mulhrs_epi16(v16, _mm256_set1_epi16(param.m_vg)));
+    auto ub = _mm256_mulhrs_epi16(u16, _mm256_set1_epi16(param.m_ub));
+    r = packPreciseU8(_mm256_adds_epi16(t, vr));
+    g = packPreciseU8(_mm256_subs_epi16(t, uvg));
+    b = packPreciseU8(_mm256_adds_epi16(t, ub));
+}
+
+// storeRgb with r, g and b put in the channel order of D
+template <ImageFormat D>
+AVX2_FUNC inline void storeRgbOrdered(uint8_t *dst, __m128i r, __m128i g, __m128i b) {
+    if constexpr (isBgr<D>()) {
+        storeRgb<D>(dst, b, g, r);
+    } else {
+        storeRgb<D>(dst, r, g, b);
+    }
+}
+
+// Same math as rgbToYuvPrecise, y packed to u8 and u/v as int16
+AVX2_FUNC inline void rgbToYuv(const Rgb2YuvPreciseParam &param, __m128i r, __m128i g, __m128i b, __m128i &y, __m256i &u, __m256i &v) {
+    auto r16 = _mm256_slli_epi16(_mm256_cvtepu8_epi16(r), 7);
+    auto g16 = _mm256_slli_epi16(_mm256_cvtepu8_epi16(g), 7);
+    auto b16 = _mm256_slli_epi16(_mm256_cvtepu8_epi16(b), 7);
+
+    auto y16 = _mm256_add_epi16(_mm256_add_epi16(_mm256_mulhrs_epi16(r16, _mm256_set1_epi16(param.m_yr)),
+                                                 _mm256_mulhrs_epi16(g16, _mm256_set1_epi16(param.m_yg))),
+                                _mm256_mulhrs_epi16(b16, _mm256_set1_epi16(param.m_yb)));
+    y16 = _mm256_srai_epi16(_mm256_add_epi16(y16, _mm256_set1_epi16(param.m_y_ofs)), k_precise_shift);
+    y = _mm_packus_epi16(_mm256_castsi256_si128(y16), _mm256_extracti128_si256(y16, 1));
+
+    u = _mm256_sub_epi16(_mm256_mulhrs_epi16(b16, _mm256_set1_epi16(param.m_ub)),
+                         _mm256_add_epi16(_mm256_mulhrs_epi16(r16, _mm256_set1_epi16(param.m_ur)),
+                                          _mm256_mulhrs_epi16(g16, _mm256_set1_epi16(param.m_ug))));
+    v = _mm256_sub_epi16(_mm256_mulhrs_epi16(r16, _mm256_set1_epi16(param.m_vr)),
+                         _mm256_add_epi16(_mm256_mulhrs_epi16(g16, _mm256_set1_epi16(param.m_vg)),
+                                          _mm256_mulhrs_epi16(b16, _mm256_set1_epi16(param.m_vb))));
+}
+
+// Sum of each horizontal pair as int32
+AVX2_FUNC inline __m256i sumPair(__m256i val) {
+    return _mm256_madd_epi16(val, _mm256_set1_epi16(1));
+}
+
+// packChromaPrecise of 8 int32 sums, in the low 8 bytes
+AVX2_FUNC inline __m128i packChroma(__m256i sum, int32_t shift) {
+    sum = _mm256_srai_epi32(_mm256_add_epi32(sum, _mm256_set1_epi32(1 << (shift - 1))), shift);
+    sum = _mm256_add_epi32(sum, _mm256_set1_epi32(k_chroma_ofs));
+    auto val = _mm_packs_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    return _mm_packus_epi16(val, val);
+}
+
+NAMESPACE_END
+
+#endif
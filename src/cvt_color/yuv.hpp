@@ -1,25 +1,67 @@
 #pragma once
 
+#include "colorimetry.hpp"
+#include "image.hpp"
 #include "types.hpp"
 
 NAMESPACE_BEGIN
 
 constexpr uint8_t k_shift = 6U;
 constexpr uint8_t k_alpha = 255U;
-static const struct Yuv2RgbParam {  // NOLINT
-    uint8_t m_vr = 90;  // +
-    uint8_t m_ug = 22;  // -
-    uint8_t m_vg = 46;  // -
-    uint8_t m_ub = 113; // +
-    uint16_t m_ofs_r = 90*128;  // -
-    uint16_t m_ofs_g = (22 + 46) * 128; // +
-    uint16_t m_ofs_b = 113*128; // -
-} k_yuv_2_rgb{};
-
-#define LOAD_RGB_PARAM                                              \
-    "ld4r {v28.16b, v29.16b, v30.16b, v31.16b}, [%[param]], #4  \n" \
-    "ld3r {v25.8h, v26.8h, v27.8h}, [%[param]]                  \n"
-
-#define USED_RGB_REG "v25", "v26", "v27", "v28", "v29", "v30", "v31"
+struct Yuv2RgbParam {
+    uint8_t m_vr;       // +
+    uint8_t m_ug;       // -
+    uint8_t m_vg;       // -
+    uint8_t m_ub;       // +
+    uint16_t m_ofs_r;   // -
+    uint16_t m_ofs_g;   // +
+    uint16_t m_ofs_b;   // -
+    uint8_t m_yg;       // + y gain, 1 << k_shift for full range
+};
+
+// Coefficients of a matrix with luma weights kr/kb in k_shift fixed point,
+// the offsets fold in the 128 chroma bias and the 16 luma foot of the
+// limited range
+constexpr Yuv2RgbParam makeYuv2RgbParam(double kr, double kb, ColorRange range) {
+    constexpr double scale = 1 << k_shift;
+    auto limited = ColorRange::LIMITED == range;
+    auto ys = limited ? 255.0 / 219 : 1.0;
+    auto cs = limited ? 255.0 / 224 : 1.0;
+    auto y_ofs = limited ? 16 : 0;
+    auto kg = 1 - kr - kb;
+
+    auto vr = static_cast<int32_t>(2 * (1 - kr) * cs * scale + 0.5);
+    auto ug = static_cast<int32_t>(2 * (1 - kb) * kb / kg * cs * scale + 0.5);
+    auto vg = static_cast<int32_t>(2 * (1 - kr) * kr / kg * cs * scale + 0.5);
+    auto ub = static_cast<int32_t>(2 * (1 - kb) * cs * scale + 0.5);
+    auto yg = static_cast<int32_t>(ys * scale + 0.5);
+    return {
+        static_cast<uint8_t>(vr), static_cast<uint8_t>(ug), static_cast<uint8_t>(vg), static_cast<uint8_t>(ub),
+        static_cast<uint16_t>(vr * 128 + yg * y_ofs),
+        static_cast<uint16_t>((ug + vg) * 128 - yg * y_ofs),
+        static_cast<uint16_t>(ub * 128 + yg * y_ofs),
+        static_cast<uint8_t>(yg)
+    };
+}
+
+static constexpr auto k_yuv_2_rgb_param = makeColorSpaceTable<Yuv2RgbParam>(makeYuv2RgbParam);
+
+static_assert(90 == k_yuv_2_rgb_param[0].m_vr && 22 == k_yuv_2_rgb_param[0].m_ug &&
+              46 == k_yuv_2_rgb_param[0].m_vg && 113 == k_yuv_2_rgb_param[0].m_ub,
+              "BT.601 full range must keep the original coefficients");
+
+// Coefficients for converting the yuv image `img` to rgb
+inline const Yuv2RgbParam &getYuv2RgbParam(const Image &img) {
+    return k_yuv_2_rgb_param[getColorSpaceIdx(img)];
+}
+
+// x0 is scratch, every kernel loading the params clobbers it
+#define LOAD_RGB_PARAM                                          \
+    "ld4r {v28.16b, v29.16b, v30.16b, v31.16b}, [%[param]]  \n" \
+    "add x0, %[param], #4                                   \n" \
+    "ld3r {v25.8h, v26.8h, v27.8h}, [x0], #6                \n" \
+    "ld1r {v24.16b}, [x0]                                   \n"
+
+#define USED_RGB_REG "v24", "v25", "v26", "v27", "v28", "v29", "v30", "v31"
 
 NAMESPACE_END
@@ -0,0 +1,176 @@
+#pragma once
+
+#include <algorithm>
+#include "image.hpp"
+#include "precise.hpp"
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+// High bit depth yuv kernels. Samples are widened to 16 bits with the
+// value in the msbs, so 10 and 16 bit video range is the 8 bit one << 8
+// and the CvtPrecision::HIGH coefficients apply with (C16 - 32768) in
+// place of (C - 128) << 8. These kernels always use that arithmetic and
+// NEAREST chroma. Transfer functions (PQ, HLG) are not applied. The _c
+// kernels are bit exact to the SIMD ones.
+
+template <ImageFormat F>
+constexpr bool isYuv16420() {
+    return ImageFormat::P010 == F || ImageFormat::P016 == F || ImageFormat::I010 == F;
+}
+
+// I010 samples are shifted up on load
+template <ImageFormat F>
+constexpr int32_t getSampleShift() {
+    return ImageFormat::I010 == F ? 6 : 0;
+}
+
+// Rows feeding one output row, laid out like YuvRow
+struct Yuv16Row {
+    const uint16_t *m_y{nullptr};
+    const uint16_t *m_u{nullptr};
+    const uint16_t *m_v{nullptr};
+};
+
+template <ImageFormat S>
+inline Yuv16Row getYuv16Row(const Image &src, int32_t row) {
+    auto ptr = [&src](int32_t i, size_t plane) { return reinterpret_cast<const uint16_t*>(src.ptr(i, plane)); };
+    if constexpr (ImageFormat::I010 == S) {
+        return {ptr(row, 0), ptr(row >> 1, 1), ptr(row >> 1, 2)};
+    } else if constexpr (isYuv16420<S>()) {
+        return {ptr(row, 0), ptr(row >> 1, 1), nullptr};
+    } else {
+        return {ptr(row, 0), nullptr, nullptr};
+    }
+}
+
+// Msb aligned Y of pixel j and U/V of the pair starting at even pixel j
+template <ImageFormat S>
+inline void loadPair16(const Yuv16Row &buf, int32_t j, int32_t &y0, int32_t &y1, int32_t &u, int32_t &v) {
+    constexpr auto shift = getSampleShift<S>();
+    if constexpr (ImageFormat::I010 == S) {
+        y0 = buf.m_y[j];
+        y1 = buf.m_y[j + 1];
+        u = buf.m_u[j >> 1];
+        v = buf.m_v[j >> 1];
+    } else if constexpr (isYuv16420<S>()) {
+        y0 = buf.m_y[j];
+        y1 = buf.m_y[j + 1];
+        u = buf.m_u[j];
+        v = buf.m_u[j + 1];
+    } else {
+        auto pair = buf.m_y + (j << 1);
+        y0 = pair[0];
+        u = pair[1];
+        y1 = pair[2];
+        v = pair[3];
+    }
+    // Bits shifted past 16 are dropped like in the 16 bit SIMD lanes
+    y0 = static_cast<uint16_t>(y0 << shift);
+    y1 = static_cast<uint16_t>(y1 << shift);
+    u = static_cast<uint16_t>(u << shift);
+    v = static_cast<uint16_t>(v << shift);
+}
+
+// Rounded 8 bit sample of a msb aligned one
+constexpr uint8_t to8Bit(int32_t val) {
+    return static_cast<uint8_t>(std::min((val + 128) >> 8, 255));
+}
+
+// HIGH parameters of src with the luma gain of Y << 8 rather than Y * 257
+inline Yuv2RgbPreciseParam getYuv16ToRgbParam(const Image &src) {
+    auto param = getYuv2RgbPreciseParam(src);
+    constexpr double gain = 1 << (k_precise_shift + 8);
+    param.m_yg = static_cast<uint16_t>((ColorRange::LIMITED == src.colorRange() ? 255.0 / 219 : 1.0) * gain + 0.5);
+    return param;
+}
+
+// R, G and B with k_precise_shift fraction bits, like yuvToRgbPreciseS16
+inline void yuv16ToRgbS16(const Yuv2RgbPreciseParam &param, int32_t y, int32_t u, int32_t v, int32_t &r, int32_t &g, int32_t &b) {
+    auto t = static_cast<int32_t>((static_cast<uint32_t>(y) * param.m_yg) >> 16) + param.m_base;
+    u -= 32768;
+    v -= 32768;
+    r = saturate_s16(t + mulhrs(v, param.m_vr));
+    g = saturate_s16(t - (mulhrs(u, param.m_ug) + mulhrs(v, param.m_vg)));
+    b = saturate_s16(t + mulhrs(u, param.m_ub));
+}
+
+// Full scale 16 bit sample of one with k_precise_shift fraction bits and
+// the rounding of m_base, 255 << k_precise_shift maps to 65535
+constexpr uint16_t toRgb48(int32_t val) {
+    val = std::clamp(val - (1 << (k_precise_shift - 1)), 0, 255 << k_precise_shift);
+    return static_cast<uint16_t>((val << 2) + (val >> k_precise_shift));
+}
+
+template <ImageFormat D>
+inline void storeRgb16Pixel(uint8_t *dst, int32_t r, int32_t g, int32_t b) {
+    if constexpr (ImageFormat::RGB48 == D) {
+        auto pixel = reinterpret_cast<uint16_t*>(dst);
+        pixel[0] = toRgb48(r);
+        pixel[1] = toRgb48(g);
+        pixel[2] = toRgb48(b);
+    } else {
+        storeRgbPixel<D>(dst, saturate_u8(r >> k_precise_shift), saturate_u8(g >> k_precise_shift), saturate_u8(b >> k_precise_shift));
+    }
+}
+
+template <ImageFormat D>
+constexpr int32_t getPixelSize16() {
+    return ImageFormat::RGB48 == D ? 6 : getChannel<D>();
+}
+
+// Converts the pairs of a row from pixel j on
+template <ImageFormat S, ImageFormat D>
+inline void yuv16ToRgbRow(const Yuv2RgbPreciseParam &param, const Yuv16Row &buf, uint8_t *dst, int32_t j, int32_t w) {
+    constexpr auto size = getPixelSize16<D>();
+    for (; j + 2 <= w; j += 2) {
+        int32_t y0, y1, u, v, r, g, b;
+        loadPair16<S>(buf, j, y0, y1, u, v);
+        yuv16ToRgbS16(param, y0, u, v, r, g, b);
+        storeRgb16Pixel<D>(dst + (j * size), r, g, b);
+        yuv16ToRgbS16(param, y1, u, v, r, g, b);
+        storeRgb16Pixel<D>(dst + ((j + 1) * size), r, g, b);
+    }
+}
+
+// Converts the pairs of rows i and i + 1 to nv12 from pixel j on. 4:2:2
+// chroma is the rounded mean of both rows
+template <ImageFormat S>
+inline void yuv16ToNv12Row(const Yuv16Row &buf0, const Yuv16Row &buf1, uint8_t *y0, uint8_t *y1, uint8_t *uv, int32_t j, int32_t w) {
+    for (; j + 2 <= w; j += 2) {
+        int32_t y00, y01, y10, y11, u, v, u1, v1;
+        loadPair16<S>(buf0, j, y00, y01, u, v);
+        loadPair16<S>(buf1, j, y10, y11, u1, v1);
+        if constexpr (!isYuv16420<S>()) {
+            u = (u + u1 + 1) >> 1;
+            v = (v + v1 + 1) >> 1;
+        }
+        y0[j] = to8Bit(y00);
+        y0[j + 1] = to8Bit(y01);
+        y1[j] = to8Bit(y10);
+        y1[j + 1] = to8Bit(y11);
+        uv[j] = to8Bit(u);
+        uv[j + 1] = to8Bit(v);
+    }
+}
+
+#define ADD_IMG_CONVERT_YUV16(F)                \
+    void F##_c(const Image&, const Image&);     \
+    void F##_avx2(const Image&, const Image&)
+
+#define ADD_IMG_CONVERT_YUV16_FROM(S)           \
+    ADD_IMG_CONVERT_YUV16(S##_to_rgba);         \
+    ADD_IMG_CONVERT_YUV16(S##_to_rgb);          \
+    ADD_IMG_CONVERT_YUV16(S##_to_bgra);         \
+    ADD_IMG_CONVERT_YUV16(S##_to_bgr);          \
+    ADD_IMG_CONVERT_YUV16(S##_to_nv12);         \
+    ADD_IMG_CONVERT_YUV16(S##_to_rgb48)
+
+ADD_IMG_CONVERT_YUV16_FROM(p010);
+ADD_IMG_CONVERT_YUV16_FROM(p016);
+ADD_IMG_CONVERT_YUV16_FROM(i010);
+ADD_IMG_CONVERT_YUV16_FROM(y210);
+
+#undef ADD_IMG_CONVERT_YUV16_FROM
+
+NAMESPACE_END
@@ -0,0 +1,143 @@
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <vector>
+#include "frame_pool.hpp"
+
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+constexpr uint32_t k_nil = 0xffff'ffff;
+constexpr uint64_t k_index_mask = 0x0000'0000'ffff'ffff;
+constexpr uint8_t k_tag_shift = 32;
+// Room for the shared_ptr control block of a frame
+constexpr size_t k_slot_bytes = 128;
+
+// Treiber stack of frame indices, the top carries a tag that is bumped
+// on every push so a stale compare_exchange can not succeed (ABA)
+struct FramePool::State {
+    State(size_t n, ImageFormat img_fmt)
+        : frames(n)
+        , slots(new Slot[n])
+        , fmt{img_fmt}
+        , next(new std::atomic<uint32_t>[n])
+    {}
+
+    void push(uint32_t idx) {
+        auto head = top.load(std::memory_order_relaxed);
+        uint64_t val = 0;
+        do {
+            next[idx].store(static_cast<uint32_t>(head & k_index_mask), std::memory_order_relaxed);
+            val = (((head >> k_tag_shift) + 1) << k_tag_shift) | idx;
+        } while (!top.compare_exchange_weak(head, val, std::memory_order_release, std::memory_order_relaxed));
+        free_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    uint32_t pop() {
+        auto head = top.load(std::memory_order_acquire);
+        while (true) {
+            auto idx = static_cast<uint32_t>(head & k_index_mask);
+            if (k_nil == idx) {
+                return k_nil;
+            }
+            auto val = (head & ~k_index_mask) | next[idx].load(std::memory_order_relaxed);
+            if (top.compare_exchange_weak(head, val, std::memory_order_acq_rel, std::memory_order_acquire)) {
+                free_count.fetch_sub(1, std::memory_order_relaxed);
+                return idx;
+            }
+        }
+    }
+
+    // Control block of the FrameRef of each frame, see SlotAllocator
+    struct alignas(std::max_align_t) Slot {
+        std::byte m_bytes[k_slot_bytes];
+    };
+
+    std::vector<Image> frames;
+    std::unique_ptr<Slot[]> slots;
+    ImageFormat fmt{ImageFormat::END};
+    std::unique_ptr<std::atomic<uint32_t>[]> next;
+    std::atomic<uint64_t> top{k_nil};
+    std::atomic<size_t> free_count{0};
+};
+
+// Hands out the preallocated slot of a frame as its control block, so
+// acquire() does not allocate. Releasing the block is the last thing a
+// dropped FrameRef does, only then the frame goes back to the free list
+template <typename T, typename S>
+struct SlotAllocator {
+    using value_type = T;
+
+    SlotAllocator(std::shared_ptr<S> state, uint32_t idx)
+        : m_state{std::move(state)}
+        , m_idx{idx}
+    {}
+
+    template <typename U>
+    SlotAllocator(const SlotAllocator<U, S> &that)    // NOLINT
+        : m_state{that.m_state}
+        , m_idx{that.m_idx}
+    {}
+
+    T *allocate(size_t n) {
+        static_assert(sizeof(T) <= k_slot_bytes && alignof(T) <= alignof(typename S::Slot));
+        if (1 != n) {
+            throw std::bad_alloc();
+        }
+        return reinterpret_cast<T*>(m_state->slots[m_idx].m_bytes);   // NOLINT
+    }
+
+    void deallocate(T*, size_t) {
+        m_state->push(m_idx);
+    }
+
+    template <typename U>
+    bool operator==(const SlotAllocator<U, S> &that) const {
+        return m_state == that.m_state && m_idx == that.m_idx;
+    }
+
+    std::shared_ptr<S> m_state;
+    uint32_t m_idx;
+};
+
+FramePool::FramePool(int32_t h, int32_t w, ImageFormat fmt, size_t n, const ImagePitch& pitch)
+{
+    if (0 == n || n >= k_nil) {
+        throw std::invalid_argument("Invalid frame pool capacity");
+    }
+
+    state_ = std::make_shared<State>(n, fmt);
+    for (uint32_t i = 0; i < n; ++i) {
+        state_->frames[i].create(h, w, fmt, nullptr, pitch);
+        state_->push(i);
+    }
+}
+
+FrameRef FramePool::acquire() {
+    auto idx = state_->pop();
+    if (k_nil == idx) {
+        return nullptr;
+    }
+
+    // The deleter resets the tags a user may have changed, the allocator
+    // keeps the state alive and recycles the frame
+    auto fmt = state_->fmt;
+    auto reset = [fmt](Image *img) {
+        img->setFmt(fmt);
+        img->setColorSpace(ColorMatrix::BT601, ColorRange::FULL);
+        img->setChromaSiting(ChromaSiting::LEFT);
+    };
+    return {&state_->frames[idx], reset, SlotAllocator<Image, State>{state_, idx}};
+}
+
+size_t FramePool::capacity() const {
+    return state_->frames.size();
+}
+
+size_t FramePool::available() const {
+    return state_->free_count.load(std::memory_order_relaxed);
+}
+
+NAMESPACE_END
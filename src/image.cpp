@@ -1,4 +1,5 @@
 #include <array>
+#include <stdexcept>
 #include <string>
 #include "image.hpp"
 
@@ -10,11 +11,19 @@ constexpr uint8_t k_own_ptr_shift = 63;
 constexpr uint64_t k_own_ptr_mask = 1LU << k_own_ptr_shift;
 constexpr uint8_t k_img_fmt_shift = 56;
 constexpr uint64_t k_img_fmt_mask = (0x7fLU) << k_img_fmt_shift;
+constexpr uint8_t k_color_range_shift = 52;
+constexpr uint64_t k_color_range_mask = (0xfLU) << k_color_range_shift;
+constexpr uint8_t k_color_matrix_shift = 48;
+constexpr uint64_t k_color_matrix_mask = (0xfLU) << k_color_matrix_shift;
+constexpr uint8_t k_chroma_siting_shift = 44;
+constexpr uint64_t k_chroma_siting_mask = (0xfLU) << k_chroma_siting_shift;
 constexpr uint64_t k_img_size_mask    = 0x0000'00ff'ffff'ffff;
 
 static const std::array<std::string, getValueOf(ImageFormat::END) + 1> g_fmt_name{
     "gray", "rgba", "rgb", "bgra", "bgr",
     "yuyv", "uyvy", "i420", "nv12", "nv21",
+    "p010", "p016", "i010", "y210", "rgb48",
+    "nv16", "nv24", "i422", "i444", "yv12",
     "end"
 };
 
@@ -51,69 +60,309 @@ size_t getImgStride(int32_t w, ImageFormat fmt) {
         case ImageFormat::I420:
         case ImageFormat::NV12:
         case ImageFormat::NV21:
+        case ImageFormat::YV12:
             return (3UL * w) >> 1;
+        case ImageFormat::NV16:
+        case ImageFormat::I422:
+            return 2UL * w;
+        case ImageFormat::NV24:
+        case ImageFormat::I444:
+            return 3UL * w;
+        case ImageFormat::P010:
+        case ImageFormat::P016:
+        case ImageFormat::I010:
+            return 3UL * w;
+        case ImageFormat::Y210:
+            return 4UL * w;
+        case ImageFormat::RGB48:
+            return 6UL * w;
         case ImageFormat::END:
-            return 0;
+            break;
     }
+    return 0;
 }
 
 size_t getImgSize(int32_t w, int32_t h, ImageFormat fmt) {
-    return getImgStride(w, fmt) * h;
+    size_t size = 0;
+    for (size_t i = 0; i < getImgPlanes(fmt); ++i) {
+        size += getPlaneStride(w, fmt, i) * getPlaneRows(h, fmt, i);
+    }
+    return size;
+}
+
+size_t getImgPlanes(ImageFormat fmt) {
+    switch (fmt) {
+        case ImageFormat::I420:
+        case ImageFormat::I010:
+        case ImageFormat::I422:
+        case ImageFormat::I444:
+        case ImageFormat::YV12:
+            return 3;
+        case ImageFormat::NV12:
+        case ImageFormat::NV21:
+        case ImageFormat::P010:
+        case ImageFormat::P016:
+        case ImageFormat::NV16:
+        case ImageFormat::NV24:
+            return 2;
+        case ImageFormat::END:
+            return 0;
+        default:
+            return 1;
+    }
+}
+
+size_t getPlaneStride(int32_t w, ImageFormat fmt, size_t plane) {
+    if (plane >= getImgPlanes(fmt)) {
+        return 0;
+    }
+    switch (fmt) {
+        case ImageFormat::I420:
+        case ImageFormat::I422:
+        case ImageFormat::YV12:
+            return 0 == plane ? 1UL * w : (1UL * w + 1) >> 1;
+        case ImageFormat::I444:
+            return 1UL * w;
+        case ImageFormat::NV12:
+        case ImageFormat::NV21:
+        case ImageFormat::NV16:
+            return 0 == plane ? 1UL * w : ((1UL * w + 1) >> 1) << 1;
+        case ImageFormat::NV24:
+            return 0 == plane ? 1UL * w : 2UL * w;
+        case ImageFormat::I010:
+            return 0 == plane ? 2UL * w : ((1UL * w + 1) >> 1) << 1;
+        case ImageFormat::P010:
+        case ImageFormat::P016:
+            return 0 == plane ? 2UL * w : ((1UL * w + 1) >> 1) << 2;
+        default:
+            return getImgStride(w, fmt);
+    }
+}
+
+int32_t getPlaneRows(int32_t h, ImageFormat fmt, size_t plane) {
+    if (plane >= getImgPlanes(fmt)) {
+        return 0;
+    }
+    // Only 4:2:0 halves the chroma rows
+    switch (fmt) {
+        case ImageFormat::NV16:
+        case ImageFormat::NV24:
+        case ImageFormat::I422:
+        case ImageFormat::I444:
+            return h;
+        default:
+            return 0 == plane ? h : (h + 1) >> 1;
+    }
 }
 
-Image::Image(int32_t h, int32_t w, ImageFormat fmt, uint8_t* data)
-    : width_{w}
-    , height_{h}
-    , flag_{(static_cast<uint64_t>(fmt) << k_img_fmt_shift) | (getImgSize(w, h, fmt) & k_img_size_mask)}
-    , data_{data}
+Image::Image(int32_t h, int32_t w, ImageFormat fmt, uint8_t* data, const ImagePitch& pitch)
 {
+    create(h, w, fmt, data, pitch);
+}
+
+Image::Image(int32_t h, int32_t w, ImageFormat fmt, const ImagePlanes& planes, const ImagePitch& pitch)
+{
+    create(h, w, fmt, planes, pitch);
 }
 
 Image::Image(Image&& that) noexcept
     : width_{that.width_}
     , height_{that.height_}
     , flag_{that.flag_}
-    , data_{that.data_}
+    , planes_{that.planes_}
+    , allocator_{that.allocator_}
+    , pitch_{that.pitch_}
 {
-    that.data_ = nullptr;
+    that.planes_.fill(nullptr);
+    that.flag_ &= ~k_own_ptr_mask;
 }
 
 Image& Image::operator=(Image&& rhs) noexcept {
     if (this != &rhs) {
+        release();
         width_ = rhs.width_;
         height_ = rhs.height_;
         flag_ = rhs.flag_;
-        data_ = rhs.data_;
-        rhs.data_ = nullptr;
+        planes_ = rhs.planes_;
+        allocator_ = rhs.allocator_;
+        pitch_ = rhs.pitch_;
+        rhs.planes_.fill(nullptr);
+        rhs.flag_ &= ~k_own_ptr_mask;
     }
     return *this;
 }
 
 Image::~Image() {
+    release();
+}
+
+void Image::release() {
+    // An owned image is a single allocation starting at plane 0
     if (0 != (k_own_ptr_mask & flag_)) {
-        delete[] data_;
-        data_ = nullptr;
+        allocator_->deallocate(planes_[0], size());
+        flag_ &= ~k_own_ptr_mask;
+    }
+    planes_.fill(nullptr);
+}
+
+// Formats with 16 bit samples
+static bool is16Bit(ImageFormat fmt) {
+    return ImageFormat::P010 == fmt || ImageFormat::P016 == fmt || ImageFormat::I010 == fmt ||
+           ImageFormat::Y210 == fmt || ImageFormat::RGB48 == fmt;
+}
+
+// 16 bit samples are read as uint16_t, so their planes start at even
+// addresses
+static void checkPlanePtr(ImageFormat fmt, const uint8_t *ptr) {
+    if (is16Bit(fmt) && 0 != reinterpret_cast<uintptr_t>(ptr) % 2) {
+        throw std::invalid_argument("Plane pointer of a 16 bit format must be 2 byte aligned");
     }
 }
 
-void Image::create(int32_t h, int32_t w, ImageFormat fmt, uint8_t* data) {
+// Row pitch of every plane of a w wide image, throws for a pitch below the
+// row size
+static ImagePitch getImgPitch(int32_t w, ImageFormat fmt, const ImagePitch& pitch) {
+    ImagePitch tmp{};
+    for (size_t i = 0; i < getImgPlanes(fmt); ++i) {
+        auto min_pitch = getPlaneStride(w, fmt, i);
+        if (0 != pitch[i]) {
+            tmp[i] = pitch[i];
+        } else if (0 == i || 0 == pitch[0]) {
+            tmp[i] = min_pitch;
+        } else {
+            // Chroma planes follow the luma pitch unless given explicitly
+            switch (fmt) {
+                case ImageFormat::I420:
+                case ImageFormat::I422:
+                case ImageFormat::YV12:
+                    tmp[i] = (pitch[0] + 1) >> 1;
+                    break;
+                case ImageFormat::I010:
+                    // Half the samples, rounded up, of 2 bytes each
+                    tmp[i] = (((pitch[0] >> 1) + 1) >> 1) << 1;
+                    break;
+                case ImageFormat::NV24:
+                    tmp[i] = pitch[0] << 1;
+                    break;
+                default:
+                    tmp[i] = pitch[0];
+                    break;
+            }
+        }
+        if (tmp[i] < min_pitch) {
+            throw std::invalid_argument("Pitch must not be less than row size");
+        }
+        if (is16Bit(fmt) && 0 != tmp[i] % 2) {
+            throw std::invalid_argument("Pitch of a 16 bit format must be even");
+        }
+    }
+    return tmp;
+}
+
+void Image::create(int32_t h, int32_t w, ImageFormat fmt, uint8_t* data, const ImagePitch& pitch) {
+    // Validated first, a throw leaves the image untouched
+    auto img_pitch = getImgPitch(w, fmt, pitch);
+    checkPlanePtr(fmt, data);
+    release();
     width_ = w;
     height_ = h;
-    flag_ = (static_cast<uint64_t>(fmt) << k_img_fmt_shift) | (getImgSize(w, h, fmt) & k_img_size_mask);
-    delete[] data_;
+    flag_ = static_cast<uint64_t>(fmt) << k_img_fmt_shift;
+    pitch_ = img_pitch;
+
+    size_t size = 0;
+    for (size_t i = 0; i < planes(); ++i) {
+        size += pitch_[i] * getPlaneRows(h, fmt, i);
+    }
+    flag_ |= size & k_img_size_mask;
+
     if (nullptr == data) {
-        data_ = new uint8_t[getImgSize(w, h, fmt)];
+        allocator_ = getDefaultAllocator();
+        data = allocator_->allocate(size);
         flag_ |= k_own_ptr_mask;
-    } else {
-        data_ = data;
-        flag_ &= ~k_own_ptr_mask;
+    }
+    for (size_t i = 0; i < planes(); ++i) {
+        planes_[i] = data;
+        data += pitch_[i] * getPlaneRows(h, fmt, i);
     }
 }
 
+void Image::create(int32_t h, int32_t w, ImageFormat fmt, const ImagePlanes& planes, const ImagePitch& pitch) {
+    for (size_t i = 0; i < getImgPlanes(fmt); ++i) {
+        if (nullptr == planes[i]) {
+            throw std::invalid_argument("Plane pointer must not be null");
+        }
+        checkPlanePtr(fmt, planes[i]);
+    }
+    auto img_pitch = getImgPitch(w, fmt, pitch);
+
+    release();
+    width_ = w;
+    height_ = h;
+    flag_ = static_cast<uint64_t>(fmt) << k_img_fmt_shift;
+    pitch_ = img_pitch;
+
+    size_t size = 0;
+    for (size_t i = 0; i < this->planes(); ++i) {
+        size += pitch_[i] * getPlaneRows(h, fmt, i);
+        planes_[i] = planes[i];
+    }
+    flag_ |= size & k_img_size_mask;
+}
+
 Image Image::clone() const {
     Image tmp;
     tmp.create(height_, width_, fmt());
-    std::copy_n(data_, size(), tmp.data());
+    tmp.setColorSpace(colorMatrix(), colorRange());
+    tmp.setChromaSiting(chromaSiting());
+    for (size_t i = 0; i < planes(); ++i) {
+        auto row_size = getPlaneStride(width_, fmt(), i);
+        for (int32_t j = 0; j < getPlaneRows(height_, fmt(), i); ++j) {
+            std::copy_n(ptr(j, i), row_size, tmp.ptr(j, i));
+        }
+    }
+    return tmp;
+}
+
+Image Image::roi(int32_t x, int32_t y, int32_t w, int32_t h) const {
+    if (x < 0 || y < 0 || w <= 0 || h <= 0 || x + w > width_ || y + h > height_) {
+        throw std::invalid_argument("ROI must lie inside the image");
+    }
+
+    auto fmt = this->fmt();
+    switch (fmt) {
+        case ImageFormat::I420:
+        case ImageFormat::NV12:
+        case ImageFormat::NV21:
+        case ImageFormat::P010:
+        case ImageFormat::P016:
+        case ImageFormat::I010:
+        case ImageFormat::YV12:
+            if (0 != (y & 1)) {
+                throw std::invalid_argument("ROI must start on an even row for 4:2:0");
+            }
+            [[fallthrough]];
+        case ImageFormat::YUYV:
+        case ImageFormat::UYVY:
+        case ImageFormat::Y210:
+        case ImageFormat::NV16:
+        case ImageFormat::I422:
+            if (0 != (x & 1)) {
+                throw std::invalid_argument("ROI must start on an even column for subsampled chroma");
+            }
+            break;
+        default:
+            break;
+    }
+
+    // Even offsets map exactly onto the chroma grid, so the plane size
+    // helpers give the byte/row offset of the corner in every plane
+    ImagePlanes planes{};
+    for (size_t i = 0; i < this->planes(); ++i) {
+        planes[i] = ptr(getPlaneRows(y, fmt, i), i) + getPlaneStride(x, fmt, i);
+    }
+    Image tmp{h, w, fmt, planes, pitch_};
+    tmp.setColorSpace(colorMatrix(), colorRange());
+    tmp.setChromaSiting(chromaSiting());
     return tmp;
 }
 
@@ -126,8 +375,12 @@ int32_t Image::cols() const {
     return width_;
 }
 
-uint8_t* Image::data() const {
-    return data_;
+uint8_t* Image::data(size_t plane) const {
+    return planes_[plane];
+}
+
+uint8_t* Image::ptr(int32_t row, size_t plane) const {
+    return data(plane) + pitch_[plane] * row;
 }
 
 size_t Image::pixels() const {
@@ -138,12 +391,76 @@ size_t Image::size() const {
     return flag_ & k_img_size_mask;
 }
 
-size_t Image::stride() const {
-    return getImgStride(width_, fmt());
+size_t Image::stride(size_t plane) const {
+    return pitch_[plane];
+}
+
+size_t Image::planes() const {
+    return getImgPlanes(fmt());
+}
+
+bool Image::isContinuous() const {
+    for (size_t i = 0; i < planes(); ++i) {
+        if (pitch_[i] != getPlaneStride(width_, fmt(), i)) {
+            return false;
+        }
+    }
+    return true;
 }
 
 ImageFormat Image::fmt() const {
     return static_cast<ImageFormat>((flag_ & k_img_fmt_mask) >> k_img_fmt_shift);
 }
 
+void Image::setFmt(ImageFormat fmt) {
+    if (fmt >= ImageFormat::END) {
+        throw std::invalid_argument("Unsupported image format");
+    }
+    auto cur = this->fmt();
+    if (getImgPlanes(fmt) != getImgPlanes(cur)) {
+        throw std::invalid_argument("Image layout must match");
+    }
+    for (size_t p = 0; p < getImgPlanes(fmt); ++p) {
+        if (getPlaneStride(width_, fmt, p) != getPlaneStride(width_, cur, p) ||
+            getPlaneRows(height_, fmt, p) != getPlaneRows(height_, cur, p)) {
+            throw std::invalid_argument("Image layout must match");
+        }
+        if (is16Bit(fmt) && 0 != pitch_[p] % 2) {
+            throw std::invalid_argument("Pitch of a 16 bit format must be even");
+        }
+        checkPlanePtr(fmt, planes_[p]);
+    }
+    flag_ &= ~k_img_fmt_mask;
+    flag_ |= static_cast<uint64_t>(fmt) << k_img_fmt_shift;
+}
+
+ColorMatrix Image::colorMatrix() const {
+    return static_cast<ColorMatrix>((flag_ & k_color_matrix_mask) >> k_color_matrix_shift);
+}
+
+ColorRange Image::colorRange() const {
+    return static_cast<ColorRange>((flag_ & k_color_range_mask) >> k_color_range_shift);
+}
+
+void Image::setColorSpace(ColorMatrix matrix, ColorRange range) {
+    if (matrix >= ColorMatrix::END || range >= ColorRange::END) {
+        throw std::invalid_argument("Unsupported color space");
+    }
+    flag_ &= ~(k_color_matrix_mask | k_color_range_mask);
+    flag_ |= static_cast<uint64_t>(matrix) << k_color_matrix_shift;
+    flag_ |= static_cast<uint64_t>(range) << k_color_range_shift;
+}
+
+ChromaSiting Image::chromaSiting() const {
+    return static_cast<ChromaSiting>((flag_ & k_chroma_siting_mask) >> k_chroma_siting_shift);
+}
+
+void Image::setChromaSiting(ChromaSiting siting) {
+    if (siting >= ChromaSiting::END) {
+        throw std::invalid_argument("Unsupported chroma siting");
+    }
+    flag_ &= ~k_chroma_siting_mask;
+    flag_ |= static_cast<uint64_t>(siting) << k_chroma_siting_shift;
+}
+
 NAMESPACE_END
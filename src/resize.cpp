@@ -2,12 +2,18 @@
 #include "types.hpp"
 #include <cmath>
 #include <cstddef>
+#include <stdexcept>
 #include <vector>
 #include "image.hpp"
+#include "resize/area.hpp"
+#include "resize/bilinear.hpp"
+#include "resize/filter.hpp"
+#include "resize/nearest.hpp"
 
 NAMESPACE_BEGIN
 
-constexpr uint8_t k_shift = 7;
+#ifdef __aarch64__
+constexpr uint8_t k_shift = k_bilinear_shift;
 
 #define ST3_LAN1_OFS(REG, D0, D1, D2)                     \
     "st3 {"#D0".b, "#D1".b, "#D2".b}[0], ["#REG"], #3 \n"
@@ -66,232 +72,6 @@ constexpr uint8_t k_shift = 7;
     "uaddlp "#V".8h, "#V".16b                         \n" \
     "uqrshrn "#V".8b, "#V".8h, #1                     \n"
 
-class ResizeBuffer {
- public:
-    ResizeBuffer(ResizeParam param, int32_t src, int32_t dst, int32_t channel = 1)
-        : stride_{dst * channel}
-        , buff_((1L + sizeof(int32_t)) * dst, 0)
-    {
-        constexpr auto scale = 1U << k_shift;
-        auto param_buf = getParam();
-        auto start_buf = getStart();
-        auto scale_d = static_cast<double>(src) / dst;
-        if (param.m_half_pixel) {
-            for (int32_t i = 0; i < dst; ++i) {
-                auto src_f = ((static_cast<double>(i) + 0.5F) * scale_d) - 0.5F;
-                auto src_floor = static_cast<int32_t>(std::floor(src_f));
-                auto alpha = static_cast<decltype(scale)>(scale * (src_f - src_floor));
-                if (src_floor < 0) {
-                    src_floor = 0;
-                    alpha = 0;
-                } else if (src_floor >= src - 1) {
-                    src_floor = src - 2;
-                    alpha = scale;
-                }
-                param_buf[i] = scale - alpha;
-                start_buf[i] = src_floor * channel;
-            }
-        } else if (param.m_align_corner) {}
-    }
-
-    uint8_t *getParam() {
-        return buff_.data() + (sizeof(int32_t) * stride_);
-    }
-
-    int32_t *getStart() {
-        return reinterpret_cast<int32_t*>(buff_.data());    // NOLINT
-    }
- private:
-    int32_t stride_{0};
-    std::vector<uint8_t> buff_;
-};
-/*
-
-void resize_comm_c1(const Image& src, const Image &dst) {
-    auto dw = dst.cols();
-    auto dh = dst.rows();
-    ResizeBuffer buff(src.cols(), src.rows(), dw, dh, 1);
-    auto ss = src.stride();
-    auto w_remain = dw & 0x7;
-    auto w8 = dw - w_remain;
-
-    auto src_ptr = src.data();
-    auto dst_ptr = dst.data();
-    auto alpha = buff.getAlpha();
-    auto beta = buff.getBeta();
-    auto cache = buff.getCache();
-    auto start_w = buff.startW();
-    auto start_h = buff.startH();
-
-    #undef LOAD_LINE0
-    #define LOAD_LINE0(OFS, IDX, REG)           \
-        "ldrsw "#REG", [x8, #"#OFS"]        \n" \
-        "add "#REG", x0, "#REG"             \n" \
-        "ld2 {v4.b, v5.b}["#IDX"], ["#REG"] \n"
-
-    #undef LOAD_LINE1
-    #define LOAD_LINE1(IDX, REG)                \
-        "add "#REG", "#REG", %[ss]          \n" \
-        "ld2 {v6.b, v7.b}["#IDX"], ["#REG"] \n"
-
-    #undef LOAD_8_LINE0
-    #define LOAD_8_LINE0                        \
-        LOAD_LINE0(-32, 0, x9)                  \
-        LOAD_LINE0(-28, 1, x10)                 \
-        LOAD_LINE0(-24, 2, x11)                 \
-        LOAD_LINE0(-20, 3, x12)                 \
-        LOAD_LINE0(-16, 4, x13)                 \
-        LOAD_LINE0(-12, 5, x14)                 \
-        LOAD_LINE0(-8, 6, x15)                  \
-        LOAD_LINE0(-4, 7, x16)
-
-    #undef LOAD_8_LINE1
-    #define LOAD_8_LINE1                        \
-        LOAD_LINE1(0, x9)                       \
-        LOAD_LINE1(1, x10)                      \
-        LOAD_LINE1(2, x11)                      \
-        LOAD_LINE1(3, x12)                      \
-        LOAD_LINE1(4, x13)                      \
-        LOAD_LINE1(5, x14)                      \
-        LOAD_LINE1(6, x15)                      \
-        LOAD_LINE1(7, x16)
-
-    #undef CALC_LINE
-    #define CALC_LINE(D, S0, S1)                \
-        "umull "#D".8h, "#S0".8b, v2.8b     \n" \
-        "umlal "#D".8h, "#S1".8b, v3.8b     \n" \
-        "uqrshrn "#D".8b, "#D".8h, %[shift] \n"
-
-    #undef CALC_2_LINE
-    #define CALC_2_LINE(D, S0, S1)              \
-        "umull "#D".8h, "#S0".8b, v0.8b     \n" \
-        "umlal "#D".8h, "#S1".8b, v1.8b     \n" \
-        "uqrshrn "#D".8b, "#D".8h, %[shift] \n"
-
-    asm volatile(
-        R"(
-                            // x0 --> src0
-        mov x1, xzr         // x1 --> h loop control
-        mov x2, #-1         // x2 --> prev_h
-                            // x3 --> current h
-                            // x4 --> w loop control
-                            // x5 --> w + 8
-                            // x6 --> alpha addr
-        mov x7, %[cache]    // x7 --> cache addr
-        movi v31.8b, #1     // v31.8b
-        shl v31.8b, v31.8b, %[shift]
-        b RC_C1_H
-    RC_C1_H_PRE:
-        add x2, x3, #1
-        mov x7, %[cache]
-        add x1, x1, #1
-    RC_C1_H:
-        cmp x1, %[h]
-        bge RC_C1_END
-        ldrsw x3, [%[start_h], x1, lsl #2]  // h
-        madd x0, x3, %[ss], %0              // src0
-        ld1r {v0.8b}, [%[beta]], #1              // beta_vec
-        sub v1.8b, v31.8b, v0.8b
-        mov x4, xzr
-        mov x6, %[alpha]                    // alpha
-        cmp x2, x3
-        beq RC_C1_H_CACHE_PRE
-
-        RC_C1_H_L8:
-            add x5, x4, #8
-            cmp x5, %[w8]
-            bgt RC_C1_H_REMAIN
-            ld1 {v2.8b}, [x6], #8
-            sub v3.8b, v31.8b, v2.8b
-            add x8, %[start_w], x5, lsl #2
-        )"
-            LOAD_8_LINE0
-            CALC_LINE(v4, v4, v5)
-            "prfm pldl1keep, [x9, 448]  \n"
-            LOAD_8_LINE1
-            CALC_LINE(v5, v6, v7)
-            "prfm pldl1keep, [x9, 448]  \n"
-            "st1 {v5.8b}, [x7], #8      \n"
-            CALC_2_LINE(v6, v4, v5)
-        R"(
-            st1 {v6.8b}, [%1], #8
-            mov x4, x5
-            b RC_C1_H_L8
-
-        RC_C1_H_REMAIN:
-            cbz %[w_remain], RC_C1_H_PRE
-            sub x5, %[w_remain], #8
-            add x6, x6, x5
-            add x7, x7, x5
-            add %1, %1, x5
-            add x5, x4, x5
-            ld1 {v2.8b}, [x6], #8
-            sub v3.8b, v31.8b, v2.8b
-            add x8, %[start_w], x5, lsl #2
-        )"
-            LOAD_8_LINE0
-            CALC_LINE(v4, v4, v5)
-            LOAD_8_LINE1
-            CALC_LINE(v5, v6, v7)
-            "st1 {v5.8b}, [x7], #8      \n"
-            CALC_2_LINE(v6, v4, v5)
-        R"(
-            st1 {v6.8b}, [%1], #8
-            b RC_C1_H_PRE
-
-        RC_C1_H_CACHE_PRE:
-            add x0, x0, %[ss]
-        RC_C1_H_CACHE_L8:
-            add x5, x4, #8
-            cmp x5, %[w8]
-            bgt RC_C1_H_CACHE_REMAIN
-            ld1 {v4.8b}, [x7]
-            ld1 {v2.8b}, [x6], #8
-            sub v3.8b, v31.8b, v2.8b
-            add x8, %[start_w], x5, lsl #2
-        )"
-            LOAD_8_LINE0
-            CALC_LINE(v5, v4, v5)
-            "prfm pldl1keep, [x9, 448]  \n"
-            "st1 {v5.8b}, [x7], #8      \n"
-            CALC_2_LINE(v6, v4, v5)
-        R"(
-            st1 {v6.8b}, [%1], #8
-            mov x4, x5
-            b RC_C1_H_CACHE_L8
-
-        RC_C1_H_CACHE_REMAIN:
-            cbz %[w_remain], RC_C1_H_PRE
-            sub x5, %[w_remain], #8
-            add x6, x6, x5
-            add x7, x7, x5
-            ld1 {v2.8b}, [x6], #8
-            add %1, %1, x5
-            sub v3.8b, v31.8b, v2.8b
-            add x5, x4, x5
-            add x8, %[start_w], x5, lsl #2
-        )"
-            LOAD_8_LINE0
-            CALC_LINE(v5, v4, v5)
-            "st1 {v5.8b}, [x7], #8      \n"
-            CALC_2_LINE(v6, v4, v5)
-        R"(
-            st1 {v6.8b}, [%1], #8
-            b RC_C1_H_PRE
-    RC_C1_END:
-    )"
-    :
-    : "r"(src_ptr), "r"(dst_ptr), [ss] "r"(ss), [w8] "r"(1L * w8), [w_remain] "r"(1L * w_remain), [h] "r"(1L * dh)
-    , [alpha] "r"(alpha), [beta] "r"(beta), [start_w] "r"(start_w)
-    , [start_h] "r"(start_h), [cache] "r"(cache), [shift]"i"(k_shift)
-    : "cc", "memory", "x0", "x1", "x2", "x3", "x4", "x5", "x6", "x7", "x8"
-    , "x9", "x10", "x11", "x12", "x13", "x14", "x15", "x16"
-    , "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "v8", "v9"
-    , "v31"
-    );
-}
-*/
-
 static void resize_dn2_c1(const Image& src, const Image &dst, ResizeParam param) {
     // clang-format off
 
@@ -300,56 +80,61 @@ static void resize_dn2_c1(const Image& src, const Image &dst, ResizeParam param)
         // x1  --> h loop
         // x2  --> w loop
         // x3  --> w remain
+        // x5  --> dst
+        // x6  --> ss * 2
         "mov x0, %0                                     \n" \
         "mov x1, xzr                                    \n" \
+        "mov x5, %1                                     \n" \
+        "lsl x6, %[ss], #1                              \n" \
         "b RDN2_C1_H                                    \n" \
         "RDN2_C1_H_PRE:                                 \n" \
         "   add x1, x1, #1                              \n" \
-        "   add x0, x0, %[ss]                           \n" \
+        "   madd x0, x1, x6, %0                         \n" \
+        "   madd x5, x1, %[ds], %1                      \n" \
         "RDN2_C1_H:                                     \n" \
         "   cmp x1, %[h]                                \n" \
         "   bge RDN2_C1_END                             \n" \
         "   and x3, %[w], #15                           \n" \
         "   sub x2, %[w], x3                            \n" \
-        "   cbz x2, RDN2_C1_W4                          \n" \
+        "   cbz x2, RDN2_C1_W8                          \n" \
         "   RDN2_C1_W16:                                \n" \
         "       subs x2, x2, #16                        \n" \
         "       ld2 {v0.16b, v1.16b}, [x0], #32         \n" \
         "       urhadd v0.16b, v0.16b, v1.16b           \n" \
-        "       st1 {v0.16b}, [%1], #16                 \n" \
+        "       st1 {v0.16b}, [x5], #16                 \n" \
         "       bgt RDN2_C1_W16                         \n" \
         "   RDN2_C1_W8:                                 \n" \
         "       cmp x3, #8                              \n" \
         "       blt RDN2_C1_W4                          \n" \
         "       ld2 {v0.8b, v1.8b}, [x0], #16           \n" \
         "       urhadd v0.8b, v0.8b, v1.8b              \n" \
-        "       st1 {v0.8b}, [%1], #8                   \n" \
+        "       st1 {v0.8b}, [x5], #8                   \n" \
         "       sub x3, x3, #8                          \n" \
         "   RDN2_C1_W4:                                 \n" \
         "       cmp x3, #4                              \n" \
         "       blt RDN2_C1_W2                          \n" \
         "       ld1 {v0.8b}, [x0], #8                   \n" \
                 ADDLP(v0)                                 \
-        "       st1 {v0.s}[0], [%1], #4                 \n" \
+        "       st1 {v0.s}[0], [x5], #4                 \n" \
         "       sub x3, x3, #4                          \n" \
         "   RDN2_C1_W2:                                 \n" \
         "       cmp x3, #2                              \n" \
         "       blt RDN2_C1_W1                          \n" \
         "       ld1 {v0.s}[0], [x0], #4                 \n" \
                 ADDLP(v0)                                 \
-        "       st1 {v0.h}[0], [%1], #2                 \n" \
+        "       st1 {v0.h}[0], [x5], #2                 \n" \
         "       sub x3, x3, #2                          \n" \
         "   RDN2_C1_W1:                                 \n" \
         "       cmp x3, #1                              \n" \
         "       blt RDN2_C1_H_PRE                       \n" \
         "       ld1 {v0.h}[0], [x0], #2                 \n" \
                 ADDLP(v0)                                 \
-        "       st1 {v0.b}[0], [%1], #1                 \n" \
-        "   blt RDN2_C1_H_PRE                           \n" \
+        "       st1 {v0.b}[0], [x5], #1                 \n" \
+        "   b RDN2_C1_H_PRE                             \n" \
         "RDN2_C1_END:                                   \n"
         :
-        : "r"(src.data()), "r"(dst.data()), [h]"r"(1UL * dst.rows()), [w]"r"(1UL * dst.cols()), [ss]"r"(src.stride())
-        : "cc", "memory", "x0", "x1", "x2", "x3", "v0", "v1"
+        : "r"(src.data()), "r"(dst.data()), [h]"r"(1UL * dst.rows()), [w]"r"(1UL * dst.cols()), [ss]"r"(src.stride()), [ds]"r"(dst.stride())
+        : "cc", "memory", "x0", "x1", "x2", "x3", "x5", "x6", "v0", "v1"
     );
 }
 
@@ -362,20 +147,25 @@ static void resize_dn2_c3(const Image& src, const Image &dst, ResizeParam param)
         // x2  --> h loop
         // x3  --> w loop
         // x4  --> w remain
+        // x5  --> ss * 2
+        // x6  --> dst
         "mov x0, %0                                     \n" \
         "add x1, %0, %[ss]                              \n" \
         "mov x2, xzr                                    \n" \
+        "lsl x5, %[ss], #1                              \n" \
+        "mov x6, %1                                     \n" \
         "b RDN2_C3_H                                       \n" \
         "RDN2_C3_H_PRE:                                    \n" \
         "   add x2, x2, #1                              \n" \
-        "   mov x0, x1                                  \n" \
-        "   add x1, x1, %[ss]                           \n" \
+        "   madd x0, x2, x5, %0                         \n" \
+        "   add x1, x0, %[ss]                           \n" \
+        "   madd x6, x2, %[ds], %1                      \n" \
         "RDN2_C3_H:                                        \n" \
         "   cmp x2, %[h]                                \n" \
         "   bge RDN2_C3_END                                \n" \
         "   and x4, %[w], 0x7                           \n" \
         "   sub x3, %[w], x4                            \n" \
-        "   cbz x3, RDN2_C3_W4                             \n" \
+        "   cbz x3, RDN2_C3_W8                             \n" \
         "   RDN2_C3_W8:                                    \n" \
         "       subs x3, x3, #8                         \n" \
         "       ld3 {v3.16b, v4.16b, v5.16b}, [x1], #48 \n" \
@@ -389,7 +179,7 @@ static void resize_dn2_c3(const Image& src, const Image &dst, ResizeParam param)
         "       urhadd v1.8b, v1.8b, v4.8b              \n" \
                 ADDLP(v2)                                 \
         "       urhadd v2.8b, v2.8b, v5.8b              \n" \
-        "       st3 {v0.8b, v1.8b, v2.8b}, [%1], #24    \n" \
+        "       st3 {v0.8b, v1.8b, v2.8b}, [x6], #24    \n" \
         "       bgt RDN2_C3_W8                             \n" \
         "   RDN2_C3_W4:                                    \n" \
         "       cmp x4, #4                              \n" \
@@ -405,7 +195,7 @@ static void resize_dn2_c3(const Image& src, const Image &dst, ResizeParam param)
         "       urhadd v1.8b, v1.8b, v4.8b              \n" \
                 ADDLP(v2)                                 \
         "       urhadd v2.8b, v2.8b, v5.8b              \n" \
-                ST3_LAN4_OFS(%1, v0, v1, v2)               \
+                ST3_LAN4_OFS(x6, v0, v1, v2)               \
         "       sub x4, x4, #4                          \n" \
         "   RDN2_C3_W2:                                    \n" \
         "       cmp x4, #2                              \n" \
@@ -421,7 +211,7 @@ static void resize_dn2_c3(const Image& src, const Image &dst, ResizeParam param)
         "       urhadd v1.8b, v1.8b, v4.8b              \n" \
                 ADDLP(v2)                                 \
         "       urhadd v2.8b, v2.8b, v5.8b              \n" \
-                ST3_LAN2_OFS(%1, v0, v1, v2)               \
+                ST3_LAN2_OFS(x6, v0, v1, v2)               \
         "       sub x4, x4, #2                          \n" \
         "   RDN2_C3_W1:                                    \n" \
         "       cmp x4, #1                              \n" \
@@ -437,19 +227,19 @@ static void resize_dn2_c3(const Image& src, const Image &dst, ResizeParam param)
         "       urhadd v1.8b, v1.8b, v4.8b              \n" \
                 ADDLP(v2)                                 \
         "       urhadd v2.8b, v2.8b, v5.8b              \n" \
-                ST3_LAN1_OFS(%1, v0, v1, v2)               \
+                ST3_LAN1_OFS(x6, v0, v1, v2)               \
         "   b RDN2_C3_H_PRE                                \n" \
         "RDN2_C3_END:                                      \n"
         :
-        : "r"(src.data()), "r"(dst.data()), [h]"r"(1UL * dst.rows()), [w]"r"(1UL * dst.cols()), [ss]"r"(src.stride())
-        : "cc", "memory", "x0", "x1", "x2", "x3", "x4"
+        : "r"(src.data()), "r"(dst.data()), [h]"r"(1UL * dst.rows()), [w]"r"(1UL * dst.cols()), [ss]"r"(src.stride()), [ds]"r"(dst.stride())
+        : "cc", "memory", "x0", "x1", "x2", "x3", "x4", "x5", "x6"
         , "v0", "v1", "v2", "v3", "v4", "v5"
     );
 }
 
 static void resize_dn2h_c3(const Image& src, const Image &dst, ResizeParam param) {
     ResizeBuffer buff{param, src.cols(), dst.cols(), 3};
-    std::vector<uint8_t> cache(3UL * dst.rows(), 0);
+    std::vector<uint8_t> cache(3UL * dst.cols(), 0);
     // clang-format off
     #define RDN2H_C3_LD_LINE0_LAN(REG, IDX, VEC)                        \
         "mov w"#REG", "#VEC"                                        \n" \
@@ -469,7 +259,8 @@ static void resize_dn2h_c3(const Image& src, const Image &dst, ResizeParam param
         // x5 --> alpha
         // x6 --> cache
         // x7 --> %[ss] - 3
-        "mov x0, %0                                     \n" \
+        // x8 --> dst
+        "mov x1, #-1                                    \n" \
         "mov x2, xzr                                    \n" \
         "mov x7, %[ss]                                  \n" \
         "sub x7, x7, #3                                 \n" \
@@ -478,6 +269,7 @@ static void resize_dn2h_c3(const Image& src, const Image &dst, ResizeParam param
         "RDN2H_C3_H_PRE:                                \n" \
         "   add x1, x1, #1                              \n" \
         "   madd x0, %[ss], x1, %0                      \n" \
+        "   madd x8, %[ds], x1, %1                      \n" \
         "RDN2H_C3_H:                                    \n" \
         "   cmp x1, %[h]                                \n" \
         "   bge RDN2H_C3_END                            \n" \
@@ -518,7 +310,7 @@ static void resize_dn2h_c3(const Image& src, const Image &dst, ResizeParam param
         "       urhadd v2.8b, v2.8b, v8.8b              \n" \
         "       urhadd v3.8b, v3.8b, v9.8b              \n" \
         "       urhadd v4.8b, v4.8b, v10.8b             \n" \
-        "       st3 {v2.8b, v3.8b, v4.8b}, [%1], #24    \n" \
+        "       st3 {v2.8b, v3.8b, v4.8b}, [x8], #24    \n" \
         "       bgt RDN2H_C3_W8                         \n" \
         "   RDN2H_C3_W4:                                \n" \
         "       cmp x3, #4                              \n" \
@@ -545,7 +337,7 @@ static void resize_dn2h_c3(const Image& src, const Image &dst, ResizeParam param
         "       urhadd v2.8b, v2.8b, v8.8b              \n" \
         "       urhadd v3.8b, v3.8b, v9.8b              \n" \
         "       urhadd v4.8b, v4.8b, v10.8b             \n" \
-                ST3_LAN4_OFS(%1, v2, v3, v4)              \
+                ST3_LAN4_OFS(x8, v2, v3, v4)              \
         "   RDN2H_C3_W2:                                \n" \
         "       cmp x3, #2                              \n" \
         "       blt RDN2H_C3_W1                         \n" \
@@ -567,7 +359,7 @@ static void resize_dn2h_c3(const Image& src, const Image &dst, ResizeParam param
         "       urhadd v2.8b, v2.8b, v8.8b              \n" \
         "       urhadd v3.8b, v3.8b, v9.8b              \n" \
         "       urhadd v4.8b, v4.8b, v10.8b             \n" \
-                ST3_LAN2_OFS(%1, v2, v3, v4)              \
+                ST3_LAN2_OFS(x8, v2, v3, v4)              \
         "   RDN2H_C3_W1:                                \n" \
         "       cmp x3, #1                              \n" \
         "       blt RDN2H_C3_H_PRE                      \n" \
@@ -587,12 +379,12 @@ static void resize_dn2h_c3(const Image& src, const Image &dst, ResizeParam param
         "       urhadd v2.8b, v2.8b, v8.8b              \n" \
         "       urhadd v3.8b, v3.8b, v9.8b              \n" \
         "       urhadd v4.8b, v4.8b, v10.8b             \n" \
-                ST3_LAN1_OFS(%1, v2, v3, v4)              \
+                ST3_LAN1_OFS(x8, v2, v3, v4)              \
         "   b RDN2H_C3_H_PRE                            \n" \
         "RDN2H_C3_END:                                  \n"
         :
         : "r"(src.data()), "r"(dst.data()), [h]"r"(1UL * dst.rows()), [w]"r"(1UL * dst.cols())
-        , [ss] "r"(src.stride()), [alpha]"r"(buff.getParam()), [start_w]"r"(buff.getStart())
+        , [ss] "r"(src.stride()), [ds]"r"(dst.stride()), [alpha]"r"(buff.getParam()), [start_w]"r"(buff.getStart())
         , [cache] "r"(cache.data()), [shift]"i"(k_shift)
         : "cc", "memory", "x0", "x1", "x2", "x3", "x4", "x5", "x6", "x7", "x8"
         , "x9", "x10", "x11", "x12", "x13", "x14", "x15", "x16", "x17"
@@ -604,7 +396,7 @@ static void resize_dn2h_c3(const Image& src, const Image &dst, ResizeParam param
 
 static void resize_dn2w_c3(const Image& src, const Image &dst, ResizeParam param) {
     ResizeBuffer buff{param, src.rows(), dst.rows()};
-    std::vector<uint8_t> cache(3UL * dst.rows(), 0);
+    std::vector<uint8_t> cache(3UL * dst.cols(), 0);
     // clang-format off
 
     asm volatile(
@@ -616,6 +408,7 @@ static void resize_dn2w_c3(const Image& src, const Image &dst, ResizeParam param
         // x5  --> current line
         // x6  --> w loop
         // x7  --> w remain
+        // x8  --> dst
         "mov x3, xzr                                    \n" \
         "mov x4, #-1                                    \n" \
         "movi v31.8b, #128                              \n" \
@@ -628,6 +421,7 @@ static void resize_dn2w_c3(const Image& src, const Image &dst, ResizeParam param
         "   bge RDN2W_C3_END                            \n" \
         "   ldrsw x5, [%[start_h], x3, lsl #2]          \n" \
         "   madd x0, x5, %[ss], %0                      \n" \
+        "   madd x8, x3, %[ds], %1                      \n" \
         "   add x1, x0, %[ss]                           \n" \
         "   ld1r {v0.8b}, [%[param]], #1                \n" \
         "   sub v1.8b, v31.8b, v0.8b                    \n" \
@@ -651,7 +445,7 @@ static void resize_dn2w_c3(const Image& src, const Image &dst, ResizeParam param
                 MUL(v3, v6, v0, v1)                       \
                 ADDLP(v4)                                 \
                 MUL(v4, v7, v0, v1)                       \
-        "       st3 {v2.8b, v3.8b, v4.8b}, [%1], #24    \n" \
+        "       st3 {v2.8b, v3.8b, v4.8b}, [x8], #24    \n" \
         "       bgt RDN2W_C3_W8                         \n" \
         "   RDN2W_C3_W4:                                \n" \
         "       cmp x7, #4                              \n" \
@@ -669,7 +463,7 @@ static void resize_dn2w_c3(const Image& src, const Image &dst, ResizeParam param
                 MUL(v3, v6, v0, v1)                       \
                 ADDLP(v4)                                 \
                 MUL(v4, v7, v0, v1)                       \
-                ST3_LAN4_OFS(%1, v2, v3, v4)              \
+                ST3_LAN4_OFS(x8, v2, v3, v4)              \
         "   RDN2W_C3_W2:                                \n" \
         "       cmp x7, #2                              \n" \
         "       blt RDN2W_C3_W1                         \n" \
@@ -686,7 +480,7 @@ static void resize_dn2w_c3(const Image& src, const Image &dst, ResizeParam param
                 MUL(v3, v6, v0, v1)                       \
                 ADDLP(v4)                                 \
                 MUL(v4, v7, v0, v1)                       \
-                ST3_LAN2_OFS(%1, v2, v3, v4)              \
+                ST3_LAN2_OFS(x8, v2, v3, v4)              \
         "   RDN2W_C3_W1:                                \n" \
         "       cmp x7, #1                              \n" \
         "       blt RDN2W_C3_H_PRE                      \n" \
@@ -702,7 +496,7 @@ static void resize_dn2w_c3(const Image& src, const Image &dst, ResizeParam param
                 MUL(v3, v6, v0, v1)                       \
                 ADDLP(v4)                                 \
                 MUL(v4, v7, v0, v1)                       \
-                ST3_LAN1_OFS(%1, v2, v3, v4)              \
+                ST3_LAN1_OFS(x8, v2, v3, v4)              \
         "   b RDN2W_C3_H_PRE                            \n" \
         "RDN2W_C3_CACHE:                                \n" \
         "   cbz x6, RDN2W_C3_CW4                        \n" \
@@ -717,7 +511,7 @@ static void resize_dn2w_c3(const Image& src, const Image &dst, ResizeParam param
                 MUL(v3, v6, v0, v1)                       \
         "       st3 {v5.8b, v6.8b, v7.8b}, [x2], #24    \n" \
                 MUL(v4, v7, v0, v1)                       \
-        "       st3 {v2.8b, v3.8b, v4.8b}, [%1], #24    \n" \
+        "       st3 {v2.8b, v3.8b, v4.8b}, [x8], #24    \n" \
         "       bgt RDN2W_C3_CW8                        \n" \
         "   RDN2W_C3_CW4:                               \n" \
         "       cmp x7, #4                              \n" \
@@ -732,7 +526,7 @@ static void resize_dn2w_c3(const Image& src, const Image &dst, ResizeParam param
                 MUL(v3, v6, v0, v1)                       \
                 ST3_LAN4_OFS(x2, v5, v6, v7)              \
                 MUL(v4, v7, v0, v1)                       \
-                ST3_LAN4_OFS(%1, v2, v3, v4)              \
+                ST3_LAN4_OFS(x8, v2, v3, v4)              \
         "   RDN2W_C3_CW2:                               \n" \
         "       cmp x7, #2                              \n" \
         "       blt RDN2W_C3_CW1                        \n" \
@@ -746,7 +540,7 @@ static void resize_dn2w_c3(const Image& src, const Image &dst, ResizeParam param
                 MUL(v3, v6, v0, v1)                       \
                 ST3_LAN2_OFS(x2, v5, v6, v7)              \
                 MUL(v4, v7, v0, v1)                       \
-                ST3_LAN2_OFS(%1, v2, v3, v4)              \
+                ST3_LAN2_OFS(x8, v2, v3, v4)              \
         "   RDN2W_C3_CW1:                               \n" \
         "       cmp x7, #1                              \n" \
         "       blt RDN2W_C3_H_PRE                      \n" \
@@ -760,14 +554,14 @@ static void resize_dn2w_c3(const Image& src, const Image &dst, ResizeParam param
                 MUL(v3, v6, v0, v1)                       \
                 ST3_LAN1_OFS(x2, v5, v6, v7)              \
                 MUL(v4, v7, v0, v1)                       \
-                ST3_LAN1_OFS(%1, v2, v3, v4)              \
+                ST3_LAN1_OFS(x8, v2, v3, v4)              \
         "   b RDN2W_C3_H_PRE                            \n" \
         "RDN2W_C3_END:                                  \n"
     :
     : "r"(src.data()), "r"(dst.data()), [w]"r"(1UL * dst.cols()), [h]"r"(1UL * dst.rows())
-    , [ss]"r"(src.stride()), [param]"r"(buff.getParam()), [start_h]"r"(buff.getStart())
+    , [ss]"r"(src.stride()), [ds]"r"(dst.stride()), [param]"r"(buff.getParam()), [start_h]"r"(buff.getStart())
     , [cache]"r"(cache.data()), [shift]"i"(k_shift)
-    : "cc", "memory", "x0", "x1", "x2", "x3", "x4", "x5", "x6", "x7"
+    : "cc", "memory", "x0", "x1", "x2", "x3", "x4", "x5", "x6", "x7", "x8"
     , "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7");
     // clang-format on
 }
@@ -775,7 +569,7 @@ static void resize_dn2w_c3(const Image& src, const Image &dst, ResizeParam param
 static void resize_comm_c3(const Image& src, const Image &dst, ResizeParam param) {
     ResizeBuffer buff_h{param, src.rows(), dst.rows()};
     ResizeBuffer buff_w{param, src.cols(), dst.cols(), 3};
-    std::vector<uint8_t> cache(3UL * dst.rows(), 0);
+    std::vector<uint8_t> cache(3UL * dst.cols(), 0);
     // clang-format off
     #define RDNC_C3_LD_LINE0_LAN(REG, IDX, VEC)                         \
         "mov w"#REG", "#VEC"                                        \n" \
@@ -798,9 +592,10 @@ static void resize_comm_c3(const Image& src, const Image &dst, ResizeParam param
         // x7  --> start w
         // x8  --> alpha
         // x9  --> ss -3
+        // x19 --> dst
         "mov x2, xzr                                        \n" \
         "mov x3, #-1                                        \n" \
-        "sub x9, %[ss], #-3                                 \n" \
+        "sub x9, %[ss], #3                                  \n" \
         "movi v29.8b, #128                                  \n" \
         "b RDNC_C3_H                                        \n" \
         "RDNC_C3_H_PRE:                                     \n" \
@@ -811,13 +606,14 @@ static void resize_comm_c3(const Image& src, const Image &dst, ResizeParam param
         "   bge RDNC_C3_END                                 \n" \
         "   ldrsw x4, [%[start_h]], #4                      \n" \
         "   madd x0, x4, %[ss], %0                          \n" \
+        "   madd x19, x2, %[ds], %1                         \n" \
         "   ld1r {v0.8b}, [%[beta]], #1                     \n" \
         "   sub v1.8b, v29.8b, v0.8b                        \n" \
         "   mov x1, %[cache]                                \n" \
         "   and x6, %[w], 0x7                               \n" \
         "   mov x7, %[start_w]                              \n" \
         "   sub x5, %[w], x6                                \n" \
-        "   mov x8, %[alpha]                                \n" \
+        "   add x8, x7, %[w], lsl #2                        \n" \
         "   cmp x3, x4                                      \n" \
         "   bge RDNC_C3_CACHE                               \n" \
         "   cbz x5, RDNC_C3_W4                              \n" \
@@ -852,7 +648,7 @@ static void resize_comm_c3(const Image& src, const Image &dst, ResizeParam param
                 MUL(v4, v10, v0, v1)                          \
                 MUL(v5, v11, v0, v1)                          \
                 MUL(v6, v12, v0, v1)                          \
-        "       st3 {v4.8b, v5.8b, v6.8b}, [%1], #24        \n" \
+        "       st3 {v4.8b, v5.8b, v6.8b}, [x19], #24        \n" \
         "       bgt RDNC_C3_W8                              \n" \
         "   RDNC_C3_W4:                                     \n" \
         "       cmp x6, #4                                  \n" \
@@ -878,7 +674,7 @@ static void resize_comm_c3(const Image& src, const Image &dst, ResizeParam param
                 MUL(v4, v10, v0, v1)                          \
                 MUL(v5, v11, v0, v1)                          \
                 MUL(v6, v12, v0, v1)                          \
-                ST3_LAN4_OFS(%1, v4, v5, v6)                  \
+                ST3_LAN4_OFS(x19, v4, v5, v6)                  \
         "       sub x6, x6, #4                              \n" \
         "   RDNC_C3_W2:                                     \n" \
         "       cmp x6, #2                                  \n" \
@@ -900,7 +696,7 @@ static void resize_comm_c3(const Image& src, const Image &dst, ResizeParam param
                 MUL(v4, v7, v0, v1)                           \
                 MUL(v5, v8, v0, v1)                           \
                 MUL(v6, v9, v0, v1)                           \
-                ST3_LAN2_OFS(%1, v4, v5, v6)                  \
+                ST3_LAN2_OFS(x19, v4, v5, v6)                  \
         "       sub x6, x6, #2                              \n" \
         "   RDNC_C3_W1:                                     \n" \
         "       cmp x6, #1                                  \n" \
@@ -920,7 +716,7 @@ static void resize_comm_c3(const Image& src, const Image &dst, ResizeParam param
                 MUL(v4, v7, v0, v1)                           \
                 MUL(v5, v8, v0, v1)                           \
                 MUL(v6, v9, v0, v1)                           \
-                ST3_LAN1_OFS(%1, v4, v5, v6)                  \
+                ST3_LAN1_OFS(x19, v4, v5, v6)                  \
         "   b RDNC_C3_H_PRE                                 \n" \
         "RDNC_C3_CACHE:                                     \n" \
         "   cbz x5, RDNC_C3_CW4                             \n" \
@@ -945,7 +741,7 @@ static void resize_comm_c3(const Image& src, const Image &dst, ResizeParam param
                 MUL(v10, v4, v0, v1)                          \
                 MUL(v11, v5, v0, v1)                          \
                 MUL(v12, v6, v0, v1)                          \
-        "       st3 {v10.8b, v11.8b, v12.8b}, [%1], #24     \n" \
+        "       st3 {v10.8b, v11.8b, v12.8b}, [x19], #24     \n" \
         "       bgt RDNC_C3_CW8                             \n" \
         "   RDNC_C3_CW4:                                    \n" \
         "       cmp x6, #4                                  \n" \
@@ -965,7 +761,7 @@ static void resize_comm_c3(const Image& src, const Image &dst, ResizeParam param
                 MUL(v10, v4, v0, v1)                          \
                 MUL(v11, v5, v0, v1)                          \
                 MUL(v12, v6, v0, v1)                          \
-                ST3_LAN4_OFS(%1, v10, v11, v12)               \
+                ST3_LAN4_OFS(x19, v10, v11, v12)               \
         "       sub x6, x6, #4                              \n" \
         "   RDNC_C3_CW2:                                    \n" \
         "       cmp x6, #2                                  \n" \
@@ -983,7 +779,7 @@ static void resize_comm_c3(const Image& src, const Image &dst, ResizeParam param
                 MUL(v10, v4, v0, v1)                          \
                 MUL(v11, v5, v0, v1)                          \
                 MUL(v12, v6, v0, v1)                          \
-                ST3_LAN2_OFS(%1, v10, v11, v12)               \
+                ST3_LAN2_OFS(x19, v10, v11, v12)               \
         "       sub x6, x6, #2                              \n" \
         "   RDNC_C3_CW1:                                    \n" \
         "       cmp x6, #1                                  \n" \
@@ -1000,16 +796,16 @@ static void resize_comm_c3(const Image& src, const Image &dst, ResizeParam param
                 MUL(v10, v4, v0, v1)                          \
                 MUL(v11, v5, v0, v1)                          \
                 MUL(v12, v6, v0, v1)                          \
-                ST3_LAN1_OFS(%1, v10, v11, v12)               \
+                ST3_LAN1_OFS(x19, v10, v11, v12)               \
         "   b RDNC_C3_H_PRE                                 \n" \
         "RDNC_C3_END:                                       \n"
     :
     : "r"(src.data()), "r"(dst.data()), [w]"r"(1UL * dst.cols()), [h]"r"(1UL * dst.rows())
-    , [ss]"r"(src.stride()), [beta]"r"(buff_h.getParam()), [start_h]"r"(buff_h.getStart())
-    , [alpha]"r"(buff_w.getParam()), [start_w]"r"(buff_w.getStart())
+    , [ss]"r"(src.stride()), [ds]"r"(dst.stride()), [beta]"r"(buff_h.getParam()), [start_h]"r"(buff_h.getStart())
+    , [start_w]"r"(buff_w.getStart())
     , [cache]"r"(cache.data()), [shift]"i"(k_shift)
     : "cc", "memory", "x0", "x1", "x2", "x3", "x4", "x5", "x6", "x7", "x8", "x9"
-    , "x10", "x11", "x12", "x13", "x14", "x15", "x16", "x17"
+    , "x10", "x11", "x12", "x13", "x14", "x15", "x16", "x17", "x19"
     , "v0", "v1", "v2", "v3", "v4", "v5", "v6", "v7", "v8", "v9", "v10", "v11"
     , "v12", "v13", "v14", "v15", "v29", "v30", "v31");
     // clang-format on
@@ -1018,7 +814,12 @@ static void resize_comm_c3(const Image& src, const Image &dst, ResizeParam param
 }
 
 static void resize_c1(const Image& src, const Image &dst, ResizeParam param) {
-    resize_dn2_c1(src, dst, param);
+    // Averaging pixel pairs is bilinear only on the half pixel grid
+    if (param.m_half_pixel && (dst.rows() * 2) == src.rows() && (dst.cols() * 2) == src.cols()) {
+        resize_dn2_c1(src, dst, param);
+        return;
+    }
+    resizeBilinear(src, dst, param);
 }
 
 static void resize_c3(const Image& src, const Image &dst, ResizeParam param){
@@ -1042,18 +843,59 @@ static void resize_c3(const Image& src, const Image &dst, ResizeParam param){
     resize_comm_c3(src, dst, param);
 }
 
+#endif
+
 void resize(const Image& src, const Image &dst, ResizeParam param) {
-    switch (src.fmt()) {
-        case ImageFormat::BGR:
-        case ImageFormat::RGB:
-            resize_c3(src, dst, param);
-            break;
-        case ImageFormat::GRAY:
-            resize_c1(src, dst, param);
+    if (0 == src.pixels() || 0 == dst.pixels()) {
+        throw std::invalid_argument("Image must not be empty");
+    }
+    if (src.fmt() >= ImageFormat::END) {
+        throw std::invalid_argument("Unsupported image format");
+    }
+    if (src.fmt() != dst.fmt()) {
+        throw std::invalid_argument("Image format must match");
+    }
+    // Packed 4:2:2 shares chroma between pixel pairs
+    auto fmt = src.fmt();
+    if ((ImageFormat::YUYV == fmt || ImageFormat::UYVY == fmt || ImageFormat::Y210 == fmt) &&
+        (0 != src.cols() % 2 || 0 != dst.cols() % 2)) {
+        throw std::invalid_argument("Width must be even");
+    }
+
+    switch (param.m_resize_type) {
+        case ResizeType::NEAREST:
+            resizeNearest(src, dst, param);
+            return;
+        case ResizeType::CUBIC:
+        case ResizeType::LANCZOS:
+        case ResizeType::MITCHELL:
+        case ResizeType::CATMULL_ROM:
+            resizeFilter(src, dst, param);
+            return;
+        case ResizeType::AREA:
+            resizeArea(src, dst);
+            return;
+        case ResizeType::BILINEAR:
+#ifdef __aarch64__
+            if (ImageFormat::BGR == fmt || ImageFormat::RGB == fmt) {
+                resize_c3(src, dst, param);
+                return;
+            }
+            if (ImageFormat::GRAY == fmt) {
+                resize_c1(src, dst, param);
+                return;
+            }
+#else
+            if (ImageFormat::GRAY == fmt) {
+                resizeBilinear(src, dst, param);
+                return;
+            }
+#endif
             break;
         default:
             break;
     }
+    throw std::invalid_argument("Unsupported resize");
 }
 
 #undef ST3_LAN1_OFS
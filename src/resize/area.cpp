@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include "../cvt_color/band.hpp"
+#include "area.hpp"
+#include "cpu_feature.hpp"
+#include "image.hpp"
+
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+AreaAxis getAreaAxis(int32_t src, int32_t dst, int32_t shift) {
+    // In units of 1 / dst, the box of output i is [i * src, (i + 1) * src)
+    // and sample p is [p * dst, (p + 1) * dst)
+    auto getBegin = [src, dst](int32_t i) { return static_cast<int32_t>(1L * i * src / dst); };
+    auto getEnd = [src, dst](int32_t i) { return static_cast<int32_t>(((i + 1L) * src + dst - 1) / dst); };
+    AreaAxis axis;
+    axis.m_src = src;
+    axis.m_shift = shift;
+    for (int32_t i = 0; i < dst; ++i) {
+        axis.m_taps = std::max(axis.m_taps, getEnd(i) - getBegin(i));
+    }
+    axis.m_stride = (axis.m_taps + 7) & ~7;
+    axis.m_start.resize(dst);
+    axis.m_weight.resize(1UL * axis.m_stride * dst);
+    for (int32_t i = 0; i < dst; ++i) {
+        auto begin = getBegin(i);
+        // Boxes shorter than m_taps near the end move their window back
+        auto start = std::min(begin, src - axis.m_taps);
+        auto *q = axis.m_weight.data() + 1L * axis.m_stride * i;
+        int32_t sum = 0;
+        for (auto p = begin; p < getEnd(i); ++p) {
+            auto cover = std::min((p + 1L) * dst, (i + 1L) * src) - std::max(1L * p * dst, 1L * i * src);
+            auto w = static_cast<int16_t>(((cover << k_area_weight_bits) + src / 2) / src);
+            q[p - start] = w;
+            sum += w;
+        }
+        // Rounded weights sum to one exactly, the largest takes the error
+        auto *top = std::max_element(q, q + axis.m_taps);
+        *top = static_cast<int16_t>(*top + (1 << k_area_weight_bits) - sum);
+        axis.m_start[i] = start;
+    }
+    return axis;
+}
+
+AreaAxis getAreaSumAxis(int32_t src, int32_t dst, int32_t count) {
+    // Sums of count samples are at most 255 * count, a Q(shift) reciprocal
+    // below 2^15 divides them rounded for count up to k_area_max_sum^2
+    auto shift = k_area_weight_bits;
+    while ((1 << (shift - k_area_weight_bits)) < count) {
+        ++shift;
+    }
+    AreaAxis axis;
+    axis.m_src = src;
+    axis.m_taps = src / dst;
+    axis.m_stride = (axis.m_taps + 7) & ~7;
+    axis.m_shift = shift;
+    axis.m_start.resize(dst);
+    axis.m_weight.resize(1UL * axis.m_stride * dst);
+    auto w = static_cast<int16_t>(((1 << shift) + count - 1) / count);
+    for (int32_t i = 0; i < dst; ++i) {
+        axis.m_start[i] = i * axis.m_taps;
+        std::fill_n(axis.m_weight.data() + 1L * axis.m_stride * i, axis.m_taps, w);
+    }
+    return axis;
+}
+
+#define AREA_ROW_C(C)                                                           \
+    void area_row_c##C##_c(const AreaAxis &axis, const int16_t *src, uint8_t *dst) \
+    {                                                                           \
+        areaRow<C>(axis, src, dst, 0, axis.m_start.size());                     \
+    }
+
+AREA_ROW_C(1)
+AREA_ROW_C(3)
+AREA_ROW_C(4)
+
+#undef AREA_ROW_C
+
+void area_col_c(const uint8_t *const *rows, const int16_t *w, int32_t taps, int16_t *dst, int32_t n) {
+    areaCol(rows, w, taps, dst, 0, n);
+}
+
+void area_sum_c(const uint8_t *const *rows, int32_t taps, int16_t *dst, int32_t n) {
+    areaSum(rows, taps, dst, 0, n);
+}
+
+#ifdef __aarch64__
+#define AREA_NEON(F) F
+#else
+#define AREA_NEON(F) nullptr
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define AREA_X86(F) F
+#else
+#define AREA_X86(F) nullptr
+#endif
+
+constexpr size_t k_tier_num = getValueOf(CpuTier::END);
+
+// Kernel of the active tier from impl, indexed by CpuTier: scalar, neon,
+// sse4.1, avx2, avx512bw
+template <typename F>
+static F getAreaFunc(const std::array<F, k_tier_num> &impl) {
+    for (auto t = static_cast<int32_t>(getValueOf(getCpuTier())); t >= 0; --t) {
+        if (nullptr != impl[t] && isCpuTierSupported(static_cast<CpuTier>(t))) {
+            return impl[t];
+        }
+    }
+    return impl[0];
+}
+
+#define AREA_ROW_IMPL(C)                                                        \
+    std::array<AreaRowFunction, k_tier_num>{area_row_##C##_c, AREA_NEON(area_row_##C##_neon), \
+                                            nullptr, AREA_X86(area_row_##C##_avx2), nullptr}
+
+static AreaRowFunction getAreaRowFunc(int32_t channel) {
+    static constexpr std::array<std::array<AreaRowFunction, k_tier_num>, 3> impl{
+        AREA_ROW_IMPL(c1), AREA_ROW_IMPL(c3), AREA_ROW_IMPL(c4)};
+    return getAreaFunc(impl[1 == channel ? 0 : 3 == channel ? 1 : 2]);
+}
+
+#undef AREA_ROW_IMPL
+
+static AreaColFunction getAreaColFunc() {
+    static constexpr std::array<AreaColFunction, k_tier_num> impl{
+        area_col_c, AREA_NEON(area_col_neon), nullptr, AREA_X86(area_col_avx2), nullptr};
+    return getAreaFunc(impl);
+}
+
+static AreaSumFunction getAreaSumFunc() {
+    static constexpr std::array<AreaSumFunction, k_tier_num> impl{
+        area_sum_c, AREA_NEON(area_sum_neon), nullptr, AREA_X86(area_sum_avx2), nullptr};
+    return getAreaFunc(impl);
+}
+
+#undef AREA_X86
+#undef AREA_NEON
+
+static bool isAreaSum(int32_t src, int32_t dst) {
+    return 0 == src % dst && src / dst <= k_area_max_sum;
+}
+
+void resizeArea(const Image &src, const Image &dst) {
+    auto fmt = src.fmt();
+    if (ImageFormat::GRAY != fmt && ImageFormat::RGB != fmt && ImageFormat::BGR != fmt &&
+        ImageFormat::RGBA != fmt && ImageFormat::BGRA != fmt) {
+        throw std::invalid_argument("Unsupported resize");
+    }
+    auto channel = static_cast<int32_t>(getPlaneStride(1, fmt, 0));
+    // Integer ratios add up whole boxes, the vertical pass needs no weights
+    // and the horizontal one divides the box sums exactly
+    auto sum = isAreaSum(src.cols(), dst.cols()) && isAreaSum(src.rows(), dst.rows());
+    AreaAxis h_axis;
+    AreaAxis v_axis;
+    if (sum) {
+        auto count = src.cols() / dst.cols() * (src.rows() / dst.rows());
+        h_axis = getAreaSumAxis(src.cols(), dst.cols(), count);
+        v_axis = getAreaSumAxis(src.rows(), dst.rows(), 1);
+    } else {
+        h_axis = getAreaAxis(src.cols(), dst.cols(), k_area_h_shift);
+        v_axis = getAreaAxis(src.rows(), dst.rows(), k_area_v_shift);
+    }
+    auto row_func = getAreaRowFunc(channel);
+    auto col_func = getAreaColFunc();
+    auto sum_func = getAreaSumFunc();
+    auto n = src.cols() * channel;
+
+    auto row_size = static_cast<size_t>(n) + k_area_row_pad;
+    auto taps = v_axis.m_taps;
+
+    // Intermediate row and window per band, the padding is zeroed as the
+    // kernels read it with zero weights
+    std::vector<int16_t> buf;
+    std::vector<const uint8_t*> window;
+    auto init = [&](size_t bands) {
+        buf.resize(bands * row_size);
+        window.resize(bands * taps);
+    };
+    forEachRowBand(dst, init, [&](size_t band, int32_t row, int32_t rows) {
+        auto *band_buf = buf.data() + band * row_size;
+        auto *band_window = window.data() + band * taps;
+        for (auto i = row; i < row + rows; ++i) {
+            for (int32_t k = 0; k < taps; ++k) {
+                band_window[k] = src.ptr(v_axis.m_start[i] + k);
+            }
+            if (sum) {
+                sum_func(band_window, taps, band_buf, n);
+            } else {
+                col_func(band_window, v_axis.m_weight.data() + 1L * v_axis.m_stride * i, taps, band_buf, n);
+            }
+            row_func(h_axis, band_buf, dst.ptr(i));
+        }
+    });
+}
+
+NAMESPACE_END
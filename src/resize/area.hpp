@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include "image.hpp"
+#include "resize.hpp"
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+// Fixed point of the area resize: coverage weights in Q14, the vertical
+// pass rounds into Q7 int16 rows of the source width, the horizontal pass
+// rounds back to 8 bit. The SIMD kernels are bit exact to the _c ones
+constexpr int32_t k_area_weight_bits = 14;
+constexpr int32_t k_area_row_bits = 7;
+constexpr int32_t k_area_v_shift = k_area_weight_bits - k_area_row_bits;
+constexpr int32_t k_area_h_shift = k_area_weight_bits + k_area_row_bits;
+// Integer ratios up to this per axis sum their boxes exactly
+constexpr int32_t k_area_max_sum = 8;
+// Int16 written past an intermediate row for the SIMD kernels to read
+constexpr int32_t k_area_row_pad = 8;
+
+// Boxes of one axis, output i covers the samples [m_start[i], m_start[i] +
+// m_taps) with the weights from m_stride * i, m_stride being m_taps
+// rounded up to 8 with zero weights. Weighted sums are rounded by m_shift
+struct AreaAxis {
+    int32_t m_src{0};
+    int32_t m_taps{0};
+    int32_t m_stride{0};
+    int32_t m_shift{0};
+    std::vector<int32_t> m_start;
+    std::vector<int16_t> m_weight;
+};
+
+// Fraction of each sample covered by the box of each output
+AreaAxis getAreaAxis(int32_t src, int32_t dst, int32_t shift);
+// Boxes of src / dst samples with equal weights, dividing sums of count
+// samples rounded
+AreaAxis getAreaSumAxis(int32_t src, int32_t dst, int32_t count);
+
+inline uint8_t getAreaValue(int32_t sum, int32_t shift) {
+    return static_cast<uint8_t>(std::clamp((sum + (1 << (shift - 1))) >> shift, 0, 255));
+}
+
+// Horizontal pass of outputs [j, n) of a row
+template <int32_t C>
+inline void areaRow(const AreaAxis &axis, const int16_t *src, uint8_t *dst, size_t j, size_t n) {
+    for (; j < n; ++j) {
+        const auto *s = src + static_cast<size_t>(axis.m_start[j]) * C;
+        const auto *w = axis.m_weight.data() + axis.m_stride * j;
+        for (int32_t c = 0; c < C; ++c) {
+            int32_t sum = 0;
+            for (int32_t k = 0; k < axis.m_taps; ++k) {
+                sum += w[k] * s[k * C + c];
+            }
+            dst[j * C + c] = getAreaValue(sum, axis.m_shift);
+        }
+    }
+}
+
+// Vertical pass of values [j, n) of the taps rows
+inline void areaCol(const uint8_t *const *rows, const int16_t *w, int32_t taps, int16_t *dst, int32_t j, int32_t n) {
+    for (; j < n; ++j) {
+        int32_t sum = 0;
+        for (int32_t k = 0; k < taps; ++k) {
+            sum += w[k] * rows[k][j];
+        }
+        dst[j] = static_cast<int16_t>((sum + (1 << (k_area_v_shift - 1))) >> k_area_v_shift);
+    }
+}
+
+// Sums of values [j, n) of the taps rows
+inline void areaSum(const uint8_t *const *rows, int32_t taps, int16_t *dst, int32_t j, int32_t n) {
+    for (; j < n; ++j) {
+        int32_t sum = 0;
+        for (int32_t k = 0; k < taps; ++k) {
+            sum += rows[k][j];
+        }
+        dst[j] = static_cast<int16_t>(sum);
+    }
+}
+
+// Horizontal pass of one intermediate row, the SIMD kernels read up to
+// k_area_row_pad int16 past it
+using AreaRowFunction = void(*)(const AreaAxis&, const int16_t*, uint8_t*);
+// Vertical pass of n values, weighted or summed
+using AreaColFunction = void(*)(const uint8_t *const*, const int16_t*, int32_t, int16_t*, int32_t);
+using AreaSumFunction = void(*)(const uint8_t *const*, int32_t, int16_t*, int32_t);
+
+#define ADD_AREA_ROW(C)                                                         \
+    void area_row_##C##_c(const AreaAxis&, const int16_t*, uint8_t*);           \
+    void area_row_##C##_neon(const AreaAxis&, const int16_t*, uint8_t*);        \
+    void area_row_##C##_avx2(const AreaAxis&, const int16_t*, uint8_t*)
+
+ADD_AREA_ROW(c1);
+ADD_AREA_ROW(c3);
+ADD_AREA_ROW(c4);
+
+#undef ADD_AREA_ROW
+
+void area_col_c(const uint8_t *const*, const int16_t*, int32_t, int16_t*, int32_t);
+void area_col_neon(const uint8_t *const*, const int16_t*, int32_t, int16_t*, int32_t);
+void area_col_avx2(const uint8_t *const*, const int16_t*, int32_t, int16_t*, int32_t);
+void area_sum_c(const uint8_t *const*, int32_t, int16_t*, int32_t);
+void area_sum_neon(const uint8_t *const*, int32_t, int16_t*, int32_t);
+void area_sum_avx2(const uint8_t *const*, int32_t, int16_t*, int32_t);
+
+// Area average resize of 1, 3 and 4 channel 8 bit images
+void resizeArea(const Image &src, const Image &dst);
+
+NAMESPACE_END
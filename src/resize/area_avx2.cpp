@@ -0,0 +1,157 @@
+#include <cstring>
+#include "../cvt_color/x86.hpp"
+#include "area.hpp"
+#include "types.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+NAMESPACE_BEGIN
+
+// Sum of 8 weights and values from src, in 4 int32 per lane
+AVX2_FUNC static inline __m256i areaDot(const int16_t *src0, const int16_t *src1, const int16_t *w0, const int16_t *w1) {
+    auto x = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src0))),
+                                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(src1)), 1);
+    auto w = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(w0))),
+                                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(w1)), 1);
+    return _mm256_madd_epi16(x, w);
+}
+
+// 8 outputs per loop, outputs j + q and j + 4 + q share the lanes of one
+// sum, each of their windows read 8 taps at a time
+AVX2_FUNC static void areaRowC1Avx2(const AreaAxis &axis, const int16_t *src, uint8_t *dst) {
+    auto n = axis.m_start.size();
+    const auto *weight = axis.m_weight.data();
+    const auto round = _mm256_set1_epi32(1 << (axis.m_shift - 1));
+    const auto shift = _mm_cvtsi32_si128(axis.m_shift);
+    size_t j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m256i sum[4];
+        for (size_t q = 0; q < 4; ++q) {
+            const auto *s0 = src + axis.m_start[j + q];
+            const auto *s1 = src + axis.m_start[j + 4 + q];
+            const auto *w0 = weight + axis.m_stride * (j + q);
+            const auto *w1 = weight + axis.m_stride * (j + 4 + q);
+            sum[q] = areaDot(s0, s1, w0, w1);
+            for (int32_t k = 8; k < axis.m_stride; k += 8) {
+                sum[q] = _mm256_add_epi32(sum[q], areaDot(s0 + k, s1 + k, w0 + k, w1 + k));
+            }
+        }
+        // Outputs 0 1 2 3 | 4 5 6 7
+        auto s = _mm256_hadd_epi32(_mm256_hadd_epi32(sum[0], sum[1]), _mm256_hadd_epi32(sum[2], sum[3]));
+        s = _mm256_sra_epi32(_mm256_add_epi32(s, round), shift);
+        s = _mm256_packs_epi32(s, s);
+        s = _mm256_packus_epi16(s, s);
+        auto v = _mm_unpacklo_epi32(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + j), v);
+    }
+    areaRow<1>(axis, src, dst, j, n);
+}
+
+// 2 outputs per loop, one per lane. The channels of taps k and k + 1 are
+// paired up for the pair of their weights
+template <int32_t C>
+AVX2_FUNC static void areaRowAvx2(const AreaAxis &axis, const int16_t *src, uint8_t *dst) {
+    const auto split = 4 == C
+        ? _mm256_setr_epi8(0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15,
+                           0, 1, 8, 9, 2, 3, 10, 11, 4, 5, 12, 13, 6, 7, 14, 15)
+        : _mm256_setr_epi8(0, 1, 6, 7, 2, 3, 8, 9, 4, 5, 10, 11, -1, -1, -1, -1,
+                           0, 1, 6, 7, 2, 3, 8, 9, 4, 5, 10, 11, -1, -1, -1, -1);
+    auto n = axis.m_start.size();
+    const auto *weight = axis.m_weight.data();
+    const auto round = _mm256_set1_epi32(1 << (axis.m_shift - 1));
+    const auto shift = _mm_cvtsi32_si128(axis.m_shift);
+    size_t j = 0;
+    for (; j + 2 <= n; j += 2) {
+        const auto *s0 = src + static_cast<size_t>(axis.m_start[j]) * C;
+        const auto *s1 = src + static_cast<size_t>(axis.m_start[j + 1]) * C;
+        const auto *w0 = weight + axis.m_stride * j;
+        const auto *w1 = weight + axis.m_stride * (j + 1);
+        auto sum = _mm256_setzero_si256();
+        for (int32_t k = 0; k < axis.m_taps; k += 2) {
+            auto x = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s0 + k * C))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1 + k * C)), 1);
+            int32_t p0 = 0;
+            int32_t p1 = 0;
+            std::memcpy(&p0, w0 + k, sizeof(p0));
+            std::memcpy(&p1, w1 + k, sizeof(p1));
+            auto w = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_set1_epi32(p0)), _mm_set1_epi32(p1), 1);
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_shuffle_epi8(x, split), w));
+        }
+        auto s = _mm256_sra_epi32(_mm256_add_epi32(sum, round), shift);
+        s = _mm256_packs_epi32(s, s);
+        s = _mm256_packus_epi16(s, s);
+        auto v0 = _mm_cvtsi128_si32(_mm256_castsi256_si128(s));
+        auto v1 = _mm_cvtsi128_si32(_mm256_extracti128_si256(s, 1));
+        std::memcpy(dst + j * C, &v0, C);
+        std::memcpy(dst + (j + 1) * C, &v1, C);
+    }
+    areaRow<C>(axis, src, dst, j, n);
+}
+
+// 16 values per loop, the rows taken in pairs for madd, an odd last row
+// is paired with itself under a zero weight
+AVX2_FUNC static void areaColAvx2(const uint8_t *const *rows, const int16_t *w, int32_t taps, int16_t *dst, int32_t n) {
+    const auto round = _mm256_set1_epi32(1 << (k_area_v_shift - 1));
+    int32_t j = 0;
+    for (; j + 16 <= n; j += 16) {
+        auto lo = _mm256_setzero_si256();
+        auto hi = _mm256_setzero_si256();
+        for (int32_t k = 0; k < taps; k += 2) {
+            auto k1 = k + 1 < taps ? k + 1 : k;
+            auto w1 = k + 1 < taps ? w[k + 1] : 0;
+            auto a = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k] + j)));
+            auto b = _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(rows[k1] + j)));
+            auto wp = _mm256_unpacklo_epi16(_mm256_set1_epi16(w[k]), _mm256_set1_epi16(w1));
+            lo = _mm256_add_epi32(lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), wp));
+            hi = _mm256_add_epi32(hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), wp));
+        }
+        lo = _mm256_srai_epi32(_mm256_add_epi32(lo, round), k_area_v_shift);
+        hi = _mm256_srai_epi32(_mm256_add_epi32(hi, round), k_area_v_shift);
+        // The unpacks and packs work per lane, so the order comes back
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + j), _mm256_packs_epi32(lo, hi));
+    }
+    areaCol(rows, w, taps, dst, j, n);
+}
+
+AVX2_FUNC static void areaSumAvx2(const uint8_t *const *rows, int32_t taps, int16_t *dst, int32_t n) {
+    int32_t j = 0;
+    for (; j + 32 <= n; j += 32) {
+        auto lo = _mm256_setzero_si256();
+        auto hi = _mm256_setzero_si256();
+        for (int32_t k = 0; k < taps; ++k) {
+            auto x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows[k] + j));
+            lo = _mm256_add_epi16(lo, _mm256_cvtepu8_epi16(_mm256_castsi256_si128(x)));
+            hi = _mm256_add_epi16(hi, _mm256_cvtepu8_epi16(_mm256_extracti128_si256(x, 1)));
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + j), lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + j + 16), hi);
+    }
+    areaSum(rows, taps, dst, j, n);
+}
+
+void area_row_c1_avx2(const AreaAxis &axis, const int16_t *src, uint8_t *dst) {
+    areaRowC1Avx2(axis, src, dst);
+}
+
+void area_row_c3_avx2(const AreaAxis &axis, const int16_t *src, uint8_t *dst) {
+    areaRowAvx2<3>(axis, src, dst);
+}
+
+void area_row_c4_avx2(const AreaAxis &axis, const int16_t *src, uint8_t *dst) {
+    areaRowAvx2<4>(axis, src, dst);
+}
+
+void area_col_avx2(const uint8_t *const *rows, const int16_t *w, int32_t taps, int16_t *dst, int32_t n) {
+    areaColAvx2(rows, w, taps, dst, n);
+}
+
+void area_sum_avx2(const uint8_t *const *rows, int32_t taps, int16_t *dst, int32_t n) {
+    areaSumAvx2(rows, taps, dst, n);
+}
+
+NAMESPACE_END
+
+#endif
@@ -0,0 +1,138 @@
+#include <cstring>
+#include "area.hpp"
+#include "types.hpp"
+
+#ifdef __aarch64__
+
+#include <arm_neon.h>
+
+NAMESPACE_BEGIN
+
+// Sum of the m_stride weights and values of the window from src, in 4
+// int32 to be added up
+static inline int32x4_t areaDot(const int16_t *src, const int16_t *w, int32_t stride) {
+    auto sum = vdupq_n_s32(0);
+    for (int32_t k = 0; k < stride; k += 8) {
+        auto x = vld1q_s16(src + k);
+        auto wk = vld1q_s16(w + k);
+        sum = vmlal_s16(sum, vget_low_s16(x), vget_low_s16(wk));
+        sum = vmlal_high_s16(sum, x, wk);
+    }
+    return sum;
+}
+
+// getAreaValue of 8 sums, the saturating narrows are its clamp
+static inline uint8x8_t packArea(int32x4_t lo, int32x4_t hi, int32x4_t shift) {
+    return vqmovun_s16(vcombine_s16(vqmovn_s32(vrshlq_s32(lo, shift)), vqmovn_s32(vrshlq_s32(hi, shift))));
+}
+
+// 8 outputs per loop, each window read 8 taps at a time and the lanes of
+// its sum added up at the end
+static void areaRowC1Neon(const AreaAxis &axis, const int16_t *src, uint8_t *dst) {
+    auto n = axis.m_start.size();
+    const auto *weight = axis.m_weight.data();
+    // Rounding shift right as a shift left by the negative
+    const auto shift = vdupq_n_s32(-axis.m_shift);
+    size_t j = 0;
+    for (; j + 8 <= n; j += 8) {
+        int32x4_t sum[8];
+        for (size_t q = 0; q < 8; ++q) {
+            sum[q] = areaDot(src + axis.m_start[j + q], weight + axis.m_stride * (j + q), axis.m_stride);
+        }
+        auto lo = vpaddq_s32(vpaddq_s32(sum[0], sum[1]), vpaddq_s32(sum[2], sum[3]));
+        auto hi = vpaddq_s32(vpaddq_s32(sum[4], sum[5]), vpaddq_s32(sum[6], sum[7]));
+        vst1_u8(dst + j, packArea(lo, hi, shift));
+    }
+    areaRow<1>(axis, src, dst, j, n);
+}
+
+// 2 outputs per loop, the channels of each tap multiplied by its weight.
+// Rgb loads a fourth int16 from the next tap that lands past the output
+template <int32_t C>
+static void areaRowNeon(const AreaAxis &axis, const int16_t *src, uint8_t *dst) {
+    auto n = axis.m_start.size();
+    const auto *weight = axis.m_weight.data();
+    const auto shift = vdupq_n_s32(-axis.m_shift);
+    size_t j = 0;
+    for (; j + 2 <= n; j += 2) {
+        int32x4_t sum[2];
+        for (size_t q = 0; q < 2; ++q) {
+            const auto *s = src + static_cast<size_t>(axis.m_start[j + q]) * C;
+            const auto *w = weight + axis.m_stride * (j + q);
+            sum[q] = vdupq_n_s32(0);
+            for (int32_t k = 0; k < axis.m_taps; ++k) {
+                sum[q] = vmlal_n_s16(sum[q], vld1_s16(s + k * C), w[k]);
+            }
+        }
+        uint8_t v[8];
+        vst1_u8(v, packArea(sum[0], sum[1], shift));
+        std::memcpy(dst + j * C, v, C);
+        std::memcpy(dst + (j + 1) * C, v + 4, C);
+    }
+    areaRow<C>(axis, src, dst, j, n);
+}
+
+// 16 values per loop
+static void areaColNeon(const uint8_t *const *rows, const int16_t *w, int32_t taps, int16_t *dst, int32_t n) {
+    int32_t j = 0;
+    for (; j + 16 <= n; j += 16) {
+        int32x4_t sum[4];
+        for (int32_t p = 0; p < 4; ++p) {
+            sum[p] = vdupq_n_s32(0);
+        }
+        for (int32_t k = 0; k < taps; ++k) {
+            auto x = vld1q_u8(rows[k] + j);
+            auto a = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(x)));
+            auto b = vreinterpretq_s16_u16(vmovl_high_u8(x));
+            sum[0] = vmlal_n_s16(sum[0], vget_low_s16(a), w[k]);
+            sum[1] = vmlal_high_n_s16(sum[1], a, w[k]);
+            sum[2] = vmlal_n_s16(sum[2], vget_low_s16(b), w[k]);
+            sum[3] = vmlal_high_n_s16(sum[3], b, w[k]);
+        }
+        for (int32_t p = 0; p < 2; ++p) {
+            vst1q_s16(dst + j + p * 8, vcombine_s16(vqmovn_s32(vrshrq_n_s32(sum[2 * p], k_area_v_shift)),
+                                                    vqmovn_s32(vrshrq_n_s32(sum[2 * p + 1], k_area_v_shift))));
+        }
+    }
+    areaCol(rows, w, taps, dst, j, n);
+}
+
+static void areaSumNeon(const uint8_t *const *rows, int32_t taps, int16_t *dst, int32_t n) {
+    int32_t j = 0;
+    for (; j + 16 <= n; j += 16) {
+        auto lo = vdupq_n_u16(0);
+        auto hi = vdupq_n_u16(0);
+        for (int32_t k = 0; k < taps; ++k) {
+            auto x = vld1q_u8(rows[k] + j);
+            lo = vaddw_u8(lo, vget_low_u8(x));
+            hi = vaddw_high_u8(hi, x);
+        }
+        vst1q_s16(dst + j, vreinterpretq_s16_u16(lo));
+        vst1q_s16(dst + j + 8, vreinterpretq_s16_u16(hi));
+    }
+    areaSum(rows, taps, dst, j, n);
+}
+
+void area_row_c1_neon(const AreaAxis &axis, const int16_t *src, uint8_t *dst) {
+    areaRowC1Neon(axis, src, dst);
+}
+
+void area_row_c3_neon(const AreaAxis &axis, const int16_t *src, uint8_t *dst) {
+    areaRowNeon<3>(axis, src, dst);
+}
+
+void area_row_c4_neon(const AreaAxis &axis, const int16_t *src, uint8_t *dst) {
+    areaRowNeon<4>(axis, src, dst);
+}
+
+void area_col_neon(const uint8_t *const *rows, const int16_t *w, int32_t taps, int16_t *dst, int32_t n) {
+    areaColNeon(rows, w, taps, dst, n);
+}
+
+void area_sum_neon(const uint8_t *const *rows, int32_t taps, int16_t *dst, int32_t n) {
+    areaSumNeon(rows, taps, dst, n);
+}
+
+NAMESPACE_END
+
+#endif
@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include "../cvt_color/band.hpp"
+#include "bilinear.hpp"
+#include "cpu_feature.hpp"
+#include "image.hpp"
+
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+ResizeBuffer::ResizeBuffer(ResizeParam param, int32_t src, int32_t dst, int32_t channel)
+    : src_{src}
+    , stride_{dst}
+    , buff_((1L + sizeof(int32_t)) * dst, 0)
+{
+    constexpr auto scale = static_cast<uint32_t>(k_bilinear_scale);
+    auto param_buf = getParam();
+    auto start_buf = getStart();
+    auto scale_d = static_cast<double>(src) / dst;
+    for (int32_t i = 0; i < dst; ++i) {
+        double src_f = 0;
+        if (param.m_half_pixel) {
+            src_f = ((static_cast<double>(i) + 0.5F) * scale_d) - 0.5F;
+        } else if (param.m_align_corner) {
+            src_f = 1 == dst ? 0 : i * (src - 1.0) / (dst - 1);
+        } else {
+            src_f = i * scale_d;
+        }
+        auto src_floor = static_cast<int32_t>(std::floor(src_f));
+        auto alpha = static_cast<uint32_t>(std::lround(scale * (src_f - src_floor)));
+        if (src_floor < 0 || src < 2) {
+            src_floor = 0;
+            alpha = 0;
+        } else if (src_floor >= src - 1) {
+            src_floor = src - 2;
+            alpha = scale;
+        }
+        param_buf[i] = scale - alpha;
+        start_buf[i] = src_floor * channel;
+    }
+}
+
+void bilinear_row_c1_c(const ResizeBuffer &buff, const uint8_t *src, int16_t *dst) {
+    bilinearRow(buff, src, dst, 0, buff.getDst());
+}
+
+void bilinear_col_c(const int16_t *row0, const int16_t *row1, uint8_t beta, uint8_t *dst, int32_t n) {
+    bilinearCol(row0, row1, beta, dst, 0, n);
+}
+
+#ifdef __aarch64__
+#define BILINEAR_NEON(F) F
+#else
+#define BILINEAR_NEON(F) nullptr
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define BILINEAR_X86(F) F
+#else
+#define BILINEAR_X86(F) nullptr
+#endif
+
+constexpr size_t k_tier_num = getValueOf(CpuTier::END);
+
+// Kernel of the active tier from impl, indexed by CpuTier: scalar, neon,
+// sse4.1, avx2, avx512bw
+template <typename F>
+static F getBilinearFunc(const std::array<F, k_tier_num> &impl) {
+    for (auto t = static_cast<int32_t>(getValueOf(getCpuTier())); t >= 0; --t) {
+        if (nullptr != impl[t] && isCpuTierSupported(static_cast<CpuTier>(t))) {
+            return impl[t];
+        }
+    }
+    return impl[0];
+}
+
+static BilinearRowFunction getBilinearRowFunc() {
+    static constexpr std::array<BilinearRowFunction, k_tier_num> impl{
+        bilinear_row_c1_c, BILINEAR_NEON(bilinear_row_c1_neon), nullptr, BILINEAR_X86(bilinear_row_c1_avx2), nullptr};
+    return getBilinearFunc(impl);
+}
+
+static BilinearColFunction getBilinearColFunc() {
+    static constexpr std::array<BilinearColFunction, k_tier_num> impl{
+        bilinear_col_c, BILINEAR_NEON(bilinear_col_neon), nullptr, BILINEAR_X86(bilinear_col_avx2), nullptr};
+    return getBilinearFunc(impl);
+}
+
+#undef BILINEAR_X86
+#undef BILINEAR_NEON
+
+void resizeBilinear(const Image &src, const Image &dst, const ResizeParam &param) {
+    if (ImageFormat::GRAY != src.fmt()) {
+        throw std::invalid_argument("Unsupported resize");
+    }
+    ResizeBuffer buff_h{param, src.rows(), dst.rows()};
+    ResizeBuffer buff_w{param, src.cols(), dst.cols()};
+    auto row_func = getBilinearRowFunc();
+    auto col_func = getBilinearColFunc();
+    auto n = dst.cols();
+    auto row_size = static_cast<size_t>(n);
+    const auto *start_h = buff_h.getStart();
+    const auto *beta = buff_h.getParam();
+
+    // Horizontal passes of the two source rows of the window per band,
+    // source row r in slot r % 2 as the windows only move down
+    std::vector<int16_t> ring;
+    auto init = [&](size_t bands) { ring.resize(bands * 2 * row_size); };
+    forEachRowBand(dst, init, [&](size_t band, int32_t row, int32_t rows) {
+        auto *band_ring = ring.data() + band * 2 * row_size;
+        std::array<int32_t, 2> cached{-1, -1};
+        std::array<const int16_t*, 2> window{};
+        for (auto i = row; i < row + rows; ++i) {
+            for (int32_t k = 0; k < 2; ++k) {
+                auto r = std::min(start_h[i] + k, src.rows() - 1);
+                auto slot = r % 2;
+                auto *buf = band_ring + slot * row_size;
+                if (r != cached[slot]) {
+                    row_func(buff_w, src.ptr(r), buf);
+                    cached[slot] = r;
+                }
+                window[k] = buf;
+            }
+            col_func(window[0], window[1], beta[i], dst.ptr(i), n);
+        }
+    });
+}
+
+NAMESPACE_END
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <vector>
+#include "image.hpp"
+#include "resize.hpp"
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+// Fixed point of the bilinear resize: weights in Q7, the horizontal pass
+// keeps the Q7 sums as int16 rows, the vertical pass rounds back to 8 bit.
+// The SIMD kernels are bit exact to the _c ones
+constexpr uint8_t k_bilinear_shift = 7;
+constexpr int32_t k_bilinear_scale = 1 << k_bilinear_shift;
+
+// Taps of one axis, output i reads the samples getStart()[i] and the one
+// channel after it with the weights getParam()[i] and k_bilinear_scale
+// minus it. Windows are clamped into the source, a single sample source
+// gets the full first weight
+class ResizeBuffer {
+ public:
+    ResizeBuffer(ResizeParam param, int32_t src, int32_t dst, int32_t channel = 1);
+
+    uint8_t *getParam() {
+        return buff_.data() + (sizeof(int32_t) * stride_);
+    }
+
+    int32_t *getStart() {
+        return reinterpret_cast<int32_t*>(buff_.data());    // NOLINT
+    }
+
+    const uint8_t *getParam() const {
+        return buff_.data() + (sizeof(int32_t) * stride_);
+    }
+
+    const int32_t *getStart() const {
+        return reinterpret_cast<const int32_t*>(buff_.data());    // NOLINT
+    }
+
+    int32_t getSrc() const {
+        return src_;
+    }
+
+    int32_t getDst() const {
+        return stride_;
+    }
+ private:
+    int32_t src_{0};
+    int32_t stride_{0};
+    std::vector<uint8_t> buff_;
+};
+
+// Horizontal pass of pixels [j, n) of a gray row
+inline void bilinearRow(const ResizeBuffer &buff, const uint8_t *src, int16_t *dst, int32_t j, int32_t n) {
+    const auto *start = buff.getStart();
+    const auto *param = buff.getParam();
+    for (; j < n; ++j) {
+        const auto *s = src + start[j];
+        // A full first weight does not need the second sample, reading the
+        // first again keeps a single sample row in bounds
+        auto s1 = s[k_bilinear_scale == param[j] ? 0 : 1];
+        dst[j] = static_cast<int16_t>(s[0] * param[j] + s1 * (k_bilinear_scale - param[j]));
+    }
+}
+
+// Vertical pass of values [j, n) of two rows, beta weighing the first
+inline void bilinearCol(const int16_t *row0, const int16_t *row1, uint8_t beta, uint8_t *dst, int32_t j, int32_t n) {
+    constexpr int32_t shift = 2 * k_bilinear_shift;
+    for (; j < n; ++j) {
+        auto sum = row0[j] * beta + row1[j] * (k_bilinear_scale - beta);
+        dst[j] = static_cast<uint8_t>((sum + (1 << (shift - 1))) >> shift);
+    }
+}
+
+// Horizontal pass of one gray row into Q7
+using BilinearRowFunction = void(*)(const ResizeBuffer&, const uint8_t*, int16_t*);
+// Vertical pass of n values from two rows
+using BilinearColFunction = void(*)(const int16_t*, const int16_t*, uint8_t, uint8_t*, int32_t);
+
+void bilinear_row_c1_c(const ResizeBuffer&, const uint8_t*, int16_t*);
+void bilinear_row_c1_neon(const ResizeBuffer&, const uint8_t*, int16_t*);
+void bilinear_row_c1_avx2(const ResizeBuffer&, const uint8_t*, int16_t*);
+
+void bilinear_col_c(const int16_t*, const int16_t*, uint8_t, uint8_t*, int32_t);
+void bilinear_col_neon(const int16_t*, const int16_t*, uint8_t, uint8_t*, int32_t);
+void bilinear_col_avx2(const int16_t*, const int16_t*, uint8_t, uint8_t*, int32_t);
+
+// Bilinear resize of GRAY images at any ratio
+void resizeBilinear(const Image &src, const Image &dst, const ResizeParam&);
+
+NAMESPACE_END
@@ -0,0 +1,74 @@
+#include "../cvt_color/x86.hpp"
+#include "bilinear.hpp"
+#include "types.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+NAMESPACE_BEGIN
+
+// 8 pixels per loop, the 2 source bytes of every pixel are gathered as one
+// int32 and widened next to its pair of weights
+AVX2_FUNC static void bilinearRowC1Avx2(const ResizeBuffer &buff, const uint8_t *src, int16_t *dst) {
+    const auto pair = _mm256_setr_epi8(0, -1, 1, -1, 4, -1, 5, -1, 8, -1, 9, -1, 12, -1, 13, -1,
+                                       0, -1, 1, -1, 4, -1, 5, -1, 8, -1, 9, -1, 12, -1, 13, -1);
+    const auto scale = _mm256_set1_epi32(k_bilinear_scale);
+    // Locals, the stores below may alias the tables
+    auto n = buff.getDst();
+    const auto *start = buff.getStart();
+    const auto *param = buff.getParam();
+    // Gathers read 4 bytes
+    auto last = buff.getSrc() - 4;
+    int32_t j = 0;
+    // Windows only move right, so the first ones reading past the end of
+    // the row end the loop
+    for (; j + 8 <= n && start[j + 7] <= last; j += 8) {
+        auto idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(start + j));
+        // All set as the starts are not negative. Gathering under a mask
+        // the compiler cannot fold keeps the zeros merged into, the
+        // register would otherwise chain the loops
+        auto mask = _mm256_cmpgt_epi32(idx, _mm256_set1_epi32(-1));
+        auto x = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), reinterpret_cast<const int*>(src), idx, mask, 1);
+        x = _mm256_shuffle_epi8(x, pair);
+        auto w0 = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(param + j)));
+        auto w = _mm256_or_si256(w0, _mm256_slli_epi32(_mm256_sub_epi32(scale, w0), 16));
+        auto s = _mm256_madd_epi16(x, w);
+        s = _mm256_permute4x64_epi64(_mm256_packs_epi32(s, s), 0x08);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + j), _mm256_castsi256_si128(s));
+    }
+    bilinearRow(buff, src, dst, j, n);
+}
+
+// 16 values per loop, the two rows interleaved for madd
+AVX2_FUNC static void bilinearColAvx2(const int16_t *row0, const int16_t *row1, uint8_t beta, uint8_t *dst, int32_t n) {
+    constexpr int32_t shift = 2 * k_bilinear_shift;
+    const auto round = _mm256_set1_epi32(1 << (shift - 1));
+    const auto wp = _mm256_set1_epi32(beta | ((k_bilinear_scale - beta) << 16));
+    int32_t j = 0;
+    for (; j + 16 <= n; j += 16) {
+        auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row0 + j));
+        auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row1 + j));
+        auto lo = _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), wp);
+        auto hi = _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), wp);
+        lo = _mm256_srai_epi32(_mm256_add_epi32(lo, round), shift);
+        hi = _mm256_srai_epi32(_mm256_add_epi32(hi, round), shift);
+        // The unpacks and packs work per lane, so the order comes back
+        auto v = _mm256_packs_epi32(lo, hi);
+        v = _mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), 0x08);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + j), _mm256_castsi256_si128(v));
+    }
+    bilinearCol(row0, row1, beta, dst, j, n);
+}
+
+void bilinear_row_c1_avx2(const ResizeBuffer &buff, const uint8_t *src, int16_t *dst) {
+    bilinearRowC1Avx2(buff, src, dst);
+}
+
+void bilinear_col_avx2(const int16_t *row0, const int16_t *row1, uint8_t beta, uint8_t *dst, int32_t n) {
+    bilinearColAvx2(row0, row1, beta, dst, n);
+}
+
+NAMESPACE_END
+
+#endif
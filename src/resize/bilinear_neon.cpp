@@ -0,0 +1,74 @@
+#include "bilinear.hpp"
+#include "types.hpp"
+
+#ifdef __aarch64__
+
+#include <arm_neon.h>
+
+NAMESPACE_BEGIN
+
+// The 2 source bytes of pixels L to 7 loaded into their lanes of the
+// first and second sample vectors
+template <int32_t L>
+static inline uint8x8x2_t loadPairs(const uint8_t *src, const int32_t *start, uint8x8x2_t x) {
+    x = vld2_lane_u8(src + start[L], x, L);
+    if constexpr (L < 7) {
+        return loadPairs<L + 1>(src, start, x);
+    } else {
+        return x;
+    }
+}
+
+// 8 pixels per loop, the pairs of source bytes are gathered a lane at a
+// time by ld2, the sums of at most 255 * k_bilinear_scale fit int16
+static void bilinearRowC1Neon(const ResizeBuffer &buff, const uint8_t *src, int16_t *dst) {
+    const auto scale = vdup_n_u8(k_bilinear_scale);
+    // Locals, the stores below may alias the tables
+    auto n = buff.getDst();
+    const auto *start = buff.getStart();
+    const auto *param = buff.getParam();
+    // Both samples are read, a full first weight zeroes the second
+    auto last = buff.getSrc() - 2;
+    int32_t j = 0;
+    // Windows only move right, so the first ones reading past the end of
+    // the row end the loop
+    for (; j + 8 <= n && start[j + 7] <= last; j += 8) {
+        auto x = loadPairs<0>(src, start + j, uint8x8x2_t{{vdup_n_u8(0), vdup_n_u8(0)}});
+        auto w = vld1_u8(param + j);
+        auto s = vmlal_u8(vmull_u8(x.val[0], w), x.val[1], vsub_u8(scale, w));
+        vst1q_s16(dst + j, vreinterpretq_s16_u16(s));
+    }
+    bilinearRow(buff, src, dst, j, n);
+}
+
+// 16 values per loop
+static void bilinearColNeon(const int16_t *row0, const int16_t *row1, uint8_t beta, uint8_t *dst, int32_t n) {
+    constexpr int32_t shift = 2 * k_bilinear_shift;
+    const int16_t w0 = beta;
+    const int16_t w1 = k_bilinear_scale - beta;
+    int32_t j = 0;
+    for (; j + 16 <= n; j += 16) {
+        int16x8_t v[2];
+        for (int32_t p = 0; p < 2; ++p) {
+            auto a = vld1q_s16(row0 + j + p * 8);
+            auto b = vld1q_s16(row1 + j + p * 8);
+            auto lo = vmlal_n_s16(vmull_n_s16(vget_low_s16(a), w0), vget_low_s16(b), w1);
+            auto hi = vmlal_high_n_s16(vmull_high_n_s16(a, w0), b, w1);
+            v[p] = vcombine_s16(vqmovn_s32(vrshrq_n_s32(lo, shift)), vqmovn_s32(vrshrq_n_s32(hi, shift)));
+        }
+        vst1q_u8(dst + j, vcombine_u8(vqmovun_s16(v[0]), vqmovun_s16(v[1])));
+    }
+    bilinearCol(row0, row1, beta, dst, j, n);
+}
+
+void bilinear_row_c1_neon(const ResizeBuffer &buff, const uint8_t *src, int16_t *dst) {
+    bilinearRowC1Neon(buff, src, dst);
+}
+
+void bilinear_col_neon(const int16_t *row0, const int16_t *row1, uint8_t beta, uint8_t *dst, int32_t n) {
+    bilinearColNeon(row0, row1, beta, dst, n);
+}
+
+NAMESPACE_END
+
+#endif
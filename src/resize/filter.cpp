@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+#include "../cvt_color/band.hpp"
+#include "cpu_feature.hpp"
+#include "filter.hpp"
+#include "image.hpp"
+#include "resize.hpp"
+
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+// Keys cubic
+static double getKeysWeight(double x, double a) {
+    x = std::abs(x);
+    if (x <= 1) {
+        return ((a + 2) * x - (a + 3)) * x * x + 1;
+    }
+    if (x < 2) {
+        return ((a * x - 5 * a) * x + 8 * a) * x - 4 * a;
+    }
+    return 0;
+}
+
+static double getCubicWeight(double x) {
+    return getKeysWeight(x, -0.75);
+}
+
+static double getCatmullRomWeight(double x) {
+    return getKeysWeight(x, -0.5);
+}
+
+// Mitchell-Netravali with B = C = 1 / 3
+static double getMitchellWeight(double x) {
+    x = std::abs(x);
+    if (x < 1) {
+        return ((7 * x - 12) * x * x + 16.0 / 3) / 6;
+    }
+    if (x < 2) {
+        return (((-7.0 / 3 * x + 12) * x - 20) * x + 32.0 / 3) / 6;
+    }
+    return 0;
+}
+
+static double getSinc(double x) {
+    if (0 == x) {
+        return 1;
+    }
+    x *= std::numbers::pi;
+    return std::sin(x) / x;
+}
+
+static double getLanczosWeight(double x) {
+    return std::abs(x) < 3 ? getSinc(x) * getSinc(x / 3) : 0;
+}
+
+// Weight function reaching zero at m_support, stretched by the scale on
+// downscaling when m_widen so the filter also removes what the dst
+// cannot hold
+struct ResizeFilter {
+    double (*m_weight)(double){nullptr};
+    double m_support{0};
+    bool m_widen{false};
+};
+
+static ResizeFilter getResizeFilter(ResizeType type) {
+    switch (type) {
+        case ResizeType::CUBIC:
+            return {getCubicWeight, 2, false};
+        case ResizeType::LANCZOS:
+            return {getLanczosWeight, 3, true};
+        case ResizeType::MITCHELL:
+            return {getMitchellWeight, 2, true};
+        case ResizeType::CATMULL_ROM:
+            return {getCatmullRomWeight, 2, true};
+        default:
+            throw std::invalid_argument("Unsupported resize");
+    }
+}
+
+FilterAxis getFilterAxis(int32_t src, int32_t dst, const ResizeParam &param) {
+    auto filter = getResizeFilter(param.m_resize_type);
+    auto scale = static_cast<double>(src) / dst;
+    auto stretch = filter.m_widen ? std::max(scale, 1.0) : 1.0;
+    auto radius = filter.m_support * stretch;
+    std::vector<double> centre(dst);
+    std::vector<int32_t> first(dst);
+    std::vector<int32_t> last(dst);
+    FilterAxis axis;
+    axis.m_src = src;
+    for (int32_t i = 0; i < dst; ++i) {
+        if (param.m_half_pixel) {
+            centre[i] = (i + 0.5) * scale - 0.5;
+        } else if (param.m_align_corner) {
+            centre[i] = 1 == dst ? 0 : i * (src - 1.0) / (dst - 1);
+        } else {
+            centre[i] = i * scale;
+        }
+        // Samples strictly within the radius, the weight at it is zero
+        constexpr double eps = 1e-9;
+        first[i] = static_cast<int32_t>(std::floor(centre[i] - radius + eps)) + 1;
+        last[i] = static_cast<int32_t>(std::ceil(centre[i] + radius - eps)) - 1;
+        axis.m_taps = std::max(axis.m_taps, last[i] - first[i] + 1);
+    }
+    axis.m_taps = std::min(axis.m_taps, src);
+    axis.m_chunks = (axis.m_taps + k_filter_chunk - 1) / k_filter_chunk;
+    axis.m_start.resize(dst);
+    axis.m_weight.resize(1UL * axis.m_chunks * k_filter_chunk * dst);
+
+    std::vector<double> w(axis.m_taps);
+    std::vector<int16_t> q(axis.m_taps);
+    for (int32_t i = 0; i < dst; ++i) {
+        auto start = std::clamp(first[i], 0, src - axis.m_taps);
+        std::fill(w.begin(), w.end(), 0.0);
+        double total = 0;
+        for (auto p = first[i]; p <= last[i]; ++p) {
+            auto v = filter.m_weight((p - centre[i]) / stretch);
+            w[std::clamp(p, 0, src - 1) - start] += v;
+            total += v;
+        }
+
+        // Rounded weights sum to one exactly, the largest takes the error
+        int32_t sum = 0;
+        for (int32_t k = 0; k < axis.m_taps; ++k) {
+            q[k] = static_cast<int16_t>(std::lround(w[k] / total * (1 << k_filter_weight_bits)));
+            sum += q[k];
+        }
+        auto top = std::max_element(q.begin(), q.end(), [](int16_t a, int16_t b) { return std::abs(a) < std::abs(b); });
+        *top = static_cast<int16_t>(*top + (1 << k_filter_weight_bits) - sum);
+        for (int32_t k = 0; k < axis.m_taps; ++k) {
+            axis.m_weight[((k / k_filter_chunk) * dst + i) * k_filter_chunk + k % k_filter_chunk] = q[k];
+        }
+        axis.m_start[i] = start;
+    }
+    return axis;
+}
+
+#define FILTER_ROW_C(C)                                                         \
+    void filter_row_c##C##_c(const FilterAxis &axis, const uint8_t *src, int16_t *dst) \
+    {                                                                           \
+        filterRow<C>(axis, src, dst, 0, axis.m_start.size());                   \
+    }
+
+FILTER_ROW_C(1)
+FILTER_ROW_C(3)
+FILTER_ROW_C(4)
+
+#undef FILTER_ROW_C
+
+void filter_col_c(const int16_t *const *rows, const int16_t *w, int32_t taps, uint8_t *dst, int32_t n) {
+    filterCol(rows, w, taps, dst, 0, n);
+}
+
+#ifdef __aarch64__
+#define FILTER_NEON(F) F
+#else
+#define FILTER_NEON(F) nullptr
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define FILTER_X86(F) F
+#else
+#define FILTER_X86(F) nullptr
+#endif
+
+constexpr size_t k_tier_num = getValueOf(CpuTier::END);
+
+// Kernel of the active tier from impl, indexed by CpuTier: scalar, neon,
+// sse4.1, avx2, avx512bw
+template <typename F>
+static F getFilterFunc(const std::array<F, k_tier_num> &impl) {
+    for (auto t = static_cast<int32_t>(getValueOf(getCpuTier())); t >= 0; --t) {
+        if (nullptr != impl[t] && isCpuTierSupported(static_cast<CpuTier>(t))) {
+            return impl[t];
+        }
+    }
+    return impl[0];
+}
+
+#define FILTER_ROW_IMPL(C)                                                      \
+    std::array<FilterRowFunction, k_tier_num>{filter_row_##C##_c, FILTER_NEON(filter_row_##C##_neon), \
+                                              nullptr, FILTER_X86(filter_row_##C##_avx2), nullptr}
+
+static FilterRowFunction getFilterRowFunc(int32_t channel) {
+    static constexpr std::array<std::array<FilterRowFunction, k_tier_num>, 3> impl{
+        FILTER_ROW_IMPL(c1), FILTER_ROW_IMPL(c3), FILTER_ROW_IMPL(c4)};
+    return getFilterFunc(impl[1 == channel ? 0 : 3 == channel ? 1 : 2]);
+}
+
+#undef FILTER_ROW_IMPL
+
+static FilterColFunction getFilterColFunc() {
+    static constexpr std::array<FilterColFunction, k_tier_num> impl{
+        filter_col_c, FILTER_NEON(filter_col_neon), nullptr, FILTER_X86(filter_col_avx2), nullptr};
+    return getFilterFunc(impl);
+}
+
+#undef FILTER_X86
+#undef FILTER_NEON
+
+void resizeFilter(const Image &src, const Image &dst, const ResizeParam &param) {
+    auto fmt = src.fmt();
+    if (ImageFormat::GRAY != fmt && ImageFormat::RGB != fmt && ImageFormat::BGR != fmt &&
+        ImageFormat::RGBA != fmt && ImageFormat::BGRA != fmt) {
+        throw std::invalid_argument("Unsupported resize");
+    }
+    auto channel = static_cast<int32_t>(getPlaneStride(1, fmt, 0));
+    auto h_axis = getFilterAxis(src.cols(), dst.cols(), param);
+    auto v_axis = getFilterAxis(src.rows(), dst.rows(), param);
+    auto row_func = getFilterRowFunc(channel);
+    auto col_func = getFilterColFunc();
+    auto n = dst.cols() * channel;
+    auto row_size = static_cast<size_t>(n) + k_filter_row_pad;
+    auto taps = v_axis.m_taps;
+
+    // Ring of the horizontal passes of the source rows of the window and
+    // the window itself per band, source row r in slot r % taps as the
+    // windows only move down
+    std::vector<int16_t> ring;
+    std::vector<int32_t> cached;
+    std::vector<const int16_t*> window;
+    std::vector<int16_t> weight;
+    auto init = [&](size_t bands) {
+        ring.resize(bands * taps * row_size);
+        cached.resize(bands * taps, -1);
+        window.resize(bands * taps);
+        weight.resize(bands * taps);
+    };
+    forEachRowBand(dst, init, [&](size_t band, int32_t row, int32_t rows) {
+        auto *band_ring = ring.data() + band * taps * row_size;
+        auto *band_cached = cached.data() + band * taps;
+        auto *band_window = window.data() + band * taps;
+        auto *band_weight = weight.data() + band * taps;
+        for (auto i = row; i < row + rows; ++i) {
+            for (int32_t k = 0; k < taps; ++k) {
+                auto r = v_axis.m_start[i] + k;
+                auto slot = r % taps;
+                auto *buf = band_ring + slot * row_size;
+                if (r != band_cached[slot]) {
+                    row_func(h_axis, src.ptr(r), buf);
+                    band_cached[slot] = r;
+                }
+                band_window[k] = buf;
+                band_weight[k] = getFilterWeight(v_axis, i, k);
+            }
+            col_func(band_window, band_weight, taps, dst.ptr(i), n);
+        }
+    });
+}
+
+NAMESPACE_END
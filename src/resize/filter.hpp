@@ -0,0 +1,98 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+#include "image.hpp"
+#include "resize.hpp"
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+// Fixed point of the separable filter resize: weights in Q14, the
+// horizontal pass rounds into Q6 int16 rows, the vertical pass rounds
+// back to 8 bit. The SIMD kernels are bit exact to the _c ones
+constexpr int32_t k_filter_chunk = 4;
+constexpr int32_t k_filter_weight_bits = 14;
+constexpr int32_t k_filter_row_bits = 6;
+constexpr int32_t k_filter_h_shift = k_filter_weight_bits - k_filter_row_bits;
+constexpr int32_t k_filter_v_shift = k_filter_weight_bits + k_filter_row_bits;
+// Int16 written past an intermediate row by the SIMD kernels
+constexpr int32_t k_filter_row_pad = 4;
+
+// Taps of one axis, output i reads the samples [m_start[i], m_start[i] +
+// m_taps). Windows are clamped into the source and the weights of the
+// clamped samples folded onto the edge. Weights come in chunks of 4 taps,
+// chunk m of all outputs before chunk m + 1, zero past m_taps
+struct FilterAxis {
+    int32_t m_src{0};
+    int32_t m_taps{0};
+    int32_t m_chunks{0};
+    std::vector<int32_t> m_start;
+    std::vector<int16_t> m_weight;
+};
+
+FilterAxis getFilterAxis(int32_t src, int32_t dst, const ResizeParam&);
+
+// Weight of tap k of output i
+inline int16_t getFilterWeight(const FilterAxis &axis, size_t i, int32_t k) {
+    return axis.m_weight[((k / k_filter_chunk) * axis.m_start.size() + i) * k_filter_chunk + k % k_filter_chunk];
+}
+
+// Horizontal pass of pixels [j, n) of a row
+template <int32_t C>
+inline void filterRow(const FilterAxis &axis, const uint8_t *src, int16_t *dst, size_t j, size_t n) {
+    // Weights between two chunks of a pixel
+    auto step = axis.m_start.size() * k_filter_chunk;
+    for (; j < n; ++j) {
+        const auto *s = src + static_cast<size_t>(axis.m_start[j]) * C;
+        const auto *w = axis.m_weight.data() + j * k_filter_chunk;
+        int32_t sum[C] = {};
+        for (int32_t k = 0; k < axis.m_taps; ++k) {
+            auto wk = w[(k / k_filter_chunk) * step + k % k_filter_chunk];
+            for (int32_t c = 0; c < C; ++c) {
+                sum[c] += wk * s[k * C + c];
+            }
+        }
+        for (int32_t c = 0; c < C; ++c) {
+            dst[j * C + c] = static_cast<int16_t>((sum[c] + (1 << (k_filter_h_shift - 1))) >> k_filter_h_shift);
+        }
+    }
+}
+
+// Vertical pass of values [j, n) of the taps rows
+inline void filterCol(const int16_t *const *rows, const int16_t *w, int32_t taps, uint8_t *dst, int32_t j, int32_t n) {
+    for (; j < n; ++j) {
+        int32_t sum = 0;
+        for (int32_t k = 0; k < taps; ++k) {
+            sum += w[k] * rows[k][j];
+        }
+        dst[j] = static_cast<uint8_t>(std::clamp((sum + (1 << (k_filter_v_shift - 1))) >> k_filter_v_shift, 0, 255));
+    }
+}
+
+// Horizontal pass of one row into Q6, writing up to k_filter_row_pad int16
+// past it
+using FilterRowFunction = void(*)(const FilterAxis&, const uint8_t*, int16_t*);
+// Vertical pass of n values from the taps rows of the window
+using FilterColFunction = void(*)(const int16_t *const*, const int16_t*, int32_t, uint8_t*, int32_t);
+
+#define ADD_FILTER_ROW(C)                                                       \
+    void filter_row_##C##_c(const FilterAxis&, const uint8_t*, int16_t*);       \
+    void filter_row_##C##_neon(const FilterAxis&, const uint8_t*, int16_t*);    \
+    void filter_row_##C##_avx2(const FilterAxis&, const uint8_t*, int16_t*)
+
+ADD_FILTER_ROW(c1);
+ADD_FILTER_ROW(c3);
+ADD_FILTER_ROW(c4);
+
+#undef ADD_FILTER_ROW
+
+void filter_col_c(const int16_t *const*, const int16_t*, int32_t, uint8_t*, int32_t);
+void filter_col_neon(const int16_t *const*, const int16_t*, int32_t, uint8_t*, int32_t);
+void filter_col_avx2(const int16_t *const*, const int16_t*, int32_t, uint8_t*, int32_t);
+
+// Separable resize of 1, 3 and 4 channel 8 bit images with the filter of
+// m_resize_type, one of CUBIC, LANCZOS, MITCHELL and CATMULL_ROM
+void resizeFilter(const Image &src, const Image &dst, const ResizeParam&);
+
+NAMESPACE_END
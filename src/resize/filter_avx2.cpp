@@ -0,0 +1,140 @@
+#include "../cvt_color/x86.hpp"
+#include "filter.hpp"
+#include "types.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+NAMESPACE_BEGIN
+
+// 8 pixels per loop, each chunk of 4 source bytes of every window is
+// gathered as one int32 and widened next to the 4 weights of its pixel
+AVX2_FUNC static void filterRowC1Avx2(const FilterAxis &axis, const uint8_t *src, int16_t *dst) {
+    // Locals, the stores below may alias the axis
+    auto n = axis.m_start.size();
+    const auto *start = axis.m_start.data();
+    const auto *weight = axis.m_weight.data();
+    auto chunks = axis.m_chunks;
+    const auto round = _mm256_set1_epi32(1 << (k_filter_h_shift - 1));
+    const auto order = _mm256_setr_epi32(0, 1, 4, 5, 2, 3, 6, 7);
+    auto last = axis.m_src - k_filter_chunk * chunks;
+    size_t j = 0;
+    // Windows only move right, so the first ones reading past the end of
+    // the row end the loop
+    for (; j + 8 <= n && start[j + 7] <= last; j += 8) {
+        auto idx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(start + j));
+        // All set as the starts are not negative. Gathering under a mask
+        // the compiler cannot fold keeps the zeros merged into, the
+        // register would otherwise chain the loops
+        auto mask = _mm256_cmpgt_epi32(idx, _mm256_set1_epi32(-1));
+        // Pixels 0 1 | 2 3 in a, 4 5 | 6 7 in b
+        auto a = _mm256_setzero_si256();
+        auto b = _mm256_setzero_si256();
+        const auto *w = weight + j * k_filter_chunk;
+        for (int32_t m = 0; m < chunks; ++m, w += n * k_filter_chunk) {
+            auto x = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), reinterpret_cast<const int*>(src + k_filter_chunk * m),
+                                                 idx, mask, 1);
+            auto w0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w));
+            auto w1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(w + 16));
+            a = _mm256_add_epi32(a, _mm256_madd_epi16(_mm256_cvtepu8_epi16(_mm256_castsi256_si128(x)), w0));
+            b = _mm256_add_epi32(b, _mm256_madd_epi16(_mm256_cvtepu8_epi16(_mm256_extracti128_si256(x, 1)), w1));
+        }
+        // Pixels 0 1 4 5 | 2 3 6 7 put back in order
+        auto s = _mm256_permutevar8x32_epi32(_mm256_hadd_epi32(a, b), order);
+        s = _mm256_srai_epi32(_mm256_add_epi32(s, round), k_filter_h_shift);
+        s = _mm256_permute4x64_epi64(_mm256_packs_epi32(s, s), 0x08);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + j), _mm256_castsi256_si128(s));
+    }
+    filterRow<1>(axis, src, dst, j, n);
+}
+
+// 2 pixels per loop, one per lane. The 16 bytes from each chunk of 4 taps
+// are split into channel pairs of taps 0 1 and 2 3 for the weight pairs
+template <int32_t C>
+AVX2_FUNC static void filterRowAvx2(const FilterAxis &axis, const uint8_t *src, int16_t *dst) {
+    const auto split = 4 == C
+        ? _mm256_setr_epi8(0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15,
+                           0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15)
+        : _mm256_setr_epi8(0, 3, 1, 4, 2, 5, -1, -1, 6, 9, 7, 10, 8, 11, -1, -1,
+                           0, 3, 1, 4, 2, 5, -1, -1, 6, 9, 7, 10, 8, 11, -1, -1);
+    // Locals, the stores below may alias the axis
+    auto n = axis.m_start.size();
+    const auto *start = axis.m_start.data();
+    const auto *weight = axis.m_weight.data();
+    auto chunks = axis.m_chunks;
+    const auto round = _mm256_set1_epi32(1 << (k_filter_h_shift - 1));
+    const auto zero = _mm256_setzero_si256();
+    auto row_bytes = axis.m_src * C;
+    auto reach = k_filter_chunk * (chunks - 1) * C + 16;
+    size_t j = 0;
+    for (; j + 2 <= n && start[j + 1] * C + reach <= row_bytes; j += 2) {
+        const auto *s0 = src + start[j] * C;
+        const auto *s1 = src + start[j + 1] * C;
+        auto sum = _mm256_setzero_si256();
+        for (int32_t m = 0; m < chunks; ++m) {
+            auto x = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s0 + k_filter_chunk * m * C))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1 + k_filter_chunk * m * C)), 1);
+            x = _mm256_shuffle_epi8(x, split);
+            // The 4 weights of both pixels, one pixel per lane
+            auto w = _mm_loadu_si128(reinterpret_cast<const __m128i*>(weight + (m * n + j) * k_filter_chunk));
+            auto ww = _mm256_permute4x64_epi64(_mm256_castsi128_si256(w), 0x50);
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_unpacklo_epi8(x, zero), _mm256_shuffle_epi32(ww, 0x00)));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_unpackhi_epi8(x, zero), _mm256_shuffle_epi32(ww, 0x55)));
+        }
+        auto s = _mm256_srai_epi32(_mm256_add_epi32(sum, round), k_filter_h_shift);
+        s = _mm256_packs_epi32(s, s);
+        // 4 int16 each, the fourth of rgb is overwritten by the next pixel
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + j * C), _mm256_castsi256_si128(s));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + (j + 1) * C), _mm256_extracti128_si256(s, 1));
+    }
+    filterRow<C>(axis, src, dst, j, n);
+}
+
+// 16 values per loop, the rows taken in pairs for madd, an odd last row
+// is paired with itself under a zero weight
+AVX2_FUNC static void filterColAvx2(const int16_t *const *rows, const int16_t *w, int32_t taps, uint8_t *dst, int32_t n) {
+    const auto round = _mm256_set1_epi32(1 << (k_filter_v_shift - 1));
+    int32_t j = 0;
+    for (; j + 16 <= n; j += 16) {
+        auto lo = _mm256_setzero_si256();
+        auto hi = _mm256_setzero_si256();
+        for (int32_t k = 0; k < taps; k += 2) {
+            auto k1 = k + 1 < taps ? k + 1 : k;
+            auto w1 = k + 1 < taps ? w[k + 1] : 0;
+            auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows[k] + j));
+            auto b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rows[k1] + j));
+            auto wp = _mm256_unpacklo_epi16(_mm256_set1_epi16(w[k]), _mm256_set1_epi16(w1));
+            lo = _mm256_add_epi32(lo, _mm256_madd_epi16(_mm256_unpacklo_epi16(a, b), wp));
+            hi = _mm256_add_epi32(hi, _mm256_madd_epi16(_mm256_unpackhi_epi16(a, b), wp));
+        }
+        lo = _mm256_srai_epi32(_mm256_add_epi32(lo, round), k_filter_v_shift);
+        hi = _mm256_srai_epi32(_mm256_add_epi32(hi, round), k_filter_v_shift);
+        // The unpacks and packs work per lane, so the order comes back
+        auto v = _mm256_packs_epi32(lo, hi);
+        v = _mm256_permute4x64_epi64(_mm256_packus_epi16(v, v), 0x08);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + j), _mm256_castsi256_si128(v));
+    }
+    filterCol(rows, w, taps, dst, j, n);
+}
+
+void filter_row_c1_avx2(const FilterAxis &axis, const uint8_t *src, int16_t *dst) {
+    filterRowC1Avx2(axis, src, dst);
+}
+
+void filter_row_c3_avx2(const FilterAxis &axis, const uint8_t *src, int16_t *dst) {
+    filterRowAvx2<3>(axis, src, dst);
+}
+
+void filter_row_c4_avx2(const FilterAxis &axis, const uint8_t *src, int16_t *dst) {
+    filterRowAvx2<4>(axis, src, dst);
+}
+
+void filter_col_avx2(const int16_t *const *rows, const int16_t *w, int32_t taps, uint8_t *dst, int32_t n) {
+    filterColAvx2(rows, w, taps, dst, n);
+}
+
+NAMESPACE_END
+
+#endif
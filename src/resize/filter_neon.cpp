@@ -0,0 +1,141 @@
+#include "filter.hpp"
+#include "types.hpp"
+
+#ifdef __aarch64__
+
+#include <arm_neon.h>
+
+NAMESPACE_BEGIN
+
+// 4 taps of one channel widened from the low 4 of 8 loaded bytes
+static inline int16x4_t loadTaps(const uint8_t *src) {
+    return vreinterpret_s16_u16(vget_low_u16(vmovl_u8(vld1_u8(src))));
+}
+
+// Q6 of 4 sums, same rounding as filterRow
+static inline int16x4_t packRow(int32x4_t sum) {
+    return vqmovn_s32(vrshrq_n_s32(sum, k_filter_h_shift));
+}
+
+// 4 pixels per loop, one accumulator each, the 4 taps of a chunk are
+// multiplied by the 4 weights of their pixel and the lanes summed at the end
+static void filterRowC1Neon(const FilterAxis &axis, const uint8_t *src, int16_t *dst) {
+    // Locals, the stores below may alias the axis
+    auto n = axis.m_start.size();
+    const auto *start = axis.m_start.data();
+    const auto *weight = axis.m_weight.data();
+    auto chunks = axis.m_chunks;
+    // Each chunk loads 8 bytes to use 4
+    auto last = axis.m_src - k_filter_chunk * chunks - 4;
+    size_t j = 0;
+    // Windows only move right, so the first ones reading past the end of
+    // the row end the loop
+    for (; j + 4 <= n && start[j + 3] <= last; j += 4) {
+        int32x4_t sum[4];
+        for (int32_t p = 0; p < 4; ++p) {
+            sum[p] = vdupq_n_s32(0);
+        }
+        const auto *w = weight + j * k_filter_chunk;
+        for (int32_t m = 0; m < chunks; ++m, w += n * k_filter_chunk) {
+            for (int32_t p = 0; p < 4; ++p) {
+                auto x = loadTaps(src + start[j + p] + k_filter_chunk * m);
+                sum[p] = vmlal_s16(sum[p], x, vld1_s16(w + p * k_filter_chunk));
+            }
+        }
+        auto s = vpaddq_s32(vpaddq_s32(sum[0], sum[1]), vpaddq_s32(sum[2], sum[3]));
+        vst1_s16(dst + j, packRow(s));
+    }
+    filterRow<1>(axis, src, dst, j, n);
+}
+
+// 1 pixel per loop, the 16 bytes from each chunk of 4 taps are widened and
+// each tap's channels multiplied by its weight lane
+template <int32_t C>
+static void filterRowNeon(const FilterAxis &axis, const uint8_t *src, int16_t *dst) {
+    // Locals, the stores below may alias the axis
+    auto n = axis.m_start.size();
+    const auto *start = axis.m_start.data();
+    const auto *weight = axis.m_weight.data();
+    auto chunks = axis.m_chunks;
+    auto row_bytes = axis.m_src * C;
+    auto reach = k_filter_chunk * (chunks - 1) * C + 16;
+    size_t j = 0;
+    for (; j < n && start[j] * C + reach <= row_bytes; ++j) {
+        const auto *s = src + start[j] * C;
+        auto sum = vdupq_n_s32(0);
+        for (int32_t m = 0; m < chunks; ++m) {
+            auto x = vld1q_u8(s + k_filter_chunk * m * C);
+            auto lo = vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(x)));
+            auto hi = vreinterpretq_s16_u16(vmovl_high_u8(x));
+            auto w = vld1_s16(weight + (m * n + j) * k_filter_chunk);
+            // Channels of tap k start at byte k * C, rgb leaves a fourth
+            // lane from the next tap that lands past the pixel
+            int16x4_t t[4];
+            if constexpr (4 == C) {
+                t[0] = vget_low_s16(lo);
+                t[1] = vget_high_s16(lo);
+                t[2] = vget_low_s16(hi);
+                t[3] = vget_high_s16(hi);
+            } else {
+                t[0] = vget_low_s16(lo);
+                t[1] = vget_low_s16(vextq_s16(lo, hi, 3));
+                t[2] = vget_low_s16(vextq_s16(lo, hi, 6));
+                t[3] = vget_low_s16(vextq_s16(hi, hi, 1));
+            }
+            sum = vmlal_lane_s16(sum, t[0], w, 0);
+            sum = vmlal_lane_s16(sum, t[1], w, 1);
+            sum = vmlal_lane_s16(sum, t[2], w, 2);
+            sum = vmlal_lane_s16(sum, t[3], w, 3);
+        }
+        // 4 int16, the fourth of rgb is overwritten by the next pixel
+        vst1_s16(dst + j * C, packRow(sum));
+    }
+    filterRow<C>(axis, src, dst, j, n);
+}
+
+// 16 values per loop, the int32 sums narrow with saturation to the clamp
+// of filterCol
+static void filterColNeon(const int16_t *const *rows, const int16_t *w, int32_t taps, uint8_t *dst, int32_t n) {
+    int32_t j = 0;
+    for (; j + 16 <= n; j += 16) {
+        int32x4_t sum[4];
+        for (int32_t p = 0; p < 4; ++p) {
+            sum[p] = vdupq_n_s32(0);
+        }
+        for (int32_t k = 0; k < taps; ++k) {
+            auto a = vld1q_s16(rows[k] + j);
+            auto b = vld1q_s16(rows[k] + j + 8);
+            sum[0] = vmlal_n_s16(sum[0], vget_low_s16(a), w[k]);
+            sum[1] = vmlal_high_n_s16(sum[1], a, w[k]);
+            sum[2] = vmlal_n_s16(sum[2], vget_low_s16(b), w[k]);
+            sum[3] = vmlal_high_n_s16(sum[3], b, w[k]);
+        }
+        int16x8_t v[2];
+        for (int32_t p = 0; p < 2; ++p) {
+            v[p] = vcombine_s16(vqmovn_s32(vrshrq_n_s32(sum[2 * p], k_filter_v_shift)),
+                                vqmovn_s32(vrshrq_n_s32(sum[2 * p + 1], k_filter_v_shift)));
+        }
+        vst1q_u8(dst + j, vcombine_u8(vqmovun_s16(v[0]), vqmovun_s16(v[1])));
+    }
+    filterCol(rows, w, taps, dst, j, n);
+}
+
+void filter_row_c1_neon(const FilterAxis &axis, const uint8_t *src, int16_t *dst) {
+    filterRowC1Neon(axis, src, dst);
+}
+
+void filter_row_c3_neon(const FilterAxis &axis, const uint8_t *src, int16_t *dst) {
+    filterRowNeon<3>(axis, src, dst);
+}
+
+void filter_row_c4_neon(const FilterAxis &axis, const uint8_t *src, int16_t *dst) {
+    filterRowNeon<4>(axis, src, dst);
+}
+
+void filter_col_neon(const int16_t *const *rows, const int16_t *w, int32_t taps, uint8_t *dst, int32_t n) {
+    filterColNeon(rows, w, taps, dst, n);
+}
+
+NAMESPACE_END
+
+#endif
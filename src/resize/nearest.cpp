@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include "../cvt_color/band.hpp"
+#include "cpu_feature.hpp"
+#include "image.hpp"
+#include "nearest.hpp"
+#include "resize.hpp"
+
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+int32_t getNearestIndex(int32_t i, int32_t src, int32_t dst, const ResizeParam &param) {
+    int64_t idx = 0;
+    if (param.m_half_pixel) {
+        // Centre of dst pixel i, (i + 0.5) * src / dst, floored
+        idx = (2L * i + 1) * src / (2L * dst);
+    } else if (param.m_align_corner) {
+        // i * (src - 1) / (dst - 1) rounded, the corners map onto each other
+        idx = 1 == dst ? 0 : (2L * i * (src - 1) + (dst - 1)) / (2L * (dst - 1));
+    } else {
+        idx = 1L * i * src / dst;
+    }
+    return static_cast<int32_t>(std::min<int64_t>(idx, src - 1));
+}
+
+void nearest_row_c(const NearestRow &row, const uint8_t *src, uint8_t *dst) {
+    for (size_t k = 0; k < row.m_offset.size(); ++k) {
+        dst[k] = src[row.m_offset[k]];
+    }
+}
+
+// Source byte of every byte of a dst row of the plane
+static std::vector<int32_t> getNearestOffsets(ImageFormat fmt, size_t plane, int32_t src_w, int32_t dst_w,
+                                              const ResizeParam &param) {
+    std::vector<int32_t> offset;
+    if (ImageFormat::YUYV == fmt || ImageFormat::UYVY == fmt || ImageFormat::Y210 == fmt) {
+        // Luma per pixel, chroma per pair from the nearest source pair
+        int32_t s = ImageFormat::Y210 == fmt ? 2 : 1;
+        int32_t y = ImageFormat::UYVY == fmt ? s : 0;
+        int32_t c = ImageFormat::UYVY == fmt ? 0 : s;
+        offset.resize(2UL * s * dst_w);
+        for (int32_t j = 0; j < dst_w; j += 2) {
+            auto x0 = getNearestIndex(j, src_w, dst_w, param);
+            auto x1 = getNearestIndex(j + 1, src_w, dst_w, param);
+            auto q = getNearestIndex(j >> 1, src_w >> 1, dst_w >> 1, param);
+            auto *o = offset.data() + 2L * s * j;
+            for (int32_t b = 0; b < s; ++b) {
+                o[y + b] = 2 * s * x0 + y + b;
+                o[c + b] = 4 * s * q + c + b;
+                o[2 * s + y + b] = 2 * s * x1 + y + b;
+                o[2 * s + c + b] = 4 * s * q + 2 * s + c + b;
+            }
+        }
+        return offset;
+    }
+
+    // Chroma planes other than 4:4:4 hold one element per two pixels
+    auto sub = 0 != plane && ImageFormat::I444 != fmt && ImageFormat::NV24 != fmt;
+    auto src_n = sub ? (src_w + 1) >> 1 : src_w;
+    auto dst_n = sub ? (dst_w + 1) >> 1 : dst_w;
+    auto size = static_cast<int32_t>(getPlaneStride(src_w, fmt, plane) / src_n);
+    offset.resize(1UL * size * dst_n);
+    for (int32_t j = 0; j < dst_n; ++j) {
+        auto x = getNearestIndex(j, src_n, dst_n, param);
+        for (int32_t b = 0; b < size; ++b) {
+            offset[j * size + b] = x * size + b;
+        }
+    }
+    return offset;
+}
+
+static NearestRow getNearestRow(std::vector<int32_t> offset, int32_t src_bytes) {
+    NearestRow row;
+    auto blocks = offset.size() / k_nearest_block;
+    row.m_base.resize(blocks, -1);
+    row.m_lookup.resize(blocks * 2 * k_nearest_block);
+    for (size_t b = 0; b < blocks; ++b) {
+        auto first = offset.begin() + b * k_nearest_block;
+        auto [lo, hi] = std::minmax_element(first, first + k_nearest_block);
+        // Both loads stay inside the source row
+        auto base = std::min(*lo, src_bytes - 2 * k_nearest_block);
+        if (base < 0 || *hi - base >= 2 * k_nearest_block) {
+            continue;
+        }
+        row.m_base[b] = base;
+        auto *lookup = row.m_lookup.data() + b * 2 * k_nearest_block;
+        for (int32_t k = 0; k < k_nearest_block; ++k) {
+            auto d = first[k] - base;
+            lookup[k] = static_cast<uint8_t>(d < k_nearest_block ? d : 0x80);
+            lookup[k + k_nearest_block] = static_cast<uint8_t>(d >= k_nearest_block ? d - k_nearest_block : 0x80);
+        }
+    }
+    row.m_offset = std::move(offset);
+    return row;
+}
+
+#ifdef __aarch64__
+#define NEAREST_NEON(F) F
+#else
+#define NEAREST_NEON(F) nullptr
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define NEAREST_X86(F) F
+#else
+#define NEAREST_X86(F) nullptr
+#endif
+
+static NearestRowFunction getNearestRowFunc() {
+    // Indexed by CpuTier: scalar, neon, sse4.1, avx2, avx512bw
+    static constexpr std::array<NearestRowFunction, getValueOf(CpuTier::END)> impl{
+        nearest_row_c, NEAREST_NEON(nearest_row_neon), NEAREST_X86(nearest_row_sse41), nullptr, nullptr};
+    for (auto t = static_cast<int32_t>(getValueOf(getCpuTier())); t >= 0; --t) {
+        if (nullptr != impl[t] && isCpuTierSupported(static_cast<CpuTier>(t))) {
+            return impl[t];
+        }
+    }
+    return impl[0];
+}
+
+#undef NEAREST_X86
+#undef NEAREST_NEON
+
+void resizeNearest(const Image &src, const Image &dst, const ResizeParam &param) {
+    auto fmt = src.fmt();
+    auto planes = src.planes();
+    std::array<NearestRow, k_max_planes> cols;
+    std::array<std::vector<int32_t>, k_max_planes> rows;
+    for (size_t p = 0; p < planes; ++p) {
+        cols[p] = getNearestRow(getNearestOffsets(fmt, p, src.cols(), dst.cols(), param),
+                                static_cast<int32_t>(getPlaneStride(src.cols(), fmt, p)));
+        auto src_rows = getPlaneRows(src.rows(), fmt, p);
+        auto dst_rows = getPlaneRows(dst.rows(), fmt, p);
+        rows[p].resize(dst_rows);
+        for (int32_t i = 0; i < dst_rows; ++i) {
+            rows[p][i] = getNearestIndex(i, src_rows, dst_rows, param);
+        }
+    }
+
+    auto row_func = getNearestRowFunc();
+    forEachRowBand(dst, [&](int32_t row, int32_t n) {
+        for (size_t p = 0; p < planes; ++p) {
+            auto first = getPlaneRows(row, fmt, p);
+            for (auto i = first; i < getPlaneRows(row + n, fmt, p); ++i) {
+                // Upscaling repeats source rows, copy the row just made
+                if (i != first && rows[p][i] == rows[p][i - 1]) {
+                    std::memcpy(dst.ptr(i, p), dst.ptr(i - 1, p), cols[p].m_offset.size());
+                } else {
+                    row_func(cols[p], src.ptr(rows[p][i], p), dst.ptr(i, p));
+                }
+            }
+        }
+    });
+}
+
+NAMESPACE_END
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <vector>
+#include "image.hpp"
+#include "resize.hpp"
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+// Dst bytes are gathered in blocks of this many
+constexpr int32_t k_nearest_block = 16;
+
+// Where the bytes of a dst row of one plane come from, dst[k] =
+// src[m_offset[k]]. Blocks whose sources lie within 32 bytes of their
+// m_base are gathered with two 16 byte table lookups of m_lookup (32 per
+// block, 0x80 zeroes the byte), wider blocks have m_base -1 and are copied
+// through m_offset
+struct NearestRow {
+    std::vector<int32_t> m_offset;
+    std::vector<int32_t> m_base;
+    std::vector<uint8_t> m_lookup;
+};
+
+// Source index of dst index i, src and dst being the sample counts
+int32_t getNearestIndex(int32_t i, int32_t src, int32_t dst, const ResizeParam&);
+
+using NearestRowFunction = void(*)(const NearestRow&, const uint8_t*, uint8_t*);
+
+void nearest_row_c(const NearestRow&, const uint8_t*, uint8_t*);
+void nearest_row_neon(const NearestRow&, const uint8_t*, uint8_t*);
+void nearest_row_sse41(const NearestRow&, const uint8_t*, uint8_t*);
+
+// Nearest neighbour resize of any format, dst keeps its size
+void resizeNearest(const Image &src, const Image &dst, const ResizeParam&);
+
+NAMESPACE_END
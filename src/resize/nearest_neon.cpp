@@ -0,0 +1,36 @@
+#include "nearest.hpp"
+#include "types.hpp"
+
+#ifdef __aarch64__
+
+#include <arm_neon.h>
+
+NAMESPACE_BEGIN
+
+void nearest_row_neon(const NearestRow &row, const uint8_t *src, uint8_t *dst) {
+    auto blocks = row.m_base.size();
+    for (size_t b = 0; b < blocks; ++b) {
+        auto base = row.m_base[b];
+        auto k = b * k_nearest_block;
+        if (base < 0) {
+            for (auto end = k + k_nearest_block; k < end; ++k) {
+                dst[k] = src[row.m_offset[k]];
+            }
+            continue;
+        }
+        // 0x80 is out of range for both lookups, tbl zeroes those bytes and
+        // tbx keeps what tbl gathered from lo
+        const auto *lookup = row.m_lookup.data() + 2 * k;
+        auto lo = vld1q_u8(src + base);
+        auto hi = vld1q_u8(src + base + k_nearest_block);
+        auto v = vqtbx1q_u8(vqtbl1q_u8(lo, vld1q_u8(lookup)), hi, vld1q_u8(lookup + k_nearest_block));
+        vst1q_u8(dst + k, v);
+    }
+    for (auto k = blocks * k_nearest_block; k < row.m_offset.size(); ++k) {
+        dst[k] = src[row.m_offset[k]];
+    }
+}
+
+NAMESPACE_END
+
+#endif
@@ -0,0 +1,40 @@
+#include "../cvt_color/x86.hpp"
+#include "nearest.hpp"
+#include "types.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+NAMESPACE_BEGIN
+
+SSE41_FUNC static void nearestRowSse41(const NearestRow &row, const uint8_t *src, uint8_t *dst) {
+    auto blocks = row.m_base.size();
+    for (size_t b = 0; b < blocks; ++b) {
+        auto base = row.m_base[b];
+        auto k = b * k_nearest_block;
+        if (base < 0) {
+            for (auto end = k + k_nearest_block; k < end; ++k) {
+                dst[k] = src[row.m_offset[k]];
+            }
+            continue;
+        }
+        const auto *lookup = reinterpret_cast<const __m128i*>(row.m_lookup.data() + 2 * k);
+        auto lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + base));
+        auto hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + base + k_nearest_block));
+        auto v = _mm_or_si128(_mm_shuffle_epi8(lo, _mm_loadu_si128(lookup)),
+                              _mm_shuffle_epi8(hi, _mm_loadu_si128(lookup + 1)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + k), v);
+    }
+    for (auto k = blocks * k_nearest_block; k < row.m_offset.size(); ++k) {
+        dst[k] = src[row.m_offset[k]];
+    }
+}
+
+void nearest_row_sse41(const NearestRow &row, const uint8_t *src, uint8_t *dst) {
+    nearestRowSse41(row, src, dst);
+}
+
+NAMESPACE_END
+
+#endif
@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include "thread_pool.hpp"
+
+#include "types.hpp"
+
+NAMESPACE_BEGIN
+
+static size_t getThreadNum(size_t threads) {
+    if (0 == threads) {
+        threads = std::thread::hardware_concurrency();
+    }
+    return std::max<size_t>(threads, 1);
+}
+
+ThreadPool::ThreadPool(size_t threads) {
+    // The caller of run() is the last thread
+    threads = getThreadNum(threads);
+    workers_.reserve(threads - 1);
+    for (size_t i = 1; i < threads; ++i) {
+        workers_.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    cond_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::work() {
+    for (;;) {
+        std::function<void()> func;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cond_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            func = std::move(queue_.front());
+            queue_.pop_front();
+        }
+        func();
+    }
+}
+
+void ThreadPool::run(size_t n, const std::function<void(size_t)> &task) {
+    if (n <= 1 || workers_.empty()) {
+        for (size_t i = 0; i < n; ++i) {
+            task(i);
+        }
+        return;
+    }
+
+    // Tasks are claimed through `next`, so a helper that is dequeued late
+    // finds nothing left and returns; the job outlives run() for it
+    struct Job {
+        std::function<void(size_t)> task;
+        size_t n;
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> done{0};
+        std::mutex mutex;
+        std::condition_variable cond;
+    };
+    auto job = std::make_shared<Job>();
+    job->task = task;
+    job->n = n;
+
+    auto helper = [job] {
+        for (auto i = job->next.fetch_add(1); i < job->n; i = job->next.fetch_add(1)) {
+            job->task(i);
+            if (job->n == job->done.fetch_add(1) + 1) {
+                std::lock_guard<std::mutex> lock(job->mutex);
+                job->cond.notify_all();
+            }
+        }
+    };
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (size_t i = 0; i < std::min(n - 1, workers_.size()); ++i) {
+            queue_.emplace_back(helper);
+        }
+    }
+    cond_.notify_all();
+
+    helper();
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->cond.wait(lock, [&job] { return job->n == job->done.load(); });
+}
+
+size_t ThreadPool::concurrency() const {
+    return workers_.size() + 1;
+}
+
+static std::atomic<Executor*> g_executor{nullptr};
+static std::atomic<size_t> g_threads{0};
+// Pools are never destroyed, a conversion may still run on one replaced
+// after setNumThreads. One per thread count, so switching back and forth
+// reuses them
+static std::mutex g_pool_mutex;
+static std::vector<std::unique_ptr<ThreadPool>> g_pools;
+static std::atomic<ThreadPool*> g_pool{nullptr};
+
+Executor *getDefaultExecutor() {
+    auto *executor = g_executor.load(std::memory_order_acquire);
+    if (nullptr != executor) {
+        return executor;
+    }
+
+    auto threads = getThreadNum(g_threads.load(std::memory_order_relaxed));
+    auto *pool = g_pool.load(std::memory_order_acquire);
+    if (nullptr != pool && threads == pool->concurrency()) {
+        return pool;
+    }
+    // Only the first call and those after setNumThreads get here
+    std::lock_guard<std::mutex> lock(g_pool_mutex);
+    auto it = std::find_if(g_pools.begin(), g_pools.end(), [threads](const auto &p) { return threads == p->concurrency(); });
+    if (g_pools.end() == it) {
+        g_pools.push_back(std::make_unique<ThreadPool>(threads));
+        it = g_pools.end() - 1;
+    }
+    g_pool.store(it->get(), std::memory_order_release);
+    return it->get();
+}
+
+void setDefaultExecutor(Executor *executor) {
+    g_executor.store(executor, std::memory_order_release);
+}
+
+void setNumThreads(size_t threads) {
+    g_threads.store(threads, std::memory_order_relaxed);
+}
+
+size_t getNumThreads() {
+    return getThreadNum(g_threads.load(std::memory_order_relaxed));
+}
+
+NAMESPACE_END
@@ -1,5 +1,6 @@
 #include "cvt_test.hpp"
 #include <array>
+#include <vector>
 #include "logger.hpp"
 
 #include "types.hpp"
@@ -11,395 +12,159 @@
 NAMESPACE_BEGIN
 
 constexpr char k_cvt_name_fmt[] = "{}_{}_{}_{}";
-constexpr char k_asm_name_fmt[] = "{}_asm";
-constexpr char k_yuv_name_fmt[] = "{}_yuv";
-using CvtFunction = void(*)(const Image&, const Image&);
-struct CvtFuncStruct {
-    CvtFunction m_func_c{nullptr};
-    CvtFunction m_func{nullptr};
-};
+constexpr char k_simd_name_fmt[] = "{}_{}";
+constexpr char k_high_name_fmt[] = "{}_high";
+constexpr char k_bilinear_name_fmt[] = "{}_bilinear";
+constexpr char k_tile_name_fmt[] = "{}_tiles";
+constexpr char k_batch_name_fmt[] = "{}_batch";
 
-static const std::array<std::array<CvtFuncStruct, getValueOf(ImageFormat::END)>, getValueOf(ImageFormat::END)> g_cvt_func = {
-    CvtFuncStruct{.m_func_c = gray_to_gray_c,    .m_func = gray_to_gray},
-    CvtFuncStruct{.m_func_c = gray_to_rgba_c,    .m_func = gray_to_rgba},
-    CvtFuncStruct{.m_func_c = gray_to_rgb_c,     .m_func = gray_to_rgb},
-    CvtFuncStruct{.m_func_c = gray_to_bgra_c,    .m_func = gray_to_bgra},
-    CvtFuncStruct{.m_func_c = gray_to_bgr_c,     .m_func = gray_to_bgr},
-    CvtFuncStruct{.m_func_c = gray_to_yuyv_c,    .m_func = gray_to_yuyv},
-    CvtFuncStruct{.m_func_c = gray_to_uyvy_c,    .m_func = gray_to_uyvy},
-    CvtFuncStruct{.m_func_c = gray_to_i420_c,    .m_func = gray_to_i420},
-    CvtFuncStruct{.m_func_c = gray_to_nv12_c,    .m_func = gray_to_nv12},
-    CvtFuncStruct{.m_func_c = gray_to_nv21_c,    .m_func = gray_to_nv21},
-
-    CvtFuncStruct{.m_func_c = rgba_to_gray_c,    .m_func = rgba_to_gray},
-    CvtFuncStruct{.m_func_c = rgba_to_rgba_c,    .m_func = rgba_to_rgba},
-    CvtFuncStruct{.m_func_c = rgba_to_rgb_c,     .m_func = rgba_to_rgb},
-    CvtFuncStruct{.m_func_c = rgba_to_bgra_c,    .m_func = rgba_to_bgra},
-    CvtFuncStruct{.m_func_c = rgba_to_bgr_c,     .m_func = rgba_to_bgr},
-    CvtFuncStruct{.m_func_c = rgba_to_yuyv_c,    .m_func = rgba_to_yuyv},
-    CvtFuncStruct{.m_func_c = rgba_to_uyvy_c,    .m_func = rgba_to_uyvy},
-    CvtFuncStruct{.m_func_c = rgba_to_i420_c,    .m_func = rgba_to_i420},
-    CvtFuncStruct{.m_func_c = rgba_to_nv12_c,    .m_func = rgba_to_nv12},
-    CvtFuncStruct{.m_func_c = rgba_to_nv21_c,    .m_func = rgba_to_nv21},
-
-    CvtFuncStruct{.m_func_c = rgb_to_gray_c,    .m_func = rgb_to_gray},
-    CvtFuncStruct{.m_func_c = rgb_to_rgba_c,    .m_func = rgb_to_rgba},
-    CvtFuncStruct{.m_func_c = rgb_to_rgb_c,     .m_func = rgb_to_rgb},
-    CvtFuncStruct{.m_func_c = rgb_to_bgra_c,    .m_func = rgb_to_bgra},
-    CvtFuncStruct{.m_func_c = rgb_to_bgr_c,     .m_func = rgb_to_bgr},
-    CvtFuncStruct{.m_func_c = rgb_to_yuyv_c,    .m_func = rgb_to_yuyv},
-    CvtFuncStruct{.m_func_c = rgb_to_uyvy_c,    .m_func = rgb_to_uyvy},
-    CvtFuncStruct{.m_func_c = rgb_to_i420_c,    .m_func = rgb_to_i420},
-    CvtFuncStruct{.m_func_c = rgb_to_nv12_c,    .m_func = rgb_to_nv12},
-    CvtFuncStruct{.m_func_c = rgb_to_nv21_c,    .m_func = rgb_to_nv21},
-
-    CvtFuncStruct{.m_func_c = bgra_to_gray_c,    .m_func = bgra_to_gray},
-    CvtFuncStruct{.m_func_c = bgra_to_rgba_c,    .m_func = bgra_to_rgba},
-    CvtFuncStruct{.m_func_c = bgra_to_rgb_c,     .m_func = bgra_to_rgb},
-    CvtFuncStruct{.m_func_c = bgra_to_bgra_c,    .m_func = bgra_to_bgra},
-    CvtFuncStruct{.m_func_c = bgra_to_bgr_c,     .m_func = bgra_to_bgr},
-    CvtFuncStruct{.m_func_c = bgra_to_yuyv_c,    .m_func = bgra_to_yuyv},
-    CvtFuncStruct{.m_func_c = bgra_to_uyvy_c,    .m_func = bgra_to_uyvy},
-    CvtFuncStruct{.m_func_c = bgra_to_i420_c,    .m_func = bgra_to_i420},
-    CvtFuncStruct{.m_func_c = bgra_to_nv12_c,    .m_func = bgra_to_nv12},
-    CvtFuncStruct{.m_func_c = bgra_to_nv21_c,    .m_func = bgra_to_nv21},
-
-    CvtFuncStruct{.m_func_c = bgr_to_gray_c,    .m_func = bgr_to_gray},
-    CvtFuncStruct{.m_func_c = bgr_to_rgba_c,    .m_func = bgr_to_rgba},
-    CvtFuncStruct{.m_func_c = bgr_to_rgb_c,     .m_func = bgr_to_rgb},
-    CvtFuncStruct{.m_func_c = bgr_to_bgra_c,    .m_func = bgr_to_bgra},
-    CvtFuncStruct{.m_func_c = bgr_to_bgr_c,     .m_func = bgr_to_bgr},
-    CvtFuncStruct{.m_func_c = bgr_to_yuyv_c,    .m_func = bgr_to_yuyv},
-    CvtFuncStruct{.m_func_c = bgr_to_uyvy_c,    .m_func = bgr_to_uyvy},
-    CvtFuncStruct{.m_func_c = bgr_to_i420_c,    .m_func = bgr_to_i420},
-    CvtFuncStruct{.m_func_c = bgr_to_nv12_c,    .m_func = bgr_to_nv12},
-    CvtFuncStruct{.m_func_c = bgr_to_nv21_c,    .m_func = bgr_to_nv21},
-
-    CvtFuncStruct{.m_func_c = yuyv_to_gray_c,    .m_func = yuyv_to_gray},
-    CvtFuncStruct{.m_func_c = yuyv_to_rgba_c,    .m_func = yuyv_to_rgba},
-    CvtFuncStruct{.m_func_c = yuyv_to_rgb_c,     .m_func = yuyv_to_rgb},
-    CvtFuncStruct{.m_func_c = yuyv_to_bgra_c,    .m_func = yuyv_to_bgra},
-    CvtFuncStruct{.m_func_c = yuyv_to_bgr_c,     .m_func = yuyv_to_bgr},
-    CvtFuncStruct{.m_func_c = yuyv_to_yuyv_c,    .m_func = yuyv_to_yuyv},
-    CvtFuncStruct{.m_func_c = yuyv_to_uyvy_c,    .m_func = yuyv_to_uyvy},
-    CvtFuncStruct{.m_func_c = yuyv_to_i420_c,    .m_func = yuyv_to_i420},
-    CvtFuncStruct{.m_func_c = yuyv_to_nv12_c,    .m_func = yuyv_to_nv12},
-    CvtFuncStruct{.m_func_c = yuyv_to_nv21_c,    .m_func = yuyv_to_nv21},
-
-    CvtFuncStruct{.m_func_c = uyvy_to_gray_c,    .m_func = uyvy_to_gray},
-    CvtFuncStruct{.m_func_c = uyvy_to_rgba_c,    .m_func = uyvy_to_rgba},
-    CvtFuncStruct{.m_func_c = uyvy_to_rgb_c,     .m_func = uyvy_to_rgb},
-    CvtFuncStruct{.m_func_c = uyvy_to_bgra_c,    .m_func = uyvy_to_bgra},
-    CvtFuncStruct{.m_func_c = uyvy_to_bgr_c,     .m_func = uyvy_to_bgr},
-    CvtFuncStruct{.m_func_c = uyvy_to_yuyv_c,    .m_func = uyvy_to_yuyv},
-    CvtFuncStruct{.m_func_c = uyvy_to_uyvy_c,    .m_func = uyvy_to_uyvy},
-    CvtFuncStruct{.m_func_c = uyvy_to_i420_c,    .m_func = uyvy_to_i420},
-    CvtFuncStruct{.m_func_c = uyvy_to_nv12_c,    .m_func = uyvy_to_nv12},
-    CvtFuncStruct{.m_func_c = uyvy_to_nv21_c,    .m_func = uyvy_to_nv21},
-
-    CvtFuncStruct{.m_func_c = i420_to_gray_c,    .m_func = i420_to_gray},
-    CvtFuncStruct{.m_func_c = i420_to_rgba_c,    .m_func = i420_to_rgba},
-    CvtFuncStruct{.m_func_c = i420_to_rgb_c,     .m_func = i420_to_rgb},
-    CvtFuncStruct{.m_func_c = i420_to_bgra_c,    .m_func = i420_to_bgra},
-    CvtFuncStruct{.m_func_c = i420_to_bgr_c,     .m_func = i420_to_bgr},
-    CvtFuncStruct{.m_func_c = i420_to_yuyv_c,    .m_func = i420_to_yuyv},
-    CvtFuncStruct{.m_func_c = i420_to_uyvy_c,    .m_func = i420_to_uyvy},
-    CvtFuncStruct{.m_func_c = i420_to_i420_c,    .m_func = i420_to_i420},
-    CvtFuncStruct{.m_func_c = i420_to_nv12_c,    .m_func = i420_to_nv12},
-    CvtFuncStruct{.m_func_c = i420_to_nv21_c,    .m_func = i420_to_nv21},
-
-    CvtFuncStruct{.m_func_c = nv12_to_gray_c,    .m_func = nv12_to_gray},
-    CvtFuncStruct{.m_func_c = nv12_to_rgba_c,    .m_func = nv12_to_rgba},
-    CvtFuncStruct{.m_func_c = nv12_to_rgb_c,     .m_func = nv12_to_rgb},
-    CvtFuncStruct{.m_func_c = nv12_to_bgra_c,    .m_func = nv12_to_bgra},
-    CvtFuncStruct{.m_func_c = nv12_to_bgr_c,     .m_func = nv12_to_bgr},
-    CvtFuncStruct{.m_func_c = nv12_to_yuyv_c,    .m_func = nv12_to_yuyv},
-    CvtFuncStruct{.m_func_c = nv12_to_uyvy_c,    .m_func = nv12_to_uyvy},
-    CvtFuncStruct{.m_func_c = nv12_to_i420_c,    .m_func = nv12_to_i420},
-    CvtFuncStruct{.m_func_c = nv12_to_nv12_c,    .m_func = nv12_to_nv12},
-    CvtFuncStruct{.m_func_c = nv12_to_nv21_c,    .m_func = nv12_to_nv21},
-
-    CvtFuncStruct{.m_func_c = nv21_to_gray_c,    .m_func = nv21_to_gray},
-    CvtFuncStruct{.m_func_c = nv21_to_rgba_c,    .m_func = nv21_to_rgba},
-    CvtFuncStruct{.m_func_c = nv21_to_rgb_c,     .m_func = nv21_to_rgb},
-    CvtFuncStruct{.m_func_c = nv21_to_bgra_c,    .m_func = nv21_to_bgra},
-    CvtFuncStruct{.m_func_c = nv21_to_bgr_c,     .m_func = nv21_to_bgr},
-    CvtFuncStruct{.m_func_c = nv21_to_yuyv_c,    .m_func = nv21_to_yuyv},
-    CvtFuncStruct{.m_func_c = nv21_to_uyvy_c,    .m_func = nv21_to_uyvy},
-    CvtFuncStruct{.m_func_c = nv21_to_i420_c,    .m_func = nv21_to_i420},
-    CvtFuncStruct{.m_func_c = nv21_to_nv12_c,    .m_func = nv21_to_nv12},
-    CvtFuncStruct{.m_func_c = nv21_to_nv21_c,    .m_func = nv21_to_nv21},
-};
-
-void fromGray(const Image& src, uint32_t dst_type, uint32_t loop) {
-    LOGD("From Gray");
-    const auto src_fmt = ImageFormat::GRAY;
-    auto src_idx       = static_cast<uint32_t>(src_fmt);
+static void fromFormat(ImageFormat src_fmt, const Image& src, uint32_t dst_type, uint32_t loop) {
+    LOGD("From {}", getImgFmtName(src_fmt));
     const auto& src_type_name = getImgFmtName(src_fmt);
     for (auto i = 0U; i < getValueOf(ImageFormat::END); ++i) {
         if (0 != (dst_type & (1 << i))) {
             auto img_fmt = static_cast<ImageFormat>(i);
+            // Kernels are resolved once, the timed loops call them directly
+            auto ref_func = getCvtFunc(src_fmt, img_fmt, CpuTier::SCALAR);
+            auto cvt_func = getCvtFunc(src_fmt, img_fmt);
+            if (nullptr == ref_func) {
+                continue;
+            }
             Image dst;
             dst.create(src.rows(), src.cols(), img_fmt);
+            checkCvtColor(src, dst);
             auto name  = format2str(k_cvt_name_fmt, src_type_name, getImgFmtName(img_fmt), src.cols(), src.rows());
-            auto cost0 = doTest({name, [&src, &dst, src_idx, i]() {
-                                     g_cvt_func[src_idx][i].m_func_c(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            name       = format2str(k_asm_name_fmt, name);
-            auto cost1 = doTest({name, [&src, &dst, src_idx, i]() {
-                                    g_cvt_func[src_idx][i].m_func(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
+            auto cost0 = doTest({name, [&src, &dst, ref_func]() { ref_func(src, dst); }, dst.data(), dst.size()}, loop);
+            name       = format2str(k_simd_name_fmt, name, getCpuTierName(getCpuTier()));
+            const auto simd_name = name;
+            auto cost1 = doTest({name, [&src, &dst, cvt_func]() { cvt_func(src, dst); }, dst.data(), dst.size()}, loop);
             LOGD("{} speed up {} times\n", name, cost0 / cost1);
+
+            // Only yuv <-> rgb has a HIGH precision kernel of its own
+            constexpr CvtOption high{CvtPrecision::HIGH};
+            auto high_func = getCvtFunc(src_fmt, img_fmt, high);
+            if (high_func != cvt_func) {
+                auto fast_err = measureCvtError(src, dst);
+                name       = format2str(k_high_name_fmt, name);
+                auto cost2 = doTest({name, [&src, &dst, high_func]() { high_func(src, dst); }, dst.data(), dst.size()}, loop);
+                auto high_err = measureCvtError(src, dst);
+                LOGD("{} costs {} times fast, max/mean error {}/{} -> {}/{}\n", name, cost2 / cost1,
+                     fast_err.m_max, fast_err.m_mean, high_err.m_max, high_err.m_mean);
+            }
+
+            // Bilinear chroma only differs for yuv -> rgb, high bit depth
+            // sources have none
+            constexpr CvtOption bilinear{CvtPrecision::HIGH, ChromaFilter::BILINEAR};
+            auto bilinear_func = getCvtFunc(src_fmt, img_fmt, bilinear);
+            if (nullptr != bilinear_func && bilinear_func != high_func) {
+                name       = format2str(k_bilinear_name_fmt, name);
+                auto cost3 = doTest({name, [&src, &dst, bilinear_func]() { bilinear_func(src, dst); }, dst.data(), dst.size()}, loop);
+                auto err   = measureCvtError(src, dst, bilinear);
+                LOGD("{} costs {} times fast, max/mean error {}/{}\n", name, cost3 / cost1, err.m_max, err.m_mean);
+            }
+
+            // The frame cut into 4x4 tiles, converted one call per tile
+            // and in one batch
+            auto tile_h = (src.rows() / 4) & ~1;
+            auto tile_w = (src.cols() / 4) & ~1;
+            if (0 != tile_h && 0 != tile_w) {
+                std::vector<Image> src_tiles, dst_tiles;
+                for (int32_t y = 0; y < 4; ++y) {
+                    for (int32_t x = 0; x < 4; ++x) {
+                        src_tiles.push_back(src.roi(x * tile_w, y * tile_h, tile_w, tile_h));
+                        dst_tiles.push_back(dst.roi(x * tile_w, y * tile_h, tile_w, tile_h));
+                    }
+                }
+                name       = format2str(k_tile_name_fmt, simd_name);
+                auto cost4 = doTest({name, [&src_tiles, &dst_tiles, img_fmt]() {
+                    for (size_t k = 0; k < src_tiles.size(); ++k) {
+                        cvtColor(src_tiles[k], dst_tiles[k], img_fmt);
+                    }
+                }, dst.data(), dst.size()}, loop);
+                name       = format2str(k_batch_name_fmt, simd_name);
+                auto cost5 = doTest({name, [&src_tiles, &dst_tiles, img_fmt]() {
+                    cvtColorBatch(src_tiles.data(), dst_tiles.data(), src_tiles.size(), img_fmt);
+                }, dst.data(), dst.size()}, loop);
+                LOGD("{} speed up {} times over one call per tile\n", name, cost4 / cost5);
+            }
         }
     }
 }
 
-void fromBgra(const Image& src, uint32_t dst_type, uint32_t loop) {
-    LOGD("From Bgra");
-    const auto src_fmt = ImageFormat::BGRA;
-    auto src_idx       = static_cast<uint32_t>(src_fmt);
-    const auto& src_type_name = getImgFmtName(src_fmt);
-    for (auto i = 0U; i < getValueOf(ImageFormat::END); ++i) {
-        if (0 != (dst_type & (1 << i))) {
-            auto img_fmt = static_cast<ImageFormat>(i);
-            Image dst;
-            dst.create(src.rows(), src.cols(), img_fmt);
-            auto name  = format2str(k_cvt_name_fmt, src_type_name, getImgFmtName(img_fmt), src.cols(), src.rows());
-            auto cost0 = doTest({name, [&src, &dst, src_idx, i]() {
-                                     g_cvt_func[src_idx][i].m_func_c(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            name       = format2str(k_asm_name_fmt, name);
-            auto cost1 = doTest({name, [&src, &dst, src_idx, i]() {
-                                    g_cvt_func[src_idx][i].m_func(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            LOGD("{} speed up {} times\n", name, cost0 / cost1);
-        }
-    }
+void fromGray(const Image& src, uint32_t dst_type, uint32_t loop) {
+    fromFormat(ImageFormat::GRAY, src, dst_type, loop);
 }
 
-void fromBgr(const Image& src, uint32_t dst_type, uint32_t loop) {
-    LOGD("From Bgr");
-    const auto src_fmt        = ImageFormat::BGR;
-    auto src_idx              = static_cast<uint32_t>(src_fmt);
-    const auto& src_type_name = getImgFmtName(src_fmt);
-    for (auto i = 0U; i < getValueOf(ImageFormat::END); ++i) {
-        if (0 != (dst_type & (1 << i))) {
-            auto img_fmt = static_cast<ImageFormat>(i);
-            Image dst;
-            dst.create(src.rows(), src.cols(), img_fmt);
-            auto name  = format2str(k_cvt_name_fmt, src_type_name, getImgFmtName(img_fmt), src.cols(), src.rows());
-            auto cost0 = doTest({name, [&src, &dst, src_idx, i]() {
-                                     g_cvt_func[src_idx][i].m_func_c(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            name       = format2str(k_asm_name_fmt, name);
-            auto cost1 = doTest({name, [&src, &dst, src_idx, i]() {
-                                    g_cvt_func[src_idx][i].m_func(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            LOGD("{} speed up {} times\n", name, cost0 / cost1);
-        }
-    }
+void fromRgba(const Image& src, uint32_t dst_type, uint32_t loop) {
+    fromFormat(ImageFormat::RGBA, src, dst_type, loop);
 }
 
-void fromRgba(const Image& src, uint32_t dst_type, uint32_t loop)
-{
-    LOGD("From Rgba");
-    const auto src_fmt        = ImageFormat::RGBA;
-    auto src_idx       = static_cast<uint32_t>(src_fmt);
-    const auto& src_type_name = getImgFmtName(src_fmt);
-    for (auto i = 0U; i < getValueOf(ImageFormat::END); ++i) {
-        if (0 != (dst_type & (1 << i))) {
-            auto img_fmt = static_cast<ImageFormat>(i);
-            Image dst;
-            dst.create(src.rows(), src.cols(), img_fmt);
-            auto name  = format2str(k_cvt_name_fmt, src_type_name, getImgFmtName(img_fmt), src.cols(), src.rows());
-            auto cost0 = doTest({name, [&src, &dst, src_idx, i]() {
-                                     g_cvt_func[src_idx][i].m_func_c(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            name       = format2str(k_asm_name_fmt, name);
-            auto cost1 = doTest({name, [&src, &dst, src_idx, i]() {
-                                    g_cvt_func[src_idx][i].m_func(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            LOGD("{} speed up {} times\n", name, cost0 / cost1);
-        }
-    }
+void fromRgb(const Image& src, uint32_t dst_type, uint32_t loop) {
+    fromFormat(ImageFormat::RGB, src, dst_type, loop);
 }
 
-void fromRgb(const Image& src, uint32_t dst_type, uint32_t loop)
-{
-    LOGD("From Rgb");
-    const auto src_fmt        = ImageFormat::RGB;
-    auto src_idx       = static_cast<uint32_t>(src_fmt);
-    const auto& src_type_name = getImgFmtName(src_fmt);
-    for (auto i = 0U; i < getValueOf(ImageFormat::END); ++i) {
-        if (0 != (dst_type & (1 << i))) {
-            auto img_fmt = static_cast<ImageFormat>(i);
-            Image dst;
-            dst.create(src.rows(), src.cols(), img_fmt);
-            auto name  = format2str(k_cvt_name_fmt, src_type_name, getImgFmtName(img_fmt), src.cols(), src.rows());
-            auto cost0 = doTest({name, [&src, &dst, src_idx, i]() {
-                                     g_cvt_func[src_idx][i].m_func_c(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            name       = format2str(k_asm_name_fmt, name);
-            auto cost1 = doTest({name, [&src, &dst, src_idx, i]() {
-                                    g_cvt_func[src_idx][i].m_func(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            LOGD("{} speed up {} times\n", name, cost0 / cost1);
-        }
-    }
+void fromBgra(const Image& src, uint32_t dst_type, uint32_t loop) {
+    fromFormat(ImageFormat::BGRA, src, dst_type, loop);
 }
 
-void fromYuyv(const Image& src, uint32_t dst_type, uint32_t loop)
-{
-    LOGD("From Yuyv");
-    const auto src_fmt        = ImageFormat::YUYV;
-    auto src_idx       = static_cast<uint32_t>(src_fmt);
-    const auto& src_type_name = getImgFmtName(src_fmt);
-    for (auto i = 0U; i < getValueOf(ImageFormat::END); ++i) {
-        if (0 != (dst_type & (1 << i))) {
-            auto img_fmt = static_cast<ImageFormat>(i);
-            Image dst;
-            dst.create(src.rows(), src.cols(), img_fmt);
-            auto name  = format2str(k_cvt_name_fmt, src_type_name, getImgFmtName(img_fmt), src.cols(), src.rows());
-            auto cost0 = doTest({name, [&src, &dst, src_idx, i]() {
-                                     g_cvt_func[src_idx][i].m_func_c(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            name       = format2str(k_asm_name_fmt, name);
-            auto cost1 = doTest({name, [&src, &dst, src_idx, i]() {
-                                    g_cvt_func[src_idx][i].m_func(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            LOGD("{} speed up {} times\n", name, cost0 / cost1);
-        }
-    }
+void fromBgr(const Image& src, uint32_t dst_type, uint32_t loop) {
+    fromFormat(ImageFormat::BGR, src, dst_type, loop);
 }
 
-void fromUyvy(const Image& src, uint32_t dst_type, uint32_t loop)
-{
-    LOGD("From Uyyv");
-    const auto src_fmt        = ImageFormat::UYVY;
-    auto src_idx       = static_cast<uint32_t>(src_fmt);
-    const auto& src_type_name = getImgFmtName(src_fmt);
-    for (auto i = 0U; i < getValueOf(ImageFormat::END); ++i) {
-        if (0 != (dst_type & (1 << i))) {
-            auto img_fmt = static_cast<ImageFormat>(i);
-            Image dst;
-            dst.create(src.rows(), src.cols(), img_fmt);
-            auto name  = format2str(k_cvt_name_fmt, src_type_name, getImgFmtName(img_fmt), src.cols(), src.rows());
-            auto cost0 = doTest({name, [&src, &dst, src_idx, i]() {
-                                     g_cvt_func[src_idx][i].m_func_c(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            name       = format2str(k_asm_name_fmt, name);
-            auto cost1 = doTest({name, [&src, &dst, src_idx, i]() {
-                                    g_cvt_func[src_idx][i].m_func(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            LOGD("{} speed up {} times\n", name, cost0 / cost1);
-        }
-    }
+void fromYuyv(const Image& src, uint32_t dst_type, uint32_t loop) {
+    fromFormat(ImageFormat::YUYV, src, dst_type, loop);
+}
+
+void fromUyvy(const Image& src, uint32_t dst_type, uint32_t loop) {
+    fromFormat(ImageFormat::UYVY, src, dst_type, loop);
 }
+
 void fromI420(const Image& src, uint32_t dst_type, uint32_t loop) {
-    const auto src_fmt        = ImageFormat::I420;
-    LOGD("From {}", getImgFmtName(src_fmt));
-    auto src_idx       = static_cast<uint32_t>(src_fmt);
-    const auto& src_type_name = getImgFmtName(src_fmt);
-    for (auto i = 0U; i < getValueOf(ImageFormat::END); ++i) {
-        if (0 != (dst_type & (1 << i))) {
-            auto img_fmt = static_cast<ImageFormat>(i);
-            Image dst;
-            dst.create(src.rows(), src.cols(), img_fmt);
-            auto name  = format2str(k_cvt_name_fmt, src_type_name, getImgFmtName(img_fmt), src.cols(), src.rows());
-            auto cost0 = doTest({name, [&src, &dst, src_idx, i]() {
-                                     g_cvt_func[src_idx][i].m_func_c(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            name       = format2str(k_asm_name_fmt, name);
-            auto cost1 = doTest({name, [&src, &dst, src_idx, i]() {
-                                    g_cvt_func[src_idx][i].m_func(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            LOGD("{} speed up {} times\n", name, cost0 / cost1);
-        }
-    }
+    fromFormat(ImageFormat::I420, src, dst_type, loop);
 }
+
 void fromNv12(const Image& src, uint32_t dst_type, uint32_t loop) {
-    const auto src_fmt        = ImageFormat::NV12;
-    LOGD("From {}", getImgFmtName(src_fmt));
-    auto src_idx       = static_cast<uint32_t>(src_fmt);
-    const auto& src_type_name = getImgFmtName(src_fmt);
-    for (auto i = 0U; i < getValueOf(ImageFormat::END); ++i) {
-        if (0 != (dst_type & (1 << i))) {
-            auto img_fmt = static_cast<ImageFormat>(i);
-            Image dst;
-            dst.create(src.rows(), src.cols(), img_fmt);
-            auto name  = format2str(k_cvt_name_fmt, src_type_name, getImgFmtName(img_fmt), src.cols(), src.rows());
-            auto cost0 = doTest({name, [&src, &dst, src_idx, i]() {
-                                     g_cvt_func[src_idx][i].m_func_c(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            name       = format2str(k_asm_name_fmt, name);
-            auto cost1 = doTest({name, [&src, &dst, src_idx, i]() {
-                                    g_cvt_func[src_idx][i].m_func(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            LOGD("{} speed up {} times\n", name, cost0 / cost1);
-        }
-    }
+    fromFormat(ImageFormat::NV12, src, dst_type, loop);
 }
+
 void fromNv21(const Image& src, uint32_t dst_type, uint32_t loop) {
-    const auto src_fmt        = ImageFormat::NV21;
-    LOGD("From {}", getImgFmtName(src_fmt));
-    auto src_idx       = static_cast<uint32_t>(src_fmt);
-    const auto& src_type_name = getImgFmtName(src_fmt);
-    for (auto i = 0U; i < getValueOf(ImageFormat::END); ++i) {
-        if (0 != (dst_type & (1 << i))) {
-            auto img_fmt = static_cast<ImageFormat>(i);
-            Image dst;
-            dst.create(src.rows(), src.cols(), img_fmt);
-            auto name  = format2str(k_cvt_name_fmt, src_type_name, getImgFmtName(img_fmt), src.cols(), src.rows());
-            auto cost0 = doTest({name, [&src, &dst, src_idx, i]() {
-                                     g_cvt_func[src_idx][i].m_func_c(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            name       = format2str(k_asm_name_fmt, name);
-            auto cost1 = doTest({name, [&src, &dst, src_idx, i]() {
-                                    g_cvt_func[src_idx][i].m_func(src, dst);  // NOLINT
-                                 },
-                                 dst.data(), dst.size()},
-                                loop);
-            LOGD("{} speed up {} times\n", name, cost0 / cost1);
-        }
-    }
+    fromFormat(ImageFormat::NV21, src, dst_type, loop);
+}
+
+void fromP010(const Image& src, uint32_t dst_type, uint32_t loop) {
+    fromFormat(ImageFormat::P010, src, dst_type, loop);
+}
+
+void fromP016(const Image& src, uint32_t dst_type, uint32_t loop) {
+    fromFormat(ImageFormat::P016, src, dst_type, loop);
+}
+
+void fromI010(const Image& src, uint32_t dst_type, uint32_t loop) {
+    fromFormat(ImageFormat::I010, src, dst_type, loop);
+}
+
+void fromY210(const Image& src, uint32_t dst_type, uint32_t loop) {
+    fromFormat(ImageFormat::Y210, src, dst_type, loop);
+}
+
+void fromNv16(const Image& src, uint32_t dst_type, uint32_t loop) {
+    fromFormat(ImageFormat::NV16, src, dst_type, loop);
+}
+
+void fromNv24(const Image& src, uint32_t dst_type, uint32_t loop) {
+    fromFormat(ImageFormat::NV24, src, dst_type, loop);
+}
+
+void fromI422(const Image& src, uint32_t dst_type, uint32_t loop) {
+    fromFormat(ImageFormat::I422, src, dst_type, loop);
+}
+
+void fromI444(const Image& src, uint32_t dst_type, uint32_t loop) {
+    fromFormat(ImageFormat::I444, src, dst_type, loop);
+}
+
+void fromYv12(const Image& src, uint32_t dst_type, uint32_t loop) {
+    fromFormat(ImageFormat::YV12, src, dst_type, loop);
 }
 
 NAMESPACE_END
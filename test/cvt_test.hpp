@@ -15,5 +15,14 @@ void fromUyvy(const Image&, uint32_t, uint32_t);
 void fromI420(const Image&, uint32_t, uint32_t);
 void fromNv12(const Image&, uint32_t, uint32_t);
 void fromNv21(const Image&, uint32_t, uint32_t);
+void fromP010(const Image&, uint32_t, uint32_t);
+void fromP016(const Image&, uint32_t, uint32_t);
+void fromI010(const Image&, uint32_t, uint32_t);
+void fromY210(const Image&, uint32_t, uint32_t);
+void fromNv16(const Image&, uint32_t, uint32_t);
+void fromNv24(const Image&, uint32_t, uint32_t);
+void fromI422(const Image&, uint32_t, uint32_t);
+void fromI444(const Image&, uint32_t, uint32_t);
+void fromYv12(const Image&, uint32_t, uint32_t);
 
 NAMESPACE_END
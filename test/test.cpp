@@ -1,6 +1,8 @@
 #include "types.hpp"
 #include <algorithm>
 #include <chrono>
+#include <utility>
+#include "cpu_feature.hpp"
 #include "image.hpp"
 #include "test.hpp"
 #include "cvt_test.hpp"
@@ -87,10 +89,26 @@ int resizeTest(int argc, char **argv) {
 
     LOGD("From {}x{} --> {}x{}", w, h, dst_w, dst_h);
 
-    int32_t loop = argc > 3 ? std::stoi(argv[2]) : 1;
+    int32_t loop = argc > 3 ? std::stoi(argv[3]) : 1;
 
-    // resize(src, dst);
-    writeDstFile(format2str("gray_rgb_{}_{}", dst_w, dst_h), dst.data(), dst.size());
+    // The scalar kernels first, then those of the active tier
+    auto tier = getCpuTier();
+    for (auto [type, type_name] : {std::pair{ResizeType::NEAREST, "nearest"}, std::pair{ResizeType::BILINEAR, "bilinear"},
+                                      std::pair{ResizeType::CUBIC, "cubic"}, std::pair{ResizeType::AREA, "area"},
+                                      std::pair{ResizeType::LANCZOS, "lanczos"}}) {
+        // Bilinear is GRAY only off aarch64
+        if (ResizeType::BILINEAR == type && ImageFormat::GRAY != src_type) {
+            continue;
+        }
+        ResizeParam param{true, false, type};
+        auto name  = format2str("{}_{}_{}_{}", color, dst_w, dst_h, type_name);
+        setCpuTier(CpuTier::SCALAR);
+        auto cost0 = doTest({name, [&src, &dst, param]() { resize(src, dst, param); }, dst.data(), dst.size()}, loop);
+        setCpuTier(tier);
+        name       = format2str("{}_{}", name, getCpuTierName(tier));
+        auto cost1 = doTest({name, [&src, &dst, param]() { resize(src, dst, param); }, dst.data(), dst.size()}, loop);
+        LOGD("{} speed up {} times\n", name, cost0 / cost1);
+    }
     return 0;
 }
 
@@ -165,6 +183,33 @@ int cvtTest(int argc, char **argv) {
     case ImageFormat::NV21:
         fromNv21(src, dst_type, loop);
         break;
+    case ImageFormat::P010:
+        fromP010(src, dst_type, loop);
+        break;
+    case ImageFormat::P016:
+        fromP016(src, dst_type, loop);
+        break;
+    case ImageFormat::I010:
+        fromI010(src, dst_type, loop);
+        break;
+    case ImageFormat::Y210:
+        fromY210(src, dst_type, loop);
+        break;
+    case ImageFormat::NV16:
+        fromNv16(src, dst_type, loop);
+        break;
+    case ImageFormat::NV24:
+        fromNv24(src, dst_type, loop);
+        break;
+    case ImageFormat::I422:
+        fromI422(src, dst_type, loop);
+        break;
+    case ImageFormat::I444:
+        fromI444(src, dst_type, loop);
+        break;
+    case ImageFormat::YV12:
+        fromYv12(src, dst_type, loop);
+        break;
     default:
         break;
     }